@@ -12,21 +12,35 @@
 #include <string>
 #include <string_view>
 
+namespace irods::s3
+{
+	struct chunk_signing_context;
+} // namespace irods::s3
+
 namespace irods::s3::authentication
 {
+	class signing_key_cache;
+
 	/// Resolves the hashed signature to an iRODS username.
 	///
 	/// \param conn The connection to the iRODS server.
 	/// \param request The request.
 	/// \param url The url
+	/// \param signing_context If not null and the signature is correct, receives the
+	///                        information needed to verify the chunk signatures of an
+	///                        aws-chunked body.
 	///
 	/// \returns An iRODS username if the signature is correct, else an empty std::optional.
 	std::optional<std::string> authenticates(
 		const boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		const boost::urls::url_view& url);
+		const boost::urls::url_view& url,
+		chunk_signing_context* signing_context = nullptr);
 
 	std::optional<std::string> get_iRODS_user(const std::string_view access_key);
 	std::optional<std::string> get_user_secret_key(const std::string_view access_key);
+
+	/// Returns the cache of signing keys used by authenticates().
+	auto get_signing_key_cache() -> signing_key_cache&;
 } // namespace irods::s3::authentication
 
 #endif // IRODS_S3_API_AUTHENTICATION_HPP
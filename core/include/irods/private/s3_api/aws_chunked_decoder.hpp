@@ -0,0 +1,194 @@
+#ifndef IRODS_S3_API_AWS_CHUNKED_DECODER_HPP
+#define IRODS_S3_API_AWS_CHUNKED_DECODER_HPP
+
+#include "irods/private/s3_api/hmac.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace irods::s3
+{
+	/// The information needed to verify the chunk signatures of an aws-chunked body.
+	struct chunk_signing_context
+	{
+		/// The SigV4 signing key of the user (i.e. the raw bytes, not hex encoded).
+		std::string signing_key;
+
+		/// The value of the X-Amz-Date header (e.g. 20130524T000000Z).
+		std::string timestamp;
+
+		/// The credential scope (e.g. 20130524/us-east-1/s3/aws4_request).
+		std::string scope;
+
+		/// The signature of the request header, which seeds the chain of chunk signatures.
+		std::string seed_signature;
+	}; // struct chunk_signing_context
+
+	/// An incremental decoder for bodies using the aws-chunked content encoding (i.e.
+	/// STREAMING-AWS4-HMAC-SHA256-PAYLOAD, STREAMING-AWS4-HMAC-SHA256-PAYLOAD-TRAILER, and
+	/// STREAMING-UNSIGNED-PAYLOAD-TRAILER).
+	///
+	/// The decoder is fed the body in arbitrary pieces. The payload is returned as views into the
+	/// input, so it is never copied. Only the text of a chunk header's extensions and the trailing
+	/// headers are buffered, since they may be split across pieces.
+	///
+	/// If a chunk_signing_context is provided, the signature of every chunk is verified against
+	/// the chain of signatures started by the seed signature, as is the signature of the trailing
+	/// headers. A chunk's signature can only be verified once all of its payload has been seen, so
+	/// the payload of a chunk is handed out before its signature is known to be correct.
+	class aws_chunked_decoder
+	{
+	  public:
+		enum class error_code
+		{
+			none,
+			malformed_chunk_header,
+			chunk_header_too_long,
+			chunk_size_too_large,
+			missing_chunk_signature,
+			malformed_chunk_terminator,
+			malformed_trailer,
+			trailer_too_long,
+			missing_trailer_signature,
+			signature_mismatch
+		}; // enum class error_code
+
+		/// The longest chunk header that is accepted, including the terminating CRLF.
+		static constexpr std::size_t max_chunk_header_size = 4096;
+
+		/// The largest accepted size of all trailing headers combined.
+		static constexpr std::size_t max_trailer_size = 4096;
+
+		/// Constructs a decoder which does not verify chunk signatures.
+		aws_chunked_decoder() = default;
+
+		/// Constructs a decoder which verifies chunk signatures.
+		explicit aws_chunked_decoder(
+			chunk_signing_context _context,
+			authentication::digest_backend _backend = authentication::default_digest_backend());
+
+		aws_chunked_decoder(const aws_chunked_decoder&) = delete;
+		auto operator=(const aws_chunked_decoder&) -> aws_chunked_decoder& = delete;
+
+		/// Consumes bytes from the front of \p _input.
+		///
+		/// Decoding stops at the end of \p _input, at the end of a run of payload bytes, once the
+		/// body is complete, or on error. Callers should keep calling this function until \p _input
+		/// is empty or done() or failed() returns true.
+		///
+		/// \param[in,out] _input The bytes to decode. On return, the bytes which were consumed
+		///                       have been removed.
+		///
+		/// \return The payload bytes found, as a view into the original \p _input. This may be
+		///         empty.
+		auto next(std::string_view& _input) -> std::string_view;
+
+		/// Decodes all of \p _input, passing every run of payload bytes to \p _sink.
+		///
+		/// \return The number of bytes of \p _input which were consumed. This is less than the size
+		///         of \p _input if the body ended or an error occurred.
+		template <typename Sink>
+		auto decode(std::string_view _input, Sink&& _sink) -> std::size_t
+		{
+			const auto size = _input.size();
+
+			while (!_input.empty() && !done() && !failed()) {
+				if (const auto payload = next(_input); !payload.empty()) {
+					_sink(payload);
+				}
+			}
+
+			return size - _input.size();
+		} // decode
+
+		/// Returns true once the final chunk and the trailing headers have been decoded.
+		auto done() const noexcept -> bool
+		{
+			return state_ == state::done;
+		} // done
+
+		auto failed() const noexcept -> bool
+		{
+			return state_ == state::failed;
+		} // failed
+
+		auto error() const noexcept -> error_code
+		{
+			return error_;
+		} // error
+
+		/// Returns the number of payload bytes decoded so far.
+		auto payload_size() const noexcept -> std::uint64_t
+		{
+			return payload_size_;
+		} // payload_size
+
+		/// Returns the value of a trailing header, or an empty std::optional if the body did not
+		/// include it. Only meaningful once done() returns true.
+		///
+		/// \param[in] _name The lowercase name of the trailing header.
+		auto trailer(std::string_view _name) const -> std::optional<std::string_view>;
+
+	  private:
+		enum class state
+		{
+			chunk_size,
+			chunk_extensions,
+			chunk_header_lf,
+			chunk_data,
+			chunk_data_cr,
+			chunk_data_lf,
+			trailer_line,
+			trailer_lf,
+			done,
+			failed
+		}; // enum class state
+
+		auto fail(error_code _ec) -> std::string_view;
+
+		// Called once the header of a chunk has been decoded.
+		auto on_chunk_header_complete() -> void;
+
+		// Called once the data of a chunk has been decoded. Returns false if the chunk signature
+		// is incorrect.
+		auto verify_chunk_signature() -> bool;
+
+		// Called once a line of the trailing headers has been decoded.
+		auto on_trailer_line_complete() -> void;
+
+		// Returns false if the signature of the trailing headers is incorrect.
+		auto verify_trailer_signature() -> bool;
+
+		state state_ = state::chunk_size;
+		error_code error_ = error_code::none;
+
+		std::uint64_t chunk_size_ = 0;
+		std::uint64_t chunk_bytes_remaining_ = 0;
+		std::size_t chunk_size_digits_ = 0;
+		std::size_t chunk_header_size_ = 0;
+		std::uint64_t payload_size_ = 0;
+
+		// The text following the first ';' of the chunk header.
+		std::string chunk_extensions_;
+		std::string chunk_signature_;
+
+		std::optional<chunk_signing_context> signing_context_;
+		authentication::digest_backend backend_ = authentication::default_digest_backend();
+		std::optional<authentication::sha_256_hasher> chunk_hasher_;
+		std::string previous_signature_;
+
+		std::string trailer_line_;
+		std::size_t trailer_size_ = 0;
+		std::vector<std::pair<std::string, std::string>> trailers_;
+		std::string trailer_signature_;
+	}; // class aws_chunked_decoder
+
+	auto to_string(aws_chunked_decoder::error_code _ec) noexcept -> std::string_view;
+} // namespace irods::s3
+
+#endif // IRODS_S3_API_AWS_CHUNKED_DECODER_HPP
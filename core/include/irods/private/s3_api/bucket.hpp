@@ -5,8 +5,14 @@
 
 #include <irods/filesystem.hpp>
 
+#include <string_view>
+
 namespace irods::s3
 {
+	/// The name of the collection in the root of each bucket which holds data objects while they
+	/// are being written. It is not listed by ListObjects.
+	inline constexpr std::string_view staging_collection_name = ".irods_s3_api_staging";
+
 	/// Get the base path of the given bucket in the request.
 	///
 	/// \param connection The connection to the irods server.
@@ -20,6 +26,17 @@ namespace irods::s3
 	irods::experimental::filesystem::path finish_path(
 		const irods::experimental::filesystem::path& base,
 		const boost::urls::segments_view& view);
+
+	/// Get the path of the staging collection of the given bucket.
+	///
+	/// \param base The base irods path for the bucket
+	irods::experimental::filesystem::path staging_collection(const irods::experimental::filesystem::path& base);
+
+	/// Check whether a path lies in the staging collection of the given bucket.
+	///
+	/// \param base The base irods path for the bucket
+	/// \param path The irods path to check.
+	bool is_in_staging_collection(const irods::experimental::filesystem::path& base, std::string_view path);
 } // namespace irods::s3
 
 #endif // IRODS_S3_API_BUCKET_HPP
@@ -0,0 +1,141 @@
+#ifndef IRODS_S3_API_BUFFER_POOL_HPP
+#define IRODS_S3_API_BUFFER_POOL_HPP
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace irods::http
+{
+	struct buffer_pool_options
+	{
+		// The maximum number of bytes held by idle buffers across all size classes. Buffers
+		// released while the pool is full are freed. A value of 0 disables pooling.
+		std::size_t max_idle_bytes{};
+	}; // struct buffer_pool_options
+
+	/// A process-wide pool of the transfer buffers used by GetObject, PutObject, and
+	/// CompleteMultipartUpload.
+	///
+	/// Buffers are grouped into size classes, which are the powers of two from min_buffer_size to
+	/// max_buffer_size. A request is served from the smallest class which fits it, so buffers of
+	/// a similar size are interchangeable. Requests larger than max_buffer_size are allocated
+	/// directly and freed on release.
+	///
+	/// Each size class is split into shards, each with its own lock. A thread releases buffers to
+	/// the same shard and looks there first when acquiring one, which keeps contention low on
+	/// hosts with many cores and tends to hand a thread the buffers it touched last (i.e. memory
+	/// local to its NUMA node). The other shards are only searched when the shard of the thread
+	/// is empty, so that a buffer released by one thread can be reused by another.
+	///
+	/// Unlike std::vector, the memory of a buffer is not initialized.
+	///
+	/// This class is thread-safe.
+	class buffer_pool
+	{
+	  public:
+		static constexpr std::size_t min_buffer_size = std::size_t{4} * 1024;
+		static constexpr std::size_t max_buffer_size = std::size_t{8} * 1024 * 1024;
+
+		/// A buffer on loan from the pool. The buffer is returned to the pool on destruction.
+		class buffer
+		{
+		  public:
+			buffer() = default;
+
+			buffer(buffer&& _other) noexcept;
+			auto operator=(buffer&& _other) noexcept -> buffer&;
+
+			buffer(const buffer&) = delete;
+			auto operator=(const buffer&) -> buffer& = delete;
+
+			~buffer();
+
+			auto data() noexcept -> char*
+			{
+				return data_.get();
+			} // data
+
+			auto data() const noexcept -> const char*
+			{
+				return data_.get();
+			} // data
+
+			/// Returns the size requested from the pool. The underlying allocation may be larger.
+			auto size() const noexcept -> std::size_t
+			{
+				return size_;
+			} // size
+
+		  private:
+			friend class buffer_pool;
+
+			buffer(buffer_pool& _pool, std::unique_ptr<char[]> _data, std::size_t _size, std::size_t _size_class);
+
+			auto release() noexcept -> void;
+
+			buffer_pool* pool_{};
+			std::unique_ptr<char[]> data_;
+			std::size_t size_{};
+			std::size_t size_class_{};
+		}; // class buffer
+
+		explicit buffer_pool(buffer_pool_options _options);
+
+		buffer_pool(const buffer_pool&) = delete;
+		auto operator=(const buffer_pool&) -> buffer_pool& = delete;
+
+		~buffer_pool() = default;
+
+		/// Returns a buffer of at least \p _size bytes. An idle buffer is reused when possible.
+		auto acquire(std::size_t _size) -> buffer;
+
+		/// Returns the allocation hit and miss counters along with the occupancy of the pool.
+		auto to_json() const -> nlohmann::json;
+
+	  private:
+		static constexpr std::size_t size_class_count = 12; // 4 KiB to 8 MiB.
+		static constexpr std::size_t shard_count = 8;
+
+		// The size class of allocations larger than max_buffer_size.
+		static constexpr std::size_t unpooled = size_class_count;
+
+		struct shard_type
+		{
+			std::mutex mtx;
+			std::vector<std::unique_ptr<char[]>> idle;
+		}; // struct shard_type
+
+		struct size_class_type
+		{
+			std::array<shard_type, shard_count> shards;
+			std::atomic<std::uint64_t> idle_buffers{};
+		}; // struct size_class_type
+
+		static auto size_class_of(std::size_t _size) noexcept -> std::size_t;
+		static auto size_of(std::size_t _size_class) noexcept -> std::size_t;
+		static auto shard_index() noexcept -> std::size_t;
+
+		auto release(std::unique_ptr<char[]> _data, std::size_t _size_class, std::size_t _size) noexcept -> void;
+
+		const std::size_t max_idle_bytes_;
+		std::array<size_class_type, size_class_count> size_classes_;
+
+		std::atomic<std::uint64_t> idle_bytes_{};
+		std::atomic<std::uint64_t> in_use_buffers_{};
+		std::atomic<std::uint64_t> in_use_bytes_{};
+		std::atomic<std::uint64_t> hits_{};
+		std::atomic<std::uint64_t> misses_{};
+		std::atomic<std::uint64_t> remote_hits_{}; // Hits served from the shard of another thread.
+		std::atomic<std::uint64_t> unpooled_allocations_{};
+		std::atomic<std::uint64_t> discarded_buffers_{};
+	}; // class buffer_pool
+} // namespace irods::http
+
+#endif // IRODS_S3_API_BUFFER_POOL_HPP
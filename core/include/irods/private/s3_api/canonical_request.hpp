@@ -0,0 +1,48 @@
+#ifndef IRODS_S3_API_CANONICAL_REQUEST_HPP
+#define IRODS_S3_API_CANONICAL_REQUEST_HPP
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/parser.hpp>
+#pragma GCC diagnostic pop
+
+#include <boost/url/url_view.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace irods::s3::authentication
+{
+	/// URI-encodes a string as required by SigV4.
+	///
+	/// Unreserved characters (A-Z, a-z, 0-9, '-', '.', '_', '~') are copied. All other bytes are
+	/// written as '%' followed by two uppercase hexadecimal digits.
+	///
+	/// \param[in] _sv The string to encode.
+	///
+	/// \return The encoded string.
+	auto uri_encode(std::string_view _sv) -> std::string;
+
+	/// Computes the SHA-256 hash of the SigV4 canonical request.
+	///
+	/// The canonical request is written in a single pass into a fixed-size buffer which is fed to
+	/// the hash whenever it fills up. The canonical request is never held in memory in full unless
+	/// \p _canonical_request is provided.
+	///
+	/// \param[in]  _parser            The parser holding the request header.
+	/// \param[in]  _url               The URL of the request.
+	/// \param[in]  _signed_headers    The lowercase names of the headers covered by the signature.
+	/// \param[out] _canonical_request If not null, receives a copy of the canonical request. This
+	///                                is intended for logging.
+	///
+	/// \return The hexadecimal encoding of the hash.
+	auto hash_canonical_request(
+		const boost::beast::http::request_parser<boost::beast::http::empty_body>& _parser,
+		const boost::urls::url_view& _url,
+		const std::vector<std::string>& _signed_headers,
+		std::string* _canonical_request = nullptr) -> std::string;
+} // namespace irods::s3::authentication
+
+#endif // IRODS_S3_API_CANONICAL_REQUEST_HPP
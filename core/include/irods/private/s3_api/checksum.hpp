@@ -0,0 +1,114 @@
+#ifndef IRODS_S3_API_CHECKSUM_HPP
+#define IRODS_S3_API_CHECKSUM_HPP
+
+#include "irods/private/s3_api/hmac.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace irods::s3
+{
+	/// The checksum algorithms which clients can announce through x-amz-checksum-* headers and
+	/// trailers.
+	enum class checksum_algorithm
+	{
+		crc32,
+		crc32c,
+		sha256
+	}; // enum class checksum_algorithm
+
+	/// Returns the algorithm matching the name of a checksum header (e.g. x-amz-checksum-crc32c).
+	/// The name is matched case-insensitively.
+	auto checksum_algorithm_from_header_name(std::string_view _name) -> std::optional<checksum_algorithm>;
+
+	/// Returns the lowercase name of the header carrying a checksum of the given algorithm.
+	auto checksum_header_name(checksum_algorithm _algorithm) noexcept -> std::string_view;
+
+	/// Updates a CRC-32 (ISO-HDLC, as used by zlib) with \p _data.
+	///
+	/// \param[in] _crc  The CRC of the preceding data, or 0.
+	/// \param[in] _data The next range of bytes.
+	auto crc32(std::uint32_t _crc, std::string_view _data) noexcept -> std::uint32_t;
+
+	/// Updates a CRC-32C (Castagnoli) with \p _data.
+	///
+	/// The CRC instructions of the CPU are used when they are available.
+	///
+	/// \param[in] _crc  The CRC of the preceding data, or 0.
+	/// \param[in] _data The next range of bytes.
+	auto crc32c(std::uint32_t _crc, std::string_view _data) noexcept -> std::uint32_t;
+
+	/// Computes a checksum over data supplied in pieces.
+	class checksum_calculator
+	{
+	  public:
+		explicit checksum_calculator(checksum_algorithm _algorithm);
+
+		checksum_calculator(const checksum_calculator&) = delete;
+		auto operator=(const checksum_calculator&) -> checksum_calculator& = delete;
+
+		auto algorithm() const noexcept -> checksum_algorithm
+		{
+			return algorithm_;
+		} // algorithm
+
+		auto update(std::string_view _data) -> void;
+
+		/// Completes the checksum. The calculator must not be updated afterwards.
+		///
+		/// \return The base64 encoding of the checksum, as used by x-amz-checksum-* headers.
+		auto finalize() -> std::string;
+
+	  private:
+		checksum_algorithm algorithm_;
+		std::uint32_t crc_ = 0;
+		std::optional<authentication::sha_256_hasher> hasher_;
+	}; // class checksum_calculator
+
+	/// Computes an MD5 digest over data supplied in pieces, using OpenSSL.
+	class md5_calculator
+	{
+	  public:
+		md5_calculator();
+		~md5_calculator();
+
+		md5_calculator(const md5_calculator&) = delete;
+		auto operator=(const md5_calculator&) -> md5_calculator& = delete;
+
+		auto update(std::string_view _data) -> void;
+
+		/// Completes the digest. The calculator must not be updated afterwards.
+		///
+		/// \return The 16 bytes of the digest.
+		auto finalize() -> std::string;
+
+	  private:
+		struct impl;
+		std::unique_ptr<impl> impl_;
+	}; // class md5_calculator
+
+	/// Returns the ETag of an object uploaded in a single part (i.e. the quoted hexadecimal
+	/// encoding of its MD5 digest).
+	///
+	/// \param[in] _md5 The 16 bytes of the MD5 digest of the object.
+	auto make_etag(std::string_view _md5) -> std::string;
+
+	/// Returns the ETag of an object uploaded in multiple parts.
+	///
+	/// The ETag is the MD5 digest of the concatenated MD5 digests of the parts, followed by a dash
+	/// and the number of parts.
+	///
+	/// \param[in] _part_etags The ETags of the parts, in order. Surrounding quotes are optional.
+	///
+	/// \return The ETag, or an empty std::optional if one of the part ETags is not an MD5 digest.
+	auto make_multipart_etag(const std::vector<std::string>& _part_etags) -> std::optional<std::string>;
+
+	/// Encodes bytes in base64.
+	auto base64_encode(std::string_view _data) -> std::string;
+} // namespace irods::s3
+
+#endif // IRODS_S3_API_CHECKSUM_HPP
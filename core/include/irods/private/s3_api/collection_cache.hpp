@@ -0,0 +1,81 @@
+#ifndef IRODS_S3_API_COLLECTION_CACHE_HPP
+#define IRODS_S3_API_COLLECTION_CACHE_HPP
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace irods::s3
+{
+	/// A bounded, thread-safe cache of collections known to exist.
+	///
+	/// PutObject makes sure the parent collection of an object exists before writing it, which
+	/// costs a catalog round trip. Entries are keyed on the zone and the logical path of the
+	/// collection. A collection is added once it has been created (or found to exist), and
+	/// removed along with every collection below it when it is deleted through the S3 API.
+	///
+	/// Collections removed by other iRODS clients are not seen until their entries expire, so
+	/// entries are only trusted for a limited time.
+	///
+	/// The cache is split into shards, each with its own lock, to reduce contention.
+	class collection_cache
+	{
+	  public:
+		using clock_type = std::chrono::steady_clock;
+
+		/// \param[in] _capacity     The maximum number of entries. A capacity of 0 disables the cache.
+		/// \param[in] _time_to_live The amount of time an entry is trusted after it is added.
+		collection_cache(std::size_t _capacity, std::chrono::seconds _time_to_live);
+
+		collection_cache(const collection_cache&) = delete;
+		auto operator=(const collection_cache&) -> collection_cache& = delete;
+
+		auto enabled() const noexcept -> bool
+		{
+			return capacity_per_shard_ > 0;
+		} // enabled
+
+		/// Returns true if the collection is known to exist.
+		auto contains(std::string_view _zone, std::string_view _path, clock_type::time_point _now = clock_type::now())
+			-> bool;
+
+		/// Records that the collection exists.
+		auto insert(std::string_view _zone, std::string_view _path, clock_type::time_point _now = clock_type::now())
+			-> void;
+
+		/// Removes the collection and every collection below it.
+		auto erase(std::string_view _zone, std::string_view _path) -> void;
+
+		auto to_json() const -> nlohmann::json;
+
+	  private:
+		static constexpr std::size_t shard_count = 16;
+
+		struct shard_type
+		{
+			std::mutex mtx;
+			std::unordered_map<std::string, clock_type::time_point> entries;
+		}; // struct shard_type
+
+		static auto make_key(std::string_view _zone, std::string_view _path) -> std::string;
+
+		auto shard_for(const std::string& _key) -> shard_type&;
+
+		const std::size_t capacity_per_shard_;
+		const std::chrono::seconds time_to_live_;
+		std::array<shard_type, shard_count> shards_;
+		std::atomic<std::uint64_t> hits_{};
+		std::atomic<std::uint64_t> misses_{};
+		std::atomic<std::uint64_t> invalidations_{};
+	}; // class collection_cache
+} // namespace irods::s3
+
+#endif // IRODS_S3_API_COLLECTION_CACHE_HPP
@@ -5,13 +5,27 @@
 
 namespace irods::s3
 {
+	std::string get_zone();
 	std::string get_resource();
 
 	uint64_t get_put_object_buffer_size_in_bytes();
+	uint64_t get_put_object_pipeline_depth();
+	uint64_t get_put_object_parallel_write_streams();
+	uint64_t get_put_object_parallel_write_threshold_in_bytes();
 	uint64_t get_get_object_buffer_size_in_bytes();
+	uint64_t get_get_object_pipeline_depth();
+	uint64_t get_get_object_parallel_read_streams();
+	uint64_t get_get_object_parallel_read_threshold_in_bytes();
+	uint64_t get_complete_multipart_upload_parallel_part_writes();
+
+	int get_request_timeout_in_seconds();
 
 	std::string get_s3_region();
 
+	bool get_multipart_upload_infer_part_size();
+
+	uint64_t get_signing_key_cache_size();
+
 } //namespace irods::s3
 
 #endif //IRODS_S3_API_CONFIGURATION_HPP
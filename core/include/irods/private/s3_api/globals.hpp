@@ -1,6 +1,14 @@
 #ifndef IRODS_S3_API_GLOBALS_HPP
 #define IRODS_S3_API_GLOBALS_HPP
 
+#include "irods/private/s3_api/buffer_pool.hpp"
+#include "irods/private/s3_api/collection_cache.hpp"
+#include "irods/private/s3_api/multipart_journal.hpp"
+#include "irods/private/s3_api/multipart_upload_index.hpp"
+#include "irods/private/s3_api/part_staging_area.hpp"
+#include "irods/private/s3_api/permit_pool.hpp"
+#include "irods/private/s3_api/streaming_connection_pool.hpp"
+
 #include <irods/connection_pool.hpp>
 
 #include <boost/asio/io_context.hpp>
@@ -27,6 +35,27 @@ namespace irods::http::globals
 	auto set_connection_pool(irods::connection_pool& _cp) -> void;
 	auto connection_pool() -> irods::connection_pool&;
 
+	auto set_streaming_connection_pool(irods::http::streaming_connection_pool& _cp) -> void;
+	auto streaming_connection_pool() -> irods::http::streaming_connection_pool&;
+
+	auto set_buffer_pool(irods::http::buffer_pool& _bp) -> void;
+	auto buffer_pool() -> irods::http::buffer_pool&;
+
+	auto set_collection_cache(irods::s3::collection_cache& _cache) -> void;
+	auto collection_cache() -> irods::s3::collection_cache&;
+
+	auto set_part_staging_area(irods::s3::part_staging_area& _area) -> void;
+	auto part_staging_area() -> irods::s3::part_staging_area&;
+
+	auto set_part_writer_permits(irods::http::permit_pool& _permits) -> void;
+	auto part_writer_permits() -> irods::http::permit_pool&;
+
+	auto set_multipart_journal(irods::s3::multipart_journal& _journal) -> void;
+	auto multipart_journal() -> irods::s3::multipart_journal&;
+
+	auto set_multipart_upload_index(irods::s3::multipart_upload_index& _index) -> void;
+	auto multipart_upload_index() -> irods::s3::multipart_upload_index&;
+
 	auto set_bucket_mapping_library(boost::dll::shared_library _lib) -> void;
 	auto bucket_mapping_library() -> boost::dll::shared_library&;
 
@@ -1,24 +1,70 @@
 #ifndef IRODS_S3_API_HMAC_HPP
 #define IRODS_S3_API_HMAC_HPP
+#include <memory>
 #include <string_view>
 #include <string>
 #include <vector>
 
 namespace irods::s3::authentication
 {
+	/// The implementations available for computing digests.
+	enum class digest_backend
+	{
+		/// The portable C implementation bundled in third-party/hmac_sha256.
+		portable,
+
+		/// OpenSSL's EVP interface. OpenSSL detects the CPU features at runtime and uses the SHA
+		/// extensions or the SIMD code paths when they are available.
+		openssl
+	};
+
+	/// Returns the backend used when none is requested explicitly.
+	digest_backend default_digest_backend() noexcept;
+
+	/// Returns the name of a backend, for logging.
+	std::string_view to_string(digest_backend backend) noexcept;
+
 	/// Produce a hmac_sha_256 signature
 	/// @param key The key
 	/// @param data The data
+	/// @param backend The implementation to use.
 	/// @returns the signature
-	std::string hmac_sha_256(const std::string_view& key, const std::string_view& data);
+	std::string hmac_sha_256(
+		const std::string_view& key,
+		const std::string_view& data,
+		digest_backend backend = default_digest_backend());
 
 	/// Produce a sha256 hash
 	/// @param data The range of bytes to hash.
+	/// @param backend The implementation to use.
 	/// @returns The hash
-	std::string hash_sha_256(const std::string_view& data);
+	std::string hash_sha_256(const std::string_view& data, digest_backend backend = default_digest_backend());
+
+	/// Computes a sha256 hash over data supplied in pieces.
+	class sha_256_hasher
+	{
+	  public:
+		explicit sha_256_hasher(digest_backend backend = default_digest_backend());
+		~sha_256_hasher();
+
+		sha_256_hasher(const sha_256_hasher&) = delete;
+		auto operator=(const sha_256_hasher&) -> sha_256_hasher& = delete;
+
+		/// Add bytes to the hash.
+		/// @param data The next range of bytes to hash.
+		void update(const std::string_view& data);
+
+		/// Complete the hash. The hasher must not be updated afterwards.
+		/// @returns The hash
+		std::string finalize();
+
+	  private:
+		struct impl;
+		std::unique_ptr<impl> impl_;
+	};
 
 	/// Encode a string view in hexadecimal.
 	/// @param data the data to convert to string
 	std::string hex_encode(const std::string_view& data);
 } //namespace irods::s3::authentication
-#endif // IRODS_S3_API_HMAC_HPP
\ No newline at end of file
+#endif // IRODS_S3_API_HMAC_HPP
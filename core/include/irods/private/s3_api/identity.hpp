@@ -0,0 +1,81 @@
+#ifndef IRODS_S3_API_IDENTITY_HPP
+#define IRODS_S3_API_IDENTITY_HPP
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+struct RcComm;
+
+namespace irods::http
+{
+	/// Counters describing how often pooled connections had to change identity.
+	///
+	/// A hit means the connection already acted on behalf of the requested user, so no call to
+	/// rc_switch_user was necessary. A miss means rc_switch_user was called. The switch time is
+	/// the total time spent in successful calls to rc_switch_user.
+	///
+	/// This class is thread-safe.
+	class identity_switch_metrics
+	{
+	  public:
+		static auto instance() -> identity_switch_metrics&;
+
+		auto record_hit() noexcept -> void
+		{
+			hits_.fetch_add(1, std::memory_order_relaxed);
+		} // record_hit
+
+		auto record_switch(std::chrono::nanoseconds _elapsed) noexcept -> void
+		{
+			misses_.fetch_add(1, std::memory_order_relaxed);
+			switch_time_in_nanoseconds_.fetch_add(static_cast<std::uint64_t>(_elapsed.count()), std::memory_order_relaxed);
+		} // record_switch
+
+		auto record_switch_failure() noexcept -> void
+		{
+			misses_.fetch_add(1, std::memory_order_relaxed);
+			switch_failures_.fetch_add(1, std::memory_order_relaxed);
+		} // record_switch_failure
+
+		auto to_json() const -> nlohmann::json;
+
+	  private:
+		identity_switch_metrics() = default;
+
+		std::atomic<std::uint64_t> hits_{};
+		std::atomic<std::uint64_t> misses_{};
+		std::atomic<std::uint64_t> switch_failures_{};
+		std::atomic<std::uint64_t> switch_time_in_nanoseconds_{};
+	}; // class identity_switch_metrics
+
+	/// Returns whether \p _comm acts on behalf of \p _username in \p _zone.
+	auto has_identity(const RcComm& _comm, const std::string& _username, const std::string& _zone) -> bool;
+
+	/// Makes \p _comm act on behalf of \p _username in \p _zone, and closes any replicas left
+	/// open on the connection.
+	///
+	/// rc_switch_user is always called. The outcome is recorded in identity_switch_metrics.
+	///
+	/// \return An iRODS error code. 0 on success.
+	auto change_identity(RcComm& _comm, const std::string& _username, const std::string& _zone) -> int;
+
+	/// Makes \p _comm act on behalf of \p _username in \p _zone.
+	///
+	/// rc_switch_user is only called if the connection does not already carry the identity. The
+	/// caller must know that no replicas were left open on the connection (see
+	/// close_open_replicas). The outcome is recorded in identity_switch_metrics.
+	///
+	/// \return An iRODS error code. 0 on success.
+	auto switch_identity(RcComm& _comm, const std::string& _username, const std::string& _zone) -> int;
+
+	/// Closes any replicas left open on \p _comm without changing its identity.
+	///
+	/// \return An iRODS error code. 0 on success.
+	auto close_open_replicas(RcComm& _comm) -> int;
+} // namespace irods::http
+
+#endif // IRODS_S3_API_IDENTITY_HPP
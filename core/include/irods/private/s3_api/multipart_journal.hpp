@@ -0,0 +1,193 @@
+#ifndef IRODS_S3_API_MULTIPART_JOURNAL_HPP
+#define IRODS_S3_API_MULTIPART_JOURNAL_HPP
+
+#include "irods/private/s3_api/multipart_upload_index.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace irods::s3
+{
+	struct multipart_journal_options
+	{
+		// The file holding the journal. An empty path disables the journal.
+		std::string path;
+
+		// The size the journal may grow to before it is compacted. The journal is compacted once
+		// it is larger than this value and at least twice the size of the state it describes.
+		std::size_t compaction_threshold_in_bytes{};
+	}; // struct multipart_journal_options
+
+	/// An append-only record of the state of the multipart uploads in progress, kept in a
+	/// memory-mapped file.
+	///
+	/// The in-memory multipart state (i.e. the uploads, part sizes, and part layouts) is lost when
+	/// the server restarts, which forces clients to upload every part again. Each change to the state
+	/// is appended to the journal, and the journal is replayed when it is opened so that uploads
+	/// can resume where they left off.
+	///
+	/// A record is a 32-bit size, the CRC-32C of its payload, and the payload. Records are copied
+	/// into a shared mapping of the file, so they outlive a crash of the server process. Records
+	/// cut short by a crash fail their checksum and end the replay. The journal is rewritten
+	/// without the records of finished uploads once it grows large enough.
+	///
+	/// Parts held in memory by the part staging area are recorded as such. They are lost on
+	/// restart, so they are not restored.
+	///
+	/// This class is thread-safe.
+	class multipart_journal
+	{
+	  public:
+		/// The state of an upload restored from the journal.
+		struct upload_state
+		{
+			// The part size announced to CreateMultipartUpload or inferred from the first part.
+			std::optional<std::uint64_t> part_size;
+
+			// The sizes of the parts written to iRODS or to part files, keyed on part number.
+			std::map<unsigned int, std::uint64_t> part_sizes;
+
+			// The bucket and key of the upload, if it was created after the journal was enabled.
+			std::optional<multipart_upload_entry> entry;
+
+			// The parts received in full, keyed on part number.
+			std::map<unsigned int, multipart_upload_part> uploaded_parts;
+		}; // struct upload_state
+
+		/// Opens the journal, creating the file if it does not exist, and replays it.
+		///
+		/// \throws std::system_error If the file cannot be opened or mapped.
+		explicit multipart_journal(multipart_journal_options _options);
+
+		multipart_journal(const multipart_journal&) = delete;
+		auto operator=(const multipart_journal&) -> multipart_journal& = delete;
+
+		~multipart_journal();
+
+		auto enabled() const noexcept -> bool
+		{
+			return !options_.path.empty();
+		} // enabled
+
+		/// Returns the uploads found when the journal was replayed, keyed on upload ID. The
+		/// uploads are only returned once.
+		auto take_restored_uploads() -> std::unordered_map<std::string, upload_state>;
+
+		/// Records the creation of an upload.
+		auto record_upload_created(const multipart_upload_entry& _upload) -> void;
+
+		/// Records the part size shared by the parts of an upload.
+		auto record_part_size(std::string_view _upload_id, std::uint64_t _part_size) -> void;
+
+		/// Records the size of a part which has been, or is being, written to iRODS or to a part
+		/// file.
+		auto record_part(std::string_view _upload_id, unsigned int _part_number, std::uint64_t _size) -> void;
+
+		/// Records that a part was received in full, along with its ETag.
+		auto record_part_uploaded(
+			std::string_view _upload_id,
+			unsigned int _part_number,
+			const multipart_upload_part& _part) -> void;
+
+		/// Records that a part is only held in memory. It is not restored unless it is recorded
+		/// again with record_part().
+		auto record_staged_part(std::string_view _upload_id, unsigned int _part_number) -> void;
+
+		/// Records that an upload was completed or aborted.
+		auto record_upload_ended(std::string_view _upload_id) -> void;
+
+		auto to_json() const -> nlohmann::json;
+
+	  private:
+		enum class record_type : std::uint8_t
+		{
+			part_size = 1,
+			part = 2,
+			staged_part = 3,
+			upload_ended = 4,
+			upload_created = 5,
+			part_uploaded = 6
+		}; // enum class record_type
+
+		struct part_type
+		{
+			std::uint64_t size{};
+			bool staged{};
+
+			// Set once the part was received in full.
+			std::optional<multipart_upload_part> uploaded;
+		}; // struct part_type
+
+		struct upload_type
+		{
+			std::optional<std::uint64_t> part_size;
+			std::map<unsigned int, part_type> parts;
+			std::optional<multipart_upload_entry> entry;
+		}; // struct upload_type
+
+		// Encodes a record, including its size and checksum, and appends it to _out. The detail
+		// follows the fixed fields of the payload, and is only used by some record types.
+		static auto encode(
+			std::vector<char>& _out,
+			record_type _type,
+			std::string_view _upload_id,
+			unsigned int _part_number = 0,
+			std::uint64_t _value = 0,
+			std::string_view _detail = {}) -> void;
+
+		// Encodes the records describing an upload and appends them to _out.
+		static auto encode_upload(std::vector<char>& _out, std::string_view _upload_id, const upload_type& _upload)
+			-> void;
+
+		// Applies a record to the state. Returns false if the payload is malformed.
+		auto apply(std::string_view _payload) -> bool;
+
+		// Maps the file, replays its records, and discards anything following the last valid record.
+		auto replay() -> void;
+
+		// Applies a record and appends it to the file. The mutex must be held.
+		auto append(
+			record_type _type,
+			std::string_view _upload_id,
+			unsigned int _part_number = 0,
+			std::uint64_t _value = 0,
+			std::string_view _detail = {}) -> void;
+
+		// Grows the file so that it has room for _size more bytes. The mutex must be held.
+		auto reserve(std::size_t _size) -> bool;
+
+		// Rewrites the file with the records describing the current state, if that shrinks it
+		// enough. The mutex must be held.
+		auto compact_if_needed() -> void;
+
+		auto map(std::size_t _capacity) -> void;
+		auto unmap() noexcept -> void;
+
+		const multipart_journal_options options_;
+
+		mutable std::mutex mtx_;
+		int fd_ = -1;
+		char* data_ = nullptr;
+		std::size_t capacity_ = 0;
+		std::size_t tail_ = 0;
+		std::size_t compact_at_ = 0;
+
+		std::unordered_map<std::string, upload_type> uploads_;
+		std::unordered_map<std::string, upload_state> restored_;
+
+		std::uint64_t appended_records_ = 0;
+		std::uint64_t failed_appends_ = 0;
+		std::uint64_t compactions_ = 0;
+	}; // class multipart_journal
+} // namespace irods::s3
+
+#endif // IRODS_S3_API_MULTIPART_JOURNAL_HPP
@@ -0,0 +1,121 @@
+#ifndef IRODS_S3_API_MULTIPART_UPLOAD_INDEX_HPP
+#define IRODS_S3_API_MULTIPART_UPLOAD_INDEX_HPP
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace irods::s3
+{
+	/// A multipart upload in progress.
+	struct multipart_upload_entry
+	{
+		std::string bucket;
+		std::string key;
+		std::string upload_id;
+
+		// The iRODS user who created the upload.
+		std::string owner;
+
+		std::chrono::system_clock::time_point initiated;
+	}; // struct multipart_upload_entry
+
+	/// A part of a multipart upload which has been received in full.
+	struct multipart_upload_part
+	{
+		std::uint64_t size{};
+
+		// The quoted MD5 digest returned by UploadPart.
+		std::string etag;
+
+		std::chrono::system_clock::time_point last_modified;
+	}; // struct multipart_upload_part
+
+	struct multipart_upload_listing_options
+	{
+		std::string_view bucket{};
+
+		// Only the uploads of keys beginning with this prefix are listed.
+		std::string_view prefix{};
+
+		// If not empty, the keys containing the delimiter after the prefix are rolled up into a
+		// single common prefix ending with the delimiter.
+		std::string_view delimiter{};
+
+		// The listing begins after this key, or after the upload with the upload ID marker if it
+		// was made for this key.
+		std::string_view key_marker{};
+		std::string_view upload_id_marker{};
+
+		// The maximum number of uploads and common prefixes returned.
+		std::size_t max_uploads = 1000;
+	}; // struct multipart_upload_listing_options
+
+	struct multipart_upload_listing
+	{
+		std::vector<multipart_upload_entry> uploads;
+		std::vector<std::string> common_prefixes;
+
+		// True if the listing stopped at max_uploads. The next listing begins at the markers.
+		bool is_truncated = false;
+		std::string next_key_marker;
+		std::string next_upload_id_marker;
+	}; // struct multipart_upload_listing
+
+	/// The multipart uploads in progress, ordered by bucket, key, and initiation time, as
+	/// ListMultipartUploads requires.
+	///
+	/// A listing seeks to its first upload and copies only the uploads it returns, so the cost
+	/// of a page does not depend on the number of uploads in progress. Keys rolled up into a
+	/// common prefix are skipped with a single seek.
+	///
+	/// This class is thread-safe.
+	class multipart_upload_index
+	{
+	  public:
+		/// Adds an upload. Adding an upload which is already indexed does nothing.
+		auto insert(multipart_upload_entry _upload) -> void;
+
+		/// Removes an upload, if it is indexed.
+		auto erase(const std::string& _upload_id) -> void;
+
+		/// Returns an upload, or an empty std::optional if it is not indexed.
+		auto find(const std::string& _upload_id) const -> std::optional<multipart_upload_entry>;
+
+		/// Returns a page of the uploads of a bucket.
+		auto list(const multipart_upload_listing_options& _options) const -> multipart_upload_listing;
+
+		auto to_json() const -> nlohmann::json;
+
+	  private:
+		// Bucket, key, initiation time in nanoseconds since the epoch, and upload ID.
+		using order_key = std::tuple<std::string, std::string, std::int64_t, std::string>;
+
+		// Returns an iterator to the first upload of _bucket whose key is not less than _key.
+		auto first_upload_from(std::string_view _bucket, std::string _key) const
+			-> std::map<order_key, std::string>::const_iterator;
+
+		// Returns an iterator to the first upload of _bucket following the keys beginning with
+		// _prefix.
+		auto first_upload_after_prefix(std::string_view _bucket, std::string_view _prefix) const
+			-> std::map<order_key, std::string>::const_iterator;
+
+		mutable std::mutex mtx_;
+
+		// Maps each upload to its owner.
+		std::map<order_key, std::string> uploads_;
+		std::unordered_map<std::string, order_key> order_keys_;
+	}; // class multipart_upload_index
+} // namespace irods::s3
+
+#endif // IRODS_S3_API_MULTIPART_UPLOAD_INDEX_HPP
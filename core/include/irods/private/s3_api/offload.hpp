@@ -0,0 +1,41 @@
+#ifndef IRODS_S3_API_OFFLOAD_HPP
+#define IRODS_S3_API_OFFLOAD_HPP
+
+#include "irods/private/s3_api/globals.hpp"
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <type_traits>
+#include <utility>
+
+namespace irods::http
+{
+	/// Runs a blocking function on the background thread pool.
+	///
+	/// The calling coroutine is suspended until the function returns and is then resumed on
+	/// its own executor (i.e. the session's strand). This allows request handlers to keep all
+	/// socket I/O on the request handler io_context while calls into iRODS, which are always
+	/// blocking, execute on the background thread pool.
+	///
+	/// Exceptions thrown by the function are rethrown in the calling coroutine.
+	///
+	/// \param[in] _func The function to execute. It is invoked with no arguments. Because the
+	///                  caller is suspended until the function completes, the function may
+	///                  safely capture the caller's local variables by reference.
+	///
+	/// \return The value returned by \p _func.
+	template <typename Function>
+	auto offload(Function _func) -> boost::asio::awaitable<std::invoke_result_t<Function&>>
+	{
+		using result_type = std::invoke_result_t<Function&>;
+
+		co_return co_await boost::asio::co_spawn(
+			globals::background_thread_pool(),
+			[f = std::move(_func)]() mutable -> boost::asio::awaitable<result_type> { co_return f(); },
+			boost::asio::use_awaitable);
+	} // offload
+} // namespace irods::http
+
+#endif // IRODS_S3_API_OFFLOAD_HPP
@@ -0,0 +1,73 @@
+#ifndef IRODS_S3_API_PART_SIZE_INDEX_HPP
+#define IRODS_S3_API_PART_SIZE_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace irods::s3
+{
+	/// The largest part number S3 allows. Part numbers start at 1.
+	inline constexpr unsigned int max_part_number = 10000;
+
+	/// Parses the partNumber of an UploadPart request.
+	///
+	/// \return The part number, or an empty std::optional if \p _value is not a decimal number from
+	///         1 to max_part_number.
+	auto parse_part_number(std::string_view _value) -> std::optional<unsigned int>;
+
+	/// The sizes of the parts of a multipart upload received so far.
+	///
+	/// The offset of a part is the sum of the sizes of the parts preceding it, and is only known
+	/// once all of them have been received. The sizes and the number of parts received are kept
+	/// in Fenwick trees, so recording a part and computing an offset take O(log N) time for an
+	/// upload of N parts, rather than O(N).
+	///
+	/// This class is not thread-safe.
+	class part_size_index
+	{
+	  public:
+		/// Records the size of a part, replacing the size recorded earlier, if any. Part numbers
+		/// outside of 1 to max_part_number are ignored, so that the index stays small.
+		///
+		/// \param[in] _part_number The part number, starting at 1.
+		auto set(unsigned int _part_number, std::uint64_t _size) -> void;
+
+		/// Returns the size of a part, or an empty std::optional if it has not been recorded.
+		auto get(unsigned int _part_number) const -> std::optional<std::uint64_t>;
+
+		/// Returns the offset of a part within the object, or an empty std::optional if the size
+		/// of one of the parts preceding it has not been recorded.
+		auto offset_of(unsigned int _part_number) const -> std::optional<std::uint64_t>;
+
+		/// Returns the number of parts whose size has been recorded.
+		auto size() const noexcept -> std::size_t
+		{
+			return part_count_;
+		} // size
+
+		auto empty() const noexcept -> bool
+		{
+			return part_count_ == 0;
+		} // empty
+
+	  private:
+		// Makes room for part numbers up to and including _part_number.
+		auto grow(unsigned int _part_number) -> void;
+
+		// Returns the sum of the sizes, and the number, of the parts from 1 to _part_number.
+		auto prefix_sum(unsigned int _part_number) const noexcept -> std::uint64_t;
+		auto prefix_count(unsigned int _part_number) const noexcept -> std::uint64_t;
+
+		// Indexed by part number. Element 0 is unused.
+		std::vector<std::optional<std::uint64_t>> sizes_{std::nullopt};
+		std::vector<std::uint64_t> size_tree_{0};
+		std::vector<std::uint64_t> count_tree_{0};
+
+		std::size_t part_count_ = 0;
+	}; // class part_size_index
+} // namespace irods::s3
+
+#endif // IRODS_S3_API_PART_SIZE_INDEX_HPP
@@ -0,0 +1,164 @@
+#ifndef IRODS_S3_API_PART_STAGING_AREA_HPP
+#define IRODS_S3_API_PART_STAGING_AREA_HPP
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace irods::s3
+{
+	class part_staging_area;
+
+	/// The bytes of a multipart upload part held in memory. The memory is mapped when the part
+	/// is allocated and unmapped on destruction.
+	class staged_part
+	{
+	  public:
+		staged_part(const staged_part&) = delete;
+		auto operator=(const staged_part&) -> staged_part& = delete;
+
+		~staged_part();
+
+		auto data() noexcept -> char*
+		{
+			return data_;
+		} // data
+
+		auto data() const noexcept -> const char*
+		{
+			return data_;
+		} // data
+
+		auto size() const noexcept -> std::size_t
+		{
+			return size_;
+		} // size
+
+	  private:
+		friend class part_staging_area;
+
+		staged_part(part_staging_area& _area, char* _data, std::size_t _size);
+
+		part_staging_area* area_;
+		char* data_;
+		std::size_t size_;
+	}; // class staged_part
+
+	/// Holds multipart upload parts whose offset within the object is not known when they arrive.
+	///
+	/// A part can only be written to iRODS once the sizes of all preceding parts are known.
+	/// Instead of spilling such a part to a local file and copying it to iRODS during
+	/// CompleteMultipartUpload, UploadPart keeps it in anonymous memory mappings until the
+	/// preceding part sizes are known. The total size of the staged parts is bounded. Parts which
+	/// do not fit are written to part files as before.
+	///
+	/// A part is taken out of the staging area while it is written to iRODS. The staging area
+	/// counts such parts as in flight so that CompleteMultipartUpload can wait for them before
+	/// writing the remaining parts and closing the data object.
+	///
+	/// This class is thread-safe.
+	class part_staging_area
+	{
+	  public:
+		/// \param[in] _max_bytes The maximum number of bytes held by staged parts. A value of 0
+		///                       disables the staging area.
+		explicit part_staging_area(std::size_t _max_bytes);
+
+		part_staging_area(const part_staging_area&) = delete;
+		auto operator=(const part_staging_area&) -> part_staging_area& = delete;
+
+		~part_staging_area() = default;
+
+		auto enabled() const noexcept -> bool
+		{
+			return max_bytes_ > 0;
+		} // enabled
+
+		/// Reserves memory for a part of \p _size bytes. The memory is not initialized.
+		///
+		/// \return The memory, or a null pointer if the staging area does not have room for it.
+		auto allocate(std::size_t _size) -> std::unique_ptr<staged_part>;
+
+		/// Stages a part which has been received completely. A part staged earlier under the same
+		/// upload ID and part number is replaced.
+		auto insert(const std::string& _upload_id, unsigned int _part_number, std::unique_ptr<staged_part> _part)
+			-> void;
+
+		/// Returns the numbers of the staged parts of an upload, in ascending order.
+		auto part_numbers(const std::string& _upload_id) const -> std::vector<unsigned int>;
+
+		/// Removes a part so that it can be written to iRODS. The part is counted as in flight
+		/// until release() or restore() is called.
+		///
+		/// \return The part, or a null pointer if the part is not staged.
+		auto take(const std::string& _upload_id, unsigned int _part_number) -> std::unique_ptr<staged_part>;
+
+		/// Ends the flight of a part which has been written to iRODS.
+		auto release(const std::string& _upload_id) -> void;
+
+		/// Ends the flight of a part which could not be written to iRODS and stages it again,
+		/// unless a newer copy of the part has been staged in the meantime.
+		auto restore(const std::string& _upload_id, unsigned int _part_number, std::unique_ptr<staged_part> _part)
+			-> void;
+
+		/// Removes all staged parts of an upload, unless one of its parts is in flight.
+		///
+		/// \param[in] _on_idle If a part is in flight, called once no part of the upload is in
+		///                     flight anymore, or once the upload is erased. It is called by the
+		///                     thread which ends the flight of the last part, without holding a
+		///                     lock of the staging area.
+		///
+		/// \return The staged parts of the upload, keyed on part number, or an empty std::optional
+		///         if a part is in flight.
+		auto try_take_all(const std::string& _upload_id, std::function<void()> _on_idle = {})
+			-> std::optional<std::map<unsigned int, std::unique_ptr<staged_part>>>;
+
+		/// Discards the staged parts of an upload.
+		auto erase(const std::string& _upload_id) -> void;
+
+		auto to_json() const -> nlohmann::json;
+
+	  private:
+		friend class staged_part;
+
+		struct upload_type
+		{
+			std::map<unsigned int, std::unique_ptr<staged_part>> parts;
+			std::size_t in_flight = 0;
+
+			// The callbacks passed to try_take_all while a part was in flight.
+			std::vector<std::function<void()>> idle_waiters;
+		}; // struct upload_type
+
+		// Ends the flight of a part. Returns the callbacks to call once the mutex is released. The
+		// mutex must be held.
+		static auto end_flight(upload_type& _upload) -> std::vector<std::function<void()>>;
+
+		// Removes the entry of an upload once it holds no parts. The mutex must be held.
+		auto erase_if_idle(std::unordered_map<std::string, upload_type>::iterator _iter) -> void;
+
+		auto deallocate(char* _data, std::size_t _size) noexcept -> void;
+
+		const std::size_t max_bytes_;
+
+		std::atomic<std::uint64_t> used_bytes_{};
+		std::atomic<std::uint64_t> staged_parts_total_{}; // The parts ever allocated.
+		std::atomic<std::uint64_t> rejected_parts_{};
+
+		// Declared after the counters, which the parts update when they are destroyed.
+		mutable std::mutex mtx_;
+		std::unordered_map<std::string, upload_type> uploads_;
+	}; // class part_staging_area
+} // namespace irods::s3
+
+#endif // IRODS_S3_API_PART_STAGING_AREA_HPP
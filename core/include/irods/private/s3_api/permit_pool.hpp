@@ -0,0 +1,101 @@
+#ifndef IRODS_S3_API_PERMIT_POOL_HPP
+#define IRODS_S3_API_PERMIT_POOL_HPP
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace irods::http
+{
+	/// A fixed number of permits shared by coroutines which must not all run at once.
+	///
+	/// CompleteMultipartUpload writes the parts of an upload through several streams, each with
+	/// its own iRODS connection. Without a bound across uploads, many concurrent completions would
+	/// open many times that number of connections. A part writer holds a permit while its stream
+	/// is open. Coroutines waiting for a permit are suspended, so they do not hold a thread.
+	///
+	/// Permits are handed out in the order in which they were requested.
+	///
+	/// async_acquire() must be called from a strand or from a single-threaded executor. The other
+	/// member functions are thread-safe.
+	class permit_pool
+	{
+	  public:
+		/// A permit on loan from the pool. The permit is returned to the pool on destruction.
+		class permit
+		{
+		  public:
+			permit() = default;
+
+			permit(permit&& _other) noexcept;
+			auto operator=(permit&& _other) noexcept -> permit&;
+
+			permit(const permit&) = delete;
+			auto operator=(const permit&) -> permit& = delete;
+
+			~permit();
+
+			explicit operator bool() const noexcept
+			{
+				return pool_ != nullptr;
+			} // operator bool
+
+		  private:
+			friend class permit_pool;
+
+			explicit permit(permit_pool& _pool);
+
+			auto release() noexcept -> void;
+
+			permit_pool* pool_{};
+		}; // class permit
+
+		/// \param[in] _size The number of permits. Must be greater than 0.
+		explicit permit_pool(std::size_t _size);
+
+		permit_pool(const permit_pool&) = delete;
+		auto operator=(const permit_pool&) -> permit_pool& = delete;
+
+		~permit_pool() = default;
+
+		/// Returns a permit, waiting for one to be returned if none is available.
+		auto async_acquire() -> boost::asio::awaitable<permit>;
+
+		auto to_json() const -> nlohmann::json;
+
+	  private:
+		struct waiter
+		{
+			explicit waiter(const boost::asio::any_io_executor& _executor);
+
+			boost::asio::steady_timer timer;
+			bool granted = false; // Protected by the mutex of the pool.
+		}; // struct waiter
+
+		// Hands a returned permit to the first waiter, or makes it available.
+		auto release() noexcept -> void;
+
+		// Gives up the place of a waiter whose coroutine is destroyed while it waits.
+		auto abandon(const std::shared_ptr<waiter>& _waiter) noexcept -> void;
+
+		const std::size_t size_;
+
+		std::atomic<std::uint64_t> acquired_total_{};
+		std::atomic<std::uint64_t> waits_total_{}; // The permits which were not available at once.
+
+		mutable std::mutex mtx_;
+		std::size_t available_;
+		std::deque<std::shared_ptr<waiter>> waiters_;
+	}; // class permit_pool
+} // namespace irods::http
+
+#endif // IRODS_S3_API_PERMIT_POOL_HPP
@@ -0,0 +1,82 @@
+#ifndef IRODS_S3_API_REQUEST_CONTEXT_HPP
+#define IRODS_S3_API_REQUEST_CONTEXT_HPP
+
+#include "irods/private/s3_api/router.hpp"
+
+#include <irods/filesystem/path.hpp>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#include <boost/beast/http/parser.hpp>
+#pragma GCC diagnostic pop
+
+#include <boost/url.hpp>
+
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace irods::http
+{
+	/// Holds everything derived from the request header.
+	///
+	/// A context is created once per request by the session, after the header has been read,
+	/// and is moved into the task which runs the handler. It owns the parser, so the header
+	/// fields remain valid for as long as the handler needs them, independent of the session
+	/// reading the next request.
+	///
+	/// A context is not thread-safe. It must only be used by one thread at a time.
+	class request_context
+	{
+	  public:
+		using parser_type = boost::beast::http::request_parser<boost::beast::http::empty_body>;
+
+		request_context(parser_type&& _parser, route&& _route);
+
+		request_context(const request_context&) = delete;
+		auto operator=(const request_context&) -> request_context& = delete;
+
+		auto op() const noexcept -> operation
+		{
+			return op_;
+		} // op
+
+		auto parser() noexcept -> parser_type&
+		{
+			return parser_;
+		} // parser
+
+		auto header() const noexcept -> const request_type&
+		{
+			return parser_.get();
+		} // header
+
+		auto url() const noexcept -> const boost::urls::url&
+		{
+			return url_;
+		} // url
+
+		/// The percent-decoded path of the request.
+		auto path() const noexcept -> const std::string&
+		{
+			return path_;
+		} // path
+
+		/// The collection mapped to the bucket named by the first path segment.
+		///
+		/// The bucket mapping plugin is consulted on the first call only.
+		auto bucket() -> const std::optional<irods::experimental::filesystem::path>&;
+
+	  private:
+		parser_type parser_;
+		operation op_;
+		boost::urls::url url_;
+		std::string path_;
+		bool bucket_resolved_;
+		std::optional<irods::experimental::filesystem::path> bucket_;
+	}; // class request_context
+
+	using request_context_pointer = std::shared_ptr<request_context>;
+} // namespace irods::http
+
+#endif // IRODS_S3_API_REQUEST_CONTEXT_HPP
@@ -0,0 +1,86 @@
+#ifndef IRODS_S3_API_ROUTER_HPP
+#define IRODS_S3_API_ROUTER_HPP
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-but-set-variable"
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/message.hpp>
+#include <boost/beast/http/verb.hpp>
+#pragma GCC diagnostic pop
+
+#include <boost/url.hpp>
+
+#include <cstdint>
+#include <string_view>
+
+namespace irods::http
+{
+	using request_type = boost::beast::http::request<boost::beast::http::empty_body>;
+
+	/// The S3 operations the router is able to identify.
+	enum class operation : std::uint8_t
+	{
+		unsupported,
+		list_buckets,
+		list_objects_v2,
+		list_multipart_uploads,
+		list_parts,
+		list_distributions,
+		get_bucket_location,
+		get_object_lock_configuration,
+		get_object_tagging,
+		get_bucket_versioning,
+		get_object,
+		copy_object,
+		put_object,
+		delete_bucket,
+		abort_multipart_upload,
+		delete_object_tagging,
+		delete_object,
+		head_bucket,
+		head_object,
+		delete_objects,
+		complete_multipart_upload,
+		create_multipart_upload
+	}; // enum class operation
+
+	/// Returns the S3 name of an operation (e.g. "GetObject").
+	auto to_string(operation _op) noexcept -> std::string_view;
+
+	/// The result of routing a request.
+	///
+	/// The URL is parsed and decoded exactly once by the router. Handlers receive the same
+	/// object instead of parsing the request target again.
+	struct route
+	{
+		operation op;
+		boost::urls::url url;
+	}; // struct route
+
+	/// Builds a URL from the Host header and target of a request.
+	///
+	/// The path is percent-decoded. The query string is kept in its encoded form.
+	///
+	/// \param[in]  _request The request header.
+	/// \param[out] _url     The URL to populate.
+	auto parse_url(const request_type& _request, boost::urls::url& _url) -> void;
+
+	/// Identifies the S3 operation of a request whose URL has already been parsed.
+	///
+	/// This function does not allocate and does not depend on any global state.
+	///
+	/// \param[in] _method          The HTTP method of the request.
+	/// \param[in] _url             The parsed URL of the request.
+	/// \param[in] _target          The raw request target.
+	/// \param[in] _has_copy_source Whether the request carries an x-amz-copy-source header.
+	auto resolve_operation(
+		boost::beast::http::verb _method,
+		const boost::urls::url_view& _url,
+		std::string_view _target,
+		bool _has_copy_source) noexcept -> operation;
+
+	/// Parses the URL of a request and identifies its S3 operation in a single pass.
+	auto resolve_route(const request_type& _request) -> route;
+} // namespace irods::http
+
+#endif // IRODS_S3_API_ROUTER_HPP
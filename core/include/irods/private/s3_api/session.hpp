@@ -2,12 +2,20 @@
 #define IRODS_S3_API_SESSION_HPP
 
 #include "irods/private/s3_api/common.hpp"
+#include "irods/private/s3_api/request_context.hpp"
+#include "irods/private/s3_api/router.hpp"
 
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/dispatch.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <utility>
 
 namespace irods::http
 {
@@ -33,23 +41,63 @@ namespace irods::http
 			return stream_;
 		} // stream
 
+		// Restarts the timer which guards socket operations on the stream. Handlers which
+		// transfer large bodies call this before each operation so that a transfer is not
+		// bounded by the timeout set when the request header was read.
+		auto refresh_timeout() -> void
+		{
+			stream_.expires_after(std::chrono::seconds(timeout_in_secs_));
+		} // refresh_timeout
+
+		/// Sends the interim "100 Continue" response if the current request asked for it (i.e.
+		/// Expect: 100-continue) and it has not been sent yet.
+		///
+		/// Clients which send this header withhold the body until they receive the interim
+		/// response. Handlers call this once the request is known to be acceptable (e.g. it is
+		/// authenticated and its bucket exists) and right before reading the body, so that the
+		/// body of a rejected request is never transferred.
+		///
+		/// Must be called on the session's strand.
+		auto async_send_continue() -> boost::asio::awaitable<boost::beast::error_code>;
+
+		/// Records that the response to the current request has been started. send() does this
+		/// itself. Handlers which write their response to the stream directly (e.g. GetObject)
+		/// call this before writing the header.
+		auto mark_response_started() noexcept -> void
+		{
+			responses_started_.fetch_add(1, std::memory_order_relaxed);
+		} // mark_response_started
+
 		template <bool isRequest, class Body, class Fields>
 		auto send(boost::beast::http::message<isRequest, Body, Fields>&& msg) -> void
 		{
 			namespace http = boost::beast::http;
 
+			mark_response_started();
+
 			// The lifetime of the message has to extend
 			// for the duration of the async operation so
 			// we use a shared_ptr to manage it.
 			auto sp = std::make_shared<http::message<isRequest, Body, Fields>>(std::move(msg));
 
-			// Store a type-erased version of the shared
-			// pointer in the class to keep it alive.
-			res_ = sp;
-
-			// Write the response.
-			http::async_write(
-				stream_, *sp, boost::beast::bind_front_handler(&session::on_write, shared_from_this(), sp->need_eof()));
+			// Responses may be produced on the background thread pool. The write is always
+			// initiated on the session's strand.
+			boost::asio::dispatch(stream_.get_executor(), [self = shared_from_this(), sp = std::move(sp)] {
+				// The client was never asked for the body of the request, so it may or may not
+				// send it. Close the connection rather than parse the body as the next request.
+				if (std::exchange(self->continue_pending_, false)) {
+					sp->keep_alive(false);
+				}
+
+				// Store a type-erased version of the shared
+				// pointer in the class to keep it alive.
+				self->res_ = sp;
+
+				// Write the response.
+				self->refresh_timeout();
+				http::async_write(
+					self->stream_, *sp, boost::beast::bind_front_handler(&session::on_write, self, sp->need_eof()));
+			});
 		} // send
 
 		boost::beast::flat_buffer& get_buffer()
@@ -58,6 +106,15 @@ namespace irods::http
 		}
 
 	  private:
+		using handler_type = boost::asio::awaitable<void> (*)(session_pointer_type, request_context_pointer);
+
+		// Launches the handler as a coroutine on the session's strand. The parser and the URL
+		// parsed by the router are moved into a request_context owned by the coroutine, so the
+		// handler never needs to parse the URL again and never observes the parser of a
+		// subsequent request. Handlers offload blocking iRODS calls to the background thread
+		// pool themselves (see offload.hpp).
+		auto dispatch(route&& _route, handler_type _handler) -> void;
+
 		boost::beast::tcp_stream stream_;
 		boost::beast::flat_buffer buffer_;
 		std::optional<boost::beast::http::request_parser<boost::beast::http::empty_body>> parser_;
@@ -65,6 +122,15 @@ namespace irods::http
 		                            // available for the lifetime of the request.
 		const int max_body_size_;
 		const int timeout_in_secs_;
+
+		// True while the current request is waiting for "100 Continue". See async_send_continue.
+		bool continue_pending_ = false;
+
+		// The number of requests read, and the number of responses started. Requests on a session
+		// are handled one at a time, so a handler which fails before starting its response leaves
+		// fewer responses than requests.
+		std::uint64_t requests_received_ = 0;
+		std::atomic<std::uint64_t> responses_started_{};
 	}; // class session
 } // namespace irods::http
 
@@ -0,0 +1,110 @@
+#ifndef IRODS_S3_API_SIGNING_KEY_CACHE_HPP
+#define IRODS_S3_API_SIGNING_KEY_CACHE_HPP
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace irods::s3::authentication
+{
+	/// A bounded, thread-safe cache of SigV4 signing keys.
+	///
+	/// A signing key only depends on the secret key, the date, and the region of the credential
+	/// scope. Entries are keyed on the access key ID, date, and region, and hold the signing key
+	/// along with the iRODS username mapped to the access key ID. This allows a request to be
+	/// authenticated without calling into the user mapping plugin or deriving the signing key.
+	///
+	/// Every entry records the generation of the user mapping it was derived from. An entry is
+	/// ignored and removed once the generation changes or the date of the entry has passed.
+	///
+	/// The cache is split into shards, each with its own lock, to reduce contention.
+	class signing_key_cache
+	{
+	  public:
+		using clock_type = std::chrono::system_clock;
+
+		struct entry
+		{
+			std::string irods_username;
+			std::string signing_key;
+		}; // struct entry
+
+		/// \param[in] _capacity The maximum number of entries. A capacity of 0 disables the cache.
+		explicit signing_key_cache(std::size_t _capacity);
+
+		signing_key_cache(const signing_key_cache&) = delete;
+		auto operator=(const signing_key_cache&) -> signing_key_cache& = delete;
+
+		auto enabled() const noexcept -> bool
+		{
+			return capacity_per_shard_ > 0;
+		} // enabled
+
+		/// Returns the entry for the credential scope if it is present and still valid.
+		auto find(
+			std::string_view _access_key_id,
+			std::string_view _date,
+			std::string_view _region,
+			std::uint64_t _generation,
+			clock_type::time_point _now = clock_type::now()) -> std::optional<entry>;
+
+		/// Adds or replaces the entry for the credential scope.
+		///
+		/// Nothing is added if \p _date is not a valid date in the form YYYYMMDD or has already
+		/// passed.
+		auto insert(
+			std::string_view _access_key_id,
+			std::string_view _date,
+			std::string_view _region,
+			std::uint64_t _generation,
+			entry _entry,
+			clock_type::time_point _now = clock_type::now()) -> void;
+
+		auto to_json() const -> nlohmann::json;
+
+	  private:
+		static constexpr std::size_t shard_count = 16;
+
+		struct value
+		{
+			entry data;
+			std::uint64_t generation;
+			clock_type::time_point expires_at;
+		}; // struct value
+
+		struct shard_type
+		{
+			std::mutex mtx;
+			std::unordered_map<std::string, value> entries;
+		}; // struct shard_type
+
+		static auto make_key(std::string_view _access_key_id, std::string_view _date, std::string_view _region)
+			-> std::string;
+
+		auto shard_for(const std::string& _key) -> shard_type&;
+
+		const std::size_t capacity_per_shard_;
+		std::array<shard_type, shard_count> shards_;
+		std::atomic<std::uint64_t> hits_{};
+		std::atomic<std::uint64_t> misses_{};
+	}; // class signing_key_cache
+
+	/// Returns the time at which signing keys for \p _date expire (i.e. midnight UTC at the end
+	/// of the date).
+	///
+	/// \param[in] _date A date in the form YYYYMMDD.
+	///
+	/// \return The expiration time, or an empty std::optional if \p _date is invalid.
+	auto signing_key_expiration(std::string_view _date) -> std::optional<std::chrono::system_clock::time_point>;
+} // namespace irods::s3::authentication
+
+#endif // IRODS_S3_API_SIGNING_KEY_CACHE_HPP
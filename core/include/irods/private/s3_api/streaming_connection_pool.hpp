@@ -0,0 +1,127 @@
+#ifndef IRODS_S3_API_STREAMING_CONNECTION_POOL_HPP
+#define IRODS_S3_API_STREAMING_CONNECTION_POOL_HPP
+
+#include <irods/client_connection.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace irods::http
+{
+	struct streaming_connection_pool_options
+	{
+		std::string host;
+		int port{};
+		std::string zone;
+		std::string proxy_username;
+		std::string proxy_password;
+
+		// The maximum number of idle connections kept by the pool.
+		std::size_t size{};
+
+		// Connections older than this are disconnected instead of being handed out again.
+		std::chrono::seconds refresh_timeout{};
+
+		// When true, rc_switch_user is not available. Every request is given a new connection
+		// and connections are never reused.
+		bool enable_4_2_compatibility{};
+	}; // struct streaming_connection_pool_options
+
+	/// A pool of authenticated iRODS connections for data transfers (i.e. GetObject and PutObject).
+	///
+	/// Connections are handed out as std::shared_ptr. When the last reference is released, the
+	/// connection is returned to the pool rather than disconnected. This allows a connection to
+	/// be held for the lifetime of an asynchronous transfer, which may span several requests
+	/// (e.g. multipart uploads).
+	///
+	/// Unlike irods::connection_pool, this pool never blocks waiting for a connection to be
+	/// returned. If no idle connection is available, a new one is created. This keeps long-running
+	/// transfers from starving each other or the other endpoints.
+	///
+	/// An idle connection which already acts on behalf of the requested user is preferred, so that
+	/// rc_switch_user can be skipped. This is only safe if no replica is left open on the
+	/// connection. A connection is therefore considered to have replicas left open until its user
+	/// calls mark_streams_closed(). When such a connection is returned to the pool, its open
+	/// replicas are closed before it becomes idle.
+	///
+	/// This class is thread-safe.
+	class streaming_connection_pool
+	{
+	  public:
+		using connection_pointer = std::shared_ptr<irods::experimental::client_connection>;
+
+		explicit streaming_connection_pool(streaming_connection_pool_options _options);
+
+		streaming_connection_pool(const streaming_connection_pool&) = delete;
+		auto operator=(const streaming_connection_pool&) -> streaming_connection_pool& = delete;
+
+		~streaming_connection_pool() = default;
+
+		/// Returns a connection which acts on behalf of \p _username.
+		///
+		/// An idle connection is reused when possible. Its identity is changed using rc_switch_user.
+		/// This is a blocking operation.
+		///
+		/// \throws irods::exception If a connection could not be established.
+		auto get_connection(const std::string& _username) -> connection_pointer;
+
+		/// Records that every stream opened on \p _conn has been closed successfully, or that no
+		/// stream was opened on it. Call it only once no further stream will be opened through
+		/// this handle.
+		static auto mark_streams_closed(const connection_pointer& _conn) noexcept -> void;
+
+	  private:
+		using clock_type = std::chrono::steady_clock;
+
+		// Returns a pooled connection to the pool once the last reference to it is released.
+		class connection_deleter
+		{
+		  public:
+			connection_deleter(streaming_connection_pool& _pool, clock_type::time_point _created_at);
+
+			connection_deleter(const connection_deleter& _other);
+			auto operator=(const connection_deleter&) -> connection_deleter& = delete;
+
+			~connection_deleter() = default;
+
+			auto operator()(irods::experimental::client_connection* _conn) -> void;
+
+			auto mark_streams_closed() noexcept -> void
+			{
+				streams_closed_.store(true, std::memory_order_release);
+			} // mark_streams_closed
+
+		  private:
+			streaming_connection_pool* pool_;
+			clock_type::time_point created_at_;
+			std::atomic<bool> streams_closed_{false};
+		}; // class connection_deleter
+
+		struct idle_connection
+		{
+			std::unique_ptr<irods::experimental::client_connection> conn;
+			clock_type::time_point created_at;
+		}; // struct idle_connection
+
+		auto connect(const std::string& _username) -> std::unique_ptr<irods::experimental::client_connection>;
+
+		auto make_pointer(std::unique_ptr<irods::experimental::client_connection> _conn, clock_type::time_point _created_at)
+			-> connection_pointer;
+
+		auto release(
+			std::unique_ptr<irods::experimental::client_connection> _conn,
+			clock_type::time_point _created_at,
+			bool _streams_closed) -> void;
+
+		const streaming_connection_pool_options options_;
+		std::mutex mtx_;
+		std::vector<idle_connection> idle_;
+	}; // class streaming_connection_pool
+} // namespace irods::http
+
+#endif // IRODS_S3_API_STREAMING_CONNECTION_POOL_HPP
@@ -0,0 +1,61 @@
+#ifndef IRODS_S3_API_UNIFORM_PART_LAYOUT_HPP
+#define IRODS_S3_API_UNIFORM_PART_LAYOUT_HPP
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+namespace irods::s3
+{
+	/// Predicts the offsets of the parts of a multipart upload whose parts share one size.
+	///
+	/// Most clients upload parts of equal size, except for the last one. Given that size, the
+	/// offset of part N is (N - 1) * part_size, so a part can be written to iRODS as soon as it
+	/// arrives, even if the parts preceding it have not.
+	///
+	/// Writing a part at a predicted offset assumes that every part preceding it has the shared
+	/// size. The layout remembers the largest part written under that assumption. A part which
+	/// turns out to have a different size contradicts the assumption if it precedes that part,
+	/// in which case the object cannot be assembled and the part must be rejected.
+	///
+	/// This class is not thread-safe.
+	class uniform_part_layout
+	{
+	  public:
+		explicit uniform_part_layout(std::uint64_t _part_size) noexcept
+			: part_size_{_part_size}
+		{
+		} // constructor
+
+		auto part_size() const noexcept -> std::uint64_t
+		{
+			return part_size_;
+		} // part_size
+
+		/// Records the size of a part.
+		///
+		/// \return false if the size contradicts the offset predicted for a part written earlier.
+		auto record_part_size(unsigned int _part_number, std::uint64_t _size) noexcept -> bool;
+
+		/// Returns the offset of a part, assuming that every part preceding it has the shared size,
+		/// and records the assumption.
+		///
+		/// \return The offset, or an empty std::optional if a preceding part is known to have a
+		///         different size.
+		auto predict_offset(unsigned int _part_number) noexcept -> std::optional<std::uint64_t>;
+
+		/// Returns the largest part number whose offset was predicted, or 0 if there is none.
+		/// Every part preceding it must have the shared size.
+		auto last_predicted_part() const noexcept -> unsigned int
+		{
+			return last_predicted_part_;
+		} // last_predicted_part
+
+	  private:
+		std::uint64_t part_size_;
+		unsigned int last_predicted_part_ = 0;
+		unsigned int first_irregular_part_ = std::numeric_limits<unsigned int>::max();
+	}; // class uniform_part_layout
+} // namespace irods::s3
+
+#endif // IRODS_S3_API_UNIFORM_PART_LAYOUT_HPP
@@ -1,8 +1,12 @@
 #include "irods/private/s3_api/authentication.hpp"
 
+#include "irods/private/s3_api/aws_chunked_decoder.hpp"
+#include "irods/private/s3_api/canonical_request.hpp"
+#include "irods/private/s3_api/configuration.hpp"
 #include "irods/private/s3_api/globals.hpp"
 #include "irods/private/s3_api/hmac.hpp"
 #include "irods/private/s3_api/log.hpp"
+#include "irods/private/s3_api/signing_key_cache.hpp"
 #include "irods/s3_api/plugins/user_mapping/user_mapping.h"
 
 #include <irods/rcMisc.h>
@@ -14,34 +18,12 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <ctime>
-#include <iomanip>
-#include <iostream>
 #include <sstream>
 
 namespace
 {
-	std::string uri_encode(const std::string_view sv)
-	{
-		std::stringstream s;
-		std::ios state(nullptr);
-		state.copyfmt(s);
-		for (auto c : sv) {
-			bool encode = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
-			              boost::is_any_of("-_~.")(c);
-			if (!encode) {
-				// Interestingly, most hex-encoded values in the amazon api tend to be lower case,
-				// except for this.
-				s << '%' << std::uppercase << std::hex << std::setw(2) << std::setfill('0') << (int) c;
-				s.copyfmt(state);
-			}
-			else {
-				s << c;
-			}
-		}
-		return s.str();
-	}
-
 	std::string
 	get_user_signing_key(const std::string_view secret_key, const std::string_view date, const std::string_view region)
 	{
@@ -53,148 +35,27 @@ namespace
 		return irods::s3::authentication::hmac_sha_256(date_region_service_key, "aws4_request");
 	}
 
-	// TODO we can improve performance by reusing the same stringstream where possible.
-
-	// Turn the url into the 'canon form'
-	std::string canonicalize_url(const boost::urls::url_view& url)
+	// Returns the generation of the user mapping, or an empty std::optional if the user mapping
+	// plugin cannot provide it. Signing keys are only cached if the generation is available.
+	auto get_user_mapping_generation() -> std::optional<std::uint64_t>
 	{
-		namespace logging = irods::http::logging;
-		std::stringstream result;
-		logging::debug("{}:{} ({}) url={}", __FILE__, __LINE__, __func__, url.path());
-		for (const auto i : url.segments()) {
-			result << '/' << uri_encode(i);
-		}
-		return result.str();
-	}
-
-	std::string to_lower(const std::string_view sv)
-	{
-		std::string r;
-		for (auto i : sv) {
-			r.push_back(tolower(i));
-		}
-		return r;
-	}
-	std::string canonicalize_request(
-		const boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		const boost::urls::url_view& url,
-		const std::vector<std::string>& signed_headers)
-	{
-		namespace logging = irods::http::logging;
-
-		// At various points the signature process wants various fields to be sorted.
-		// so reusing this can at least avoid some of the duplicate allocations and such
-		std::vector<std::string_view> sorted_fields;
-
-		std::stringstream result;
-
-		std::ios state(nullptr);
-		state.copyfmt(result);
-
-		// HTTP Verb
-		result << parser.get().method_string() << '\n';
-		result.copyfmt(result); // re store former formatting
-
-		// Canonical URI
-		result << canonicalize_url(url) << '\n';
-
-		// Canonical Query String
-		{
-			bool first = true;
-			// Changing it to a pair enables us to sort easily.
-			std::vector<std::pair<std::string, std::string>> params;
-			std::transform(
-				url.encoded_params().begin(),
-				url.encoded_params().end(),
-				std::back_inserter(params),
-				[](const auto& a) {
-					if (a.has_value) {
-						return std::pair<std::string, std::string>(a.key, a.value);
-					}
-					return std::pair<std::string, std::string>(a.key, "");
-				});
-			std::sort(params.begin(), params.end());
-			for (const auto& param : params) {
-				// Regarding Query Parameter-based authentication, the S3 documentation says the following:
-				// "The Canonical Query String must include all the query parameters from the preceding table except
-				// for X-Amz-Signature."
-				// Since signatures are not used in generating themselves, exclude them for all authentication types.
-				if ("X-Amz-Signature" == param.first) {
-					continue;
-				}
-
-				// The Query Parameters come from the URL, so they are already URI-encoded.
-				result << (first ? "" : "&") << param.first;
-				result << '=' << param.second;
-
-				first = false;
-			}
-		}
-		result << '\n';
-
-		// Canonical Headers
-		for (const auto& header : parser.get()) {
-			if (std::find(signed_headers.begin(), signed_headers.end(), to_lower(header.name_string())) !=
-			    signed_headers.end()) {
-				sorted_fields.emplace_back(header.name_string().data(), header.name_string().length());
-			}
-		}
-
-		std::sort(sorted_fields.begin(), sorted_fields.end(), [](const auto& lhs, const auto& rhs) {
-			const auto result = std::mismatch(
-				lhs.cbegin(),
-				lhs.cend(),
-				rhs.cbegin(),
-				rhs.cend(),
-				[](const unsigned char lhs, const unsigned char rhs) { return tolower(lhs) == tolower(rhs); });
-
-			return result.second != rhs.cend() &&
-			       (result.first == lhs.cend() || tolower(*result.first) < tolower(*result.second));
-		});
-		std::string fields_str;
-		for (auto& i : sorted_fields) {
-			fields_str += i;
-			fields_str += ",";
-		}
-		logging::debug(fields_str);
-		for (const auto& field : sorted_fields) {
-			auto val = static_cast<std::string>(parser.get().at(boost::string_view(field.data(), field.length())));
-			std::string key(field);
-			std::transform(key.begin(), key.end(), key.begin(), tolower);
-			boost::trim(val);
-			result << key << ':';
-			result.copyfmt(state);
-			result << val << '\n';
-		}
-		result << "\n";
+		auto& user_mapping = irods::http::globals::user_mapping_library();
 
-		sorted_fields.clear();
+		using T = decltype(user_mapping_generation);
+		static T* const um_generation =
+			user_mapping.has("user_mapping_generation") ? &user_mapping.get<T>("user_mapping_generation") : nullptr;
 
-		// Signed Headers
-		for (const auto& hd : signed_headers) {
-			sorted_fields.push_back(hd);
-		}
-		std::sort(sorted_fields.begin(), sorted_fields.end());
-		{
-			bool first = true;
-			for (const auto& i : sorted_fields) {
-				result << (first ? "" : ";") << i;
-				first = false;
-			}
-			result.copyfmt(state);
-			result << '\n';
+		if (!um_generation) {
+			return std::nullopt;
 		}
 
-		// Hashed Payload
-		if (auto req = parser.get().find("X-Amz-Content-SHA256"); req != parser.get().end()) {
-			result << req->value();
-		}
-		else {
-			result << "UNSIGNED-PAYLOAD";
+		std::uint64_t generation{};
+		if (um_generation(&generation) != 0) {
+			return std::nullopt;
 		}
 
-		return result.str();
-	}
+		return generation;
+	} // get_user_mapping_generation
 
 	auto request_is_expired(const std::string& signature_timestamp, const std::string& expiration_time) -> bool
 	{
@@ -248,6 +109,12 @@ namespace
 	} // request_is_expired
 } // namespace
 
+auto irods::s3::authentication::get_signing_key_cache() -> signing_key_cache&
+{
+	static signing_key_cache cache{irods::s3::get_signing_key_cache_size()};
+	return cache;
+} // get_signing_key_cache
+
 std::optional<std::string> irods::s3::authentication::get_iRODS_user(const std::string_view access_key)
 {
 	auto& user_mapping = irods::http::globals::user_mapping_library();
@@ -290,7 +157,8 @@ std::optional<std::string> irods::s3::authentication::get_user_secret_key(const
 
 std::optional<std::string> irods::s3::authentication::authenticates(
 	const boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-	const boost::urls::url_view& url)
+	const boost::urls::url_view& url,
+	chunk_signing_context* signing_context)
 {
 	namespace logging = irods::http::logging;
 
@@ -377,19 +245,46 @@ std::optional<std::string> irods::s3::authentication::authenticates(
 	const auto& date = credential_fields[1];
 	const auto& region = credential_fields[2];
 
-	const auto canonical_request = canonicalize_request(parser, url, signed_headers);
+	// The canonical request is only materialized when it is going to be logged.
+	std::string canonical_request;
+	const auto log_canonical_request = spdlog::should_log(spdlog::level::debug);
+	const auto canonical_request_hash =
+		hash_canonical_request(parser, url, signed_headers, log_canonical_request ? &canonical_request : nullptr);
 	logging::debug("========== Canon request ==========\n{}", canonical_request);
 
 	const auto sts = fmt::format(
-		"AWS4-HMAC-SHA256\n{}\n{}/{}/s3/aws4_request\n{}",
-		signature_timestamp,
-		date,
-		region,
-		irods::s3::authentication::hex_encode(irods::s3::authentication::hash_sha_256(canonical_request)));
+		"AWS4-HMAC-SHA256\n{}\n{}/{}/s3/aws4_request\n{}", signature_timestamp, date, region, canonical_request_hash);
 
 	logging::debug("======== String to sign ===========\n{}", sts);
 	logging::debug("===================================");
 
+	// The cache can only be used if changes to the user mapping can be detected.
+	auto& cache = get_signing_key_cache();
+	const auto generation = cache.enabled() ? get_user_mapping_generation() : std::nullopt;
+
+	if (generation) {
+		if (auto entry = cache.find(access_key_id, date, region, *generation); entry) {
+			logging::trace("Found cached signing key for access_key_id={}", access_key_id);
+			const auto computed_signature = hex_encode(hmac_sha_256(entry->signing_key, sts));
+			logging::debug("Computed: [{}]", computed_signature);
+			logging::debug("Actual Signature: [{}]", signature);
+
+			if (computed_signature != signature) {
+				return std::nullopt;
+			}
+
+			if (signing_context) {
+				*signing_context = {
+					std::move(entry->signing_key),
+					signature_timestamp,
+					fmt::format("{}/{}/s3/aws4_request", date, region),
+					std::move(signature)};
+			}
+
+			return std::move(entry->irods_username);
+		}
+	}
+
 	logging::trace("Searching for user with access_key_id={}", access_key_id);
 	auto irods_user = irods::s3::authentication::get_iRODS_user(access_key_id);
 
@@ -408,5 +303,23 @@ std::optional<std::string> irods::s3::authentication::authenticates(
 
 	logging::debug("Actual Signature: [{}]", signature);
 
-	return (computed_signature == signature) ? irods_user : std::nullopt;
+	if (computed_signature != signature) {
+		return std::nullopt;
+	}
+
+	// Only cache signing keys which have been used successfully. This keeps requests with bogus
+	// credential scopes from displacing useful entries.
+	if (generation) {
+		cache.insert(access_key_id, date, region, *generation, {*irods_user, signing_key});
+	}
+
+	if (signing_context) {
+		*signing_context = {
+			std::move(signing_key),
+			signature_timestamp,
+			fmt::format("{}/{}/s3/aws4_request", date, region),
+			std::move(signature)};
+	}
+
+	return irods_user;
 } // irods::s3::authentication::authenticates
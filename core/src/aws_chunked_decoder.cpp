@@ -0,0 +1,414 @@
+#include "irods/private/s3_api/aws_chunked_decoder.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace
+{
+	// The SHA-256 hash of an empty string, in hexadecimal.
+	constexpr std::string_view empty_string_hash = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+
+	constexpr std::string_view chunk_signature_prefix = "chunk-signature=";
+
+	constexpr std::string_view trailer_signature_name = "x-amz-trailer-signature";
+
+	// Returns the value of a hexadecimal digit, or -1 if the character is not a hexadecimal digit.
+	auto hex_digit_value(char _c) noexcept -> int
+	{
+		if (_c >= '0' && _c <= '9') {
+			return _c - '0';
+		}
+
+		if (_c >= 'a' && _c <= 'f') {
+			return _c - 'a' + 10;
+		}
+
+		if (_c >= 'A' && _c <= 'F') {
+			return _c - 'A' + 10;
+		}
+
+		return -1;
+	} // hex_digit_value
+
+	auto to_lower(char _c) noexcept -> char
+	{
+		return (_c >= 'A' && _c <= 'Z') ? static_cast<char>(_c - 'A' + 'a') : _c;
+	} // to_lower
+
+	auto trim(std::string_view _sv) noexcept -> std::string_view
+	{
+		constexpr std::string_view whitespace = " \t";
+
+		const auto first = _sv.find_first_not_of(whitespace);
+		if (first == std::string_view::npos) {
+			return {};
+		}
+
+		return _sv.substr(first, _sv.find_last_not_of(whitespace) - first + 1);
+	} // trim
+
+	// Returns the value of the chunk-signature extension, or an empty string view if it is not
+	// present. The extensions have the form: name1=value1;name2=value2
+	auto find_chunk_signature(std::string_view _extensions) noexcept -> std::string_view
+	{
+		while (!_extensions.empty()) {
+			const auto end = _extensions.find(';');
+			const auto extension = _extensions.substr(0, end);
+
+			if (extension.substr(0, chunk_signature_prefix.size()) == chunk_signature_prefix) {
+				return extension.substr(chunk_signature_prefix.size());
+			}
+
+			if (end == std::string_view::npos) {
+				break;
+			}
+
+			_extensions.remove_prefix(end + 1);
+		}
+
+		return {};
+	} // find_chunk_signature
+} // anonymous namespace
+
+namespace irods::s3
+{
+	aws_chunked_decoder::aws_chunked_decoder(chunk_signing_context _context, authentication::digest_backend _backend)
+		: signing_context_{std::move(_context)}
+		, backend_{_backend}
+		, previous_signature_{signing_context_->seed_signature}
+	{
+	} // constructor
+
+	auto aws_chunked_decoder::next(std::string_view& _input) -> std::string_view
+	{
+		while (!_input.empty()) {
+			switch (state_) {
+				case state::chunk_size: {
+					const auto c = _input.front();
+
+					if (const auto value = hex_digit_value(c); value >= 0) {
+						// 16 hexadecimal digits is the most that fits in 64 bits.
+						if (chunk_size_digits_ == 16) {
+							return fail(error_code::chunk_size_too_large);
+						}
+
+						chunk_size_ = (chunk_size_ << 4) | static_cast<std::uint64_t>(value);
+						++chunk_size_digits_;
+					}
+					else if (c == ';' && chunk_size_digits_ > 0) {
+						state_ = state::chunk_extensions;
+					}
+					else if (c == '\r' && chunk_size_digits_ > 0) {
+						state_ = state::chunk_header_lf;
+					}
+					else {
+						return fail(error_code::malformed_chunk_header);
+					}
+
+					++chunk_header_size_;
+					_input.remove_prefix(1);
+					break;
+				}
+
+				case state::chunk_extensions: {
+					const auto cr = _input.find('\r');
+					const auto extensions = _input.substr(0, cr);
+
+					chunk_header_size_ += extensions.size();
+					if (chunk_header_size_ > max_chunk_header_size) {
+						return fail(error_code::chunk_header_too_long);
+					}
+
+					chunk_extensions_.append(extensions);
+					_input.remove_prefix(extensions.size());
+
+					if (cr != std::string_view::npos) {
+						state_ = state::chunk_header_lf;
+						_input.remove_prefix(1);
+					}
+					break;
+				}
+
+				case state::chunk_header_lf:
+					if (_input.front() != '\n') {
+						return fail(error_code::malformed_chunk_header);
+					}
+
+					_input.remove_prefix(1);
+					on_chunk_header_complete();
+					break;
+
+				case state::chunk_data: {
+					const auto size = static_cast<std::size_t>(std::min<std::uint64_t>(chunk_bytes_remaining_, _input.size()));
+					const auto payload = _input.substr(0, size);
+
+					_input.remove_prefix(size);
+					chunk_bytes_remaining_ -= size;
+					payload_size_ += size;
+
+					if (chunk_hasher_) {
+						chunk_hasher_->update(payload);
+					}
+
+					if (chunk_bytes_remaining_ == 0) {
+						state_ = state::chunk_data_cr;
+					}
+
+					return payload;
+				}
+
+				case state::chunk_data_cr:
+					if (_input.front() != '\r') {
+						return fail(error_code::malformed_chunk_terminator);
+					}
+
+					_input.remove_prefix(1);
+					state_ = state::chunk_data_lf;
+					break;
+
+				case state::chunk_data_lf:
+					if (_input.front() != '\n') {
+						return fail(error_code::malformed_chunk_terminator);
+					}
+
+					_input.remove_prefix(1);
+
+					if (!verify_chunk_signature()) {
+						return fail(error_code::signature_mismatch);
+					}
+
+					state_ = state::chunk_size;
+					break;
+
+				case state::trailer_line: {
+					const auto cr = _input.find('\r');
+					const auto line = _input.substr(0, cr);
+
+					trailer_size_ += line.size();
+					if (trailer_size_ > max_trailer_size) {
+						return fail(error_code::trailer_too_long);
+					}
+
+					trailer_line_.append(line);
+					_input.remove_prefix(line.size());
+
+					if (cr != std::string_view::npos) {
+						state_ = state::trailer_lf;
+						_input.remove_prefix(1);
+					}
+					break;
+				}
+
+				case state::trailer_lf:
+					if (_input.front() != '\n') {
+						return fail(error_code::malformed_trailer);
+					}
+
+					_input.remove_prefix(1);
+					on_trailer_line_complete();
+
+					if (state_ == state::done) {
+						return {};
+					}
+					break;
+
+				case state::done:
+				case state::failed:
+					return {};
+			}
+
+			if (state_ == state::failed) {
+				return {};
+			}
+		}
+
+		return {};
+	} // next
+
+	auto aws_chunked_decoder::fail(error_code _ec) -> std::string_view
+	{
+		state_ = state::failed;
+		error_ = _ec;
+		return {};
+	} // fail
+
+	auto aws_chunked_decoder::on_chunk_header_complete() -> void
+	{
+		chunk_signature_ = find_chunk_signature(chunk_extensions_);
+
+		if (signing_context_) {
+			if (chunk_signature_.empty()) {
+				fail(error_code::missing_chunk_signature);
+				return;
+			}
+
+			chunk_hasher_.emplace(backend_);
+		}
+
+		chunk_bytes_remaining_ = chunk_size_;
+
+		if (chunk_size_ > 0) {
+			state_ = state::chunk_data;
+		}
+		else if (!verify_chunk_signature()) {
+			// The final chunk has no data, so its signature can be verified right away.
+			fail(error_code::signature_mismatch);
+			return;
+		}
+		else {
+			// The final chunk is followed by the trailing headers, if any, and an empty line.
+			state_ = state::trailer_line;
+		}
+
+		chunk_size_ = 0;
+		chunk_size_digits_ = 0;
+		chunk_header_size_ = 0;
+		chunk_extensions_.clear();
+	} // on_chunk_header_complete
+
+	auto aws_chunked_decoder::verify_chunk_signature() -> bool
+	{
+		if (!signing_context_) {
+			return true;
+		}
+
+		const auto string_to_sign = fmt::format(
+			"AWS4-HMAC-SHA256-PAYLOAD\n{}\n{}\n{}\n{}\n{}",
+			signing_context_->timestamp,
+			signing_context_->scope,
+			previous_signature_,
+			empty_string_hash,
+			authentication::hex_encode(chunk_hasher_->finalize()));
+
+		chunk_hasher_.reset();
+
+		auto signature = authentication::hex_encode(
+			authentication::hmac_sha_256(signing_context_->signing_key, string_to_sign, backend_));
+
+		if (signature != chunk_signature_) {
+			return false;
+		}
+
+		previous_signature_ = std::move(signature);
+
+		return true;
+	} // verify_chunk_signature
+
+	auto aws_chunked_decoder::on_trailer_line_complete() -> void
+	{
+		// An empty line ends the trailing headers.
+		if (trailer_line_.empty()) {
+			if (!verify_trailer_signature()) {
+				return;
+			}
+
+			state_ = state::done;
+			return;
+		}
+
+		const auto line = std::string_view{trailer_line_};
+		const auto colon = line.find(':');
+		if (colon == std::string_view::npos || colon == 0) {
+			fail(error_code::malformed_trailer);
+			return;
+		}
+
+		std::string name;
+		name.reserve(colon);
+		std::transform(std::begin(line), std::begin(line) + colon, std::back_inserter(name), to_lower);
+
+		const auto value = trim(line.substr(colon + 1));
+
+		if (name == trailer_signature_name) {
+			trailer_signature_ = value;
+		}
+		else {
+			trailers_.emplace_back(std::move(name), value);
+		}
+
+		trailer_line_.clear();
+		state_ = state::trailer_line;
+	} // on_trailer_line_complete
+
+	auto aws_chunked_decoder::verify_trailer_signature() -> bool
+	{
+		if (!signing_context_ || trailers_.empty()) {
+			return true;
+		}
+
+		if (trailer_signature_.empty()) {
+			fail(error_code::missing_trailer_signature);
+			return false;
+		}
+
+		authentication::sha_256_hasher hasher{backend_};
+		for (const auto& [name, value] : trailers_) {
+			hasher.update(name);
+			hasher.update(":");
+			hasher.update(value);
+			hasher.update("\n");
+		}
+
+		const auto string_to_sign = fmt::format(
+			"AWS4-HMAC-SHA256-TRAILER\n{}\n{}\n{}\n{}",
+			signing_context_->timestamp,
+			signing_context_->scope,
+			previous_signature_,
+			authentication::hex_encode(hasher.finalize()));
+
+		const auto signature = authentication::hex_encode(
+			authentication::hmac_sha_256(signing_context_->signing_key, string_to_sign, backend_));
+
+		if (signature != trailer_signature_) {
+			fail(error_code::signature_mismatch);
+			return false;
+		}
+
+		return true;
+	} // verify_trailer_signature
+
+	auto aws_chunked_decoder::trailer(std::string_view _name) const -> std::optional<std::string_view>
+	{
+		const auto iter = std::find_if(
+			std::begin(trailers_), std::end(trailers_), [_name](const auto& _kv) { return _kv.first == _name; });
+
+		if (iter == std::end(trailers_)) {
+			return std::nullopt;
+		}
+
+		return iter->second;
+	} // trailer
+
+	auto to_string(aws_chunked_decoder::error_code _ec) noexcept -> std::string_view
+	{
+		using error_code = aws_chunked_decoder::error_code;
+
+		switch (_ec) {
+			case error_code::none:
+				return "no error";
+			case error_code::malformed_chunk_header:
+				return "malformed chunk header";
+			case error_code::chunk_header_too_long:
+				return "chunk header too long";
+			case error_code::chunk_size_too_large:
+				return "chunk size too large";
+			case error_code::missing_chunk_signature:
+				return "missing chunk signature";
+			case error_code::malformed_chunk_terminator:
+				return "malformed chunk terminator";
+			case error_code::malformed_trailer:
+				return "malformed trailing header";
+			case error_code::trailer_too_long:
+				return "trailing headers too long";
+			case error_code::missing_trailer_signature:
+				return "missing trailer signature";
+			case error_code::signature_mismatch:
+				return "chunk signature does not match";
+		}
+
+		return "unknown error";
+	} // to_string
+} // namespace irods::s3
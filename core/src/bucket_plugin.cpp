@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <string>
+#include <string_view>
 #include <utility>
 
 namespace fs = irods::experimental::filesystem;
@@ -40,3 +41,14 @@ fs::path irods::s3::finish_path(const fs::path& base, const boost::urls::segment
 	}
 	return result;
 } // finish_path
+
+fs::path irods::s3::staging_collection(const fs::path& base)
+{
+	return base / std::string{staging_collection_name};
+} // staging_collection
+
+bool irods::s3::is_in_staging_collection(const fs::path& base, std::string_view path)
+{
+	const auto staging = staging_collection(base).string();
+	return path.starts_with(staging) && (path.size() == staging.size() || path[staging.size()] == '/');
+} // is_in_staging_collection
@@ -0,0 +1,204 @@
+#include "irods/private/s3_api/buffer_pool.hpp"
+
+#include <bit>
+#include <functional>
+#include <thread>
+#include <utility>
+
+namespace irods::http
+{
+	buffer_pool::buffer::buffer(
+		buffer_pool& _pool,
+		std::unique_ptr<char[]> _data,
+		std::size_t _size,
+		std::size_t _size_class)
+		: pool_{&_pool}
+		, data_{std::move(_data)}
+		, size_{_size}
+		, size_class_{_size_class}
+	{
+	} // constructor
+
+	buffer_pool::buffer::buffer(buffer&& _other) noexcept
+		: pool_{std::exchange(_other.pool_, nullptr)}
+		, data_{std::move(_other.data_)}
+		, size_{std::exchange(_other.size_, 0)}
+		, size_class_{_other.size_class_}
+	{
+	} // move constructor
+
+	auto buffer_pool::buffer::operator=(buffer&& _other) noexcept -> buffer&
+	{
+		if (this != &_other) {
+			release();
+			pool_ = std::exchange(_other.pool_, nullptr);
+			data_ = std::move(_other.data_);
+			size_ = std::exchange(_other.size_, 0);
+			size_class_ = _other.size_class_;
+		}
+
+		return *this;
+	} // move assignment
+
+	buffer_pool::buffer::~buffer()
+	{
+		release();
+	} // destructor
+
+	auto buffer_pool::buffer::release() noexcept -> void
+	{
+		if (pool_ && data_) {
+			pool_->release(std::move(data_), size_class_, size_);
+		}
+
+		pool_ = nullptr;
+		size_ = 0;
+	} // release
+
+	buffer_pool::buffer_pool(buffer_pool_options _options)
+		: max_idle_bytes_{_options.max_idle_bytes}
+	{
+	} // constructor
+
+	auto buffer_pool::acquire(std::size_t _size) -> buffer
+	{
+		const auto size_class = size_class_of(_size);
+
+		if (size_class == unpooled) {
+			unpooled_allocations_.fetch_add(1, std::memory_order_relaxed);
+			in_use_buffers_.fetch_add(1, std::memory_order_relaxed);
+			in_use_bytes_.fetch_add(_size, std::memory_order_relaxed);
+			return {*this, std::unique_ptr<char[]>(new char[_size]), _size, unpooled};
+		}
+
+		const auto allocation_size = size_of(size_class);
+		auto& sc = size_classes_[size_class];
+		std::unique_ptr<char[]> data;
+
+		// Try the shard of this thread first. Buffers released by other threads are only looked
+		// for if the size class has idle buffers, which keeps a miss in an empty pool cheap.
+		const auto local_shard = shard_index();
+		for (std::size_t i = 0; i < shard_count && !data; ++i) {
+			if (i > 0 && sc.idle_buffers.load(std::memory_order_relaxed) == 0) {
+				break;
+			}
+
+			auto& shard = sc.shards[(local_shard + i) % shard_count];
+			std::scoped_lock lock{shard.mtx};
+
+			if (!shard.idle.empty()) {
+				data = std::move(shard.idle.back());
+				shard.idle.pop_back();
+
+				if (i > 0) {
+					remote_hits_.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+		}
+
+		if (data) {
+			hits_.fetch_add(1, std::memory_order_relaxed);
+			sc.idle_buffers.fetch_sub(1, std::memory_order_relaxed);
+			idle_bytes_.fetch_sub(allocation_size, std::memory_order_relaxed);
+		}
+		else {
+			misses_.fetch_add(1, std::memory_order_relaxed);
+			data.reset(new char[allocation_size]);
+		}
+
+		in_use_buffers_.fetch_add(1, std::memory_order_relaxed);
+		in_use_bytes_.fetch_add(allocation_size, std::memory_order_relaxed);
+
+		return {*this, std::move(data), _size, size_class};
+	} // acquire
+
+	auto buffer_pool::release(std::unique_ptr<char[]> _data, std::size_t _size_class, std::size_t _size) noexcept
+		-> void
+	{
+		in_use_buffers_.fetch_sub(1, std::memory_order_relaxed);
+
+		if (_size_class == unpooled) {
+			in_use_bytes_.fetch_sub(_size, std::memory_order_relaxed);
+			return;
+		}
+
+		const auto allocation_size = size_of(_size_class);
+		in_use_bytes_.fetch_sub(allocation_size, std::memory_order_relaxed);
+
+		// Reserve room for the buffer before making it visible to other threads. If the pool is
+		// full, the buffer is freed when _data goes out of scope.
+		if (idle_bytes_.fetch_add(allocation_size, std::memory_order_relaxed) + allocation_size > max_idle_bytes_) {
+			idle_bytes_.fetch_sub(allocation_size, std::memory_order_relaxed);
+			discarded_buffers_.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		auto& sc = size_classes_[_size_class];
+
+		try {
+			auto& shard = sc.shards[shard_index()];
+			std::scoped_lock lock{shard.mtx};
+			shard.idle.push_back(std::move(_data));
+		}
+		catch (...) {
+			// Growing the list of idle buffers failed. Free the buffer instead.
+			idle_bytes_.fetch_sub(allocation_size, std::memory_order_relaxed);
+			discarded_buffers_.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		sc.idle_buffers.fetch_add(1, std::memory_order_relaxed);
+	} // release
+
+	auto buffer_pool::to_json() const -> nlohmann::json
+	{
+		const auto hits = hits_.load(std::memory_order_relaxed);
+		const auto misses = misses_.load(std::memory_order_relaxed);
+		const auto acquisitions = hits + misses;
+
+		auto idle_buffers = nlohmann::json::object();
+		for (std::size_t i = 0; i < size_class_count; ++i) {
+			if (const auto count = size_classes_[i].idle_buffers.load(std::memory_order_relaxed); count > 0) {
+				idle_buffers[std::to_string(size_of(i))] = count;
+			}
+		}
+
+		return {
+			{"hits", hits},
+			{"misses", misses},
+			{"hit_rate", (acquisitions > 0) ? static_cast<double>(hits) / static_cast<double>(acquisitions) : 0.0},
+			{"remote_hits", remote_hits_.load(std::memory_order_relaxed)},
+			{"unpooled_allocations", unpooled_allocations_.load(std::memory_order_relaxed)},
+			{"discarded_buffers", discarded_buffers_.load(std::memory_order_relaxed)},
+			{"in_use_buffers", in_use_buffers_.load(std::memory_order_relaxed)},
+			{"in_use_bytes", in_use_bytes_.load(std::memory_order_relaxed)},
+			{"idle_bytes", idle_bytes_.load(std::memory_order_relaxed)},
+			{"max_idle_bytes", max_idle_bytes_},
+			{"idle_buffers_by_size", std::move(idle_buffers)}};
+	} // to_json
+
+	auto buffer_pool::size_class_of(std::size_t _size) noexcept -> std::size_t
+	{
+		if (_size > max_buffer_size) {
+			return unpooled;
+		}
+
+		if (_size <= min_buffer_size) {
+			return 0;
+		}
+
+		return static_cast<std::size_t>(std::bit_width(_size - 1)) -
+		       static_cast<std::size_t>(std::countr_zero(min_buffer_size));
+	} // size_class_of
+
+	auto buffer_pool::size_of(std::size_t _size_class) noexcept -> std::size_t
+	{
+		return min_buffer_size << _size_class;
+	} // size_of
+
+	auto buffer_pool::shard_index() noexcept -> std::size_t
+	{
+		thread_local const auto index = std::hash<std::thread::id>{}(std::this_thread::get_id()) % shard_count;
+		return index;
+	} // shard_index
+} // namespace irods::http
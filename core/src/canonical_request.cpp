@@ -0,0 +1,274 @@
+#include "irods/private/s3_api/canonical_request.hpp"
+
+#include "irods/private/s3_api/hmac.hpp"
+
+#include <boost/beast/core/string.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+	using irods::s3::authentication::sha_256_hasher;
+
+	// Marks the bytes which uri_encode copies as-is.
+	constexpr auto unreserved_bytes = [] {
+		std::array<bool, 256> table{};
+
+		for (auto c = 'A'; c <= 'Z'; ++c) {
+			table[static_cast<unsigned char>(c)] = true;
+		}
+
+		for (auto c = 'a'; c <= 'z'; ++c) {
+			table[static_cast<unsigned char>(c)] = true;
+		}
+
+		for (auto c = '0'; c <= '9'; ++c) {
+			table[static_cast<unsigned char>(c)] = true;
+		}
+
+		for (const auto c : {'-', '.', '_', '~'}) {
+			table[static_cast<unsigned char>(c)] = true;
+		}
+
+		return table;
+	}();
+
+	// Interestingly, most hex-encoded values in the amazon api tend to be lower case, except for
+	// percent-encoding.
+	constexpr std::string_view upper_hex_digits = "0123456789ABCDEF";
+
+	template <typename Put>
+	auto uri_encode_into(std::string_view _sv, Put&& _put) -> void
+	{
+		for (const auto c : _sv) {
+			const auto byte = static_cast<unsigned char>(c);
+
+			if (unreserved_bytes[byte]) {
+				_put(c);
+			}
+			else {
+				_put('%');
+				_put(upper_hex_digits[byte >> 4]);
+				_put(upper_hex_digits[byte & 0x0f]);
+			}
+		}
+	} // uri_encode_into
+
+	auto to_lower(char _c) noexcept -> char
+	{
+		return (_c >= 'A' && _c <= 'Z') ? static_cast<char>(_c - 'A' + 'a') : _c;
+	} // to_lower
+
+	// Matches the behavior of boost::trim for the characters allowed in header values.
+	auto trim(std::string_view _sv) noexcept -> std::string_view
+	{
+		constexpr std::string_view whitespace = " \t\r\n\v\f";
+
+		const auto first = _sv.find_first_not_of(whitespace);
+		if (first == std::string_view::npos) {
+			return {};
+		}
+
+		return _sv.substr(first, _sv.find_last_not_of(whitespace) - first + 1);
+	} // trim
+
+	auto to_std_string_view(boost::beast::string_view _sv) noexcept -> std::string_view
+	{
+		return {_sv.data(), _sv.size()};
+	} // to_std_string_view
+
+	// Collects the canonical request in a fixed-size buffer which is fed to the hash whenever it
+	// fills up. The buffer is reused for the entire request, so writing never allocates.
+	class canonical_request_writer
+	{
+	  public:
+		canonical_request_writer(sha_256_hasher& _hasher, std::string* _copy)
+			: hasher_{_hasher}
+			, copy_{_copy}
+		{
+		} // constructor
+
+		auto put(char _c) -> void
+		{
+			if (size_ == buffer_.size()) {
+				flush();
+			}
+
+			buffer_[size_++] = _c;
+		} // put
+
+		auto append(std::string_view _sv) -> void
+		{
+			while (!_sv.empty()) {
+				if (size_ == buffer_.size()) {
+					flush();
+				}
+
+				const auto n = std::min(_sv.size(), buffer_.size() - size_);
+				std::memcpy(buffer_.data() + size_, _sv.data(), n);
+				size_ += n;
+				_sv.remove_prefix(n);
+			}
+		} // append
+
+		auto append_uri_encoded(std::string_view _sv) -> void
+		{
+			uri_encode_into(_sv, [this](char _c) { put(_c); });
+		} // append_uri_encoded
+
+		auto append_lowercase(std::string_view _sv) -> void
+		{
+			for (const auto c : _sv) {
+				put(to_lower(c));
+			}
+		} // append_lowercase
+
+		auto flush() -> void
+		{
+			const std::string_view data{buffer_.data(), size_};
+
+			hasher_.update(data);
+
+			if (copy_) {
+				copy_->append(data);
+			}
+
+			size_ = 0;
+		} // flush
+
+	  private:
+		sha_256_hasher& hasher_;
+		std::string* copy_;
+		std::array<char, 1024> buffer_;
+		std::size_t size_ = 0;
+	}; // class canonical_request_writer
+} // anonymous namespace
+
+namespace irods::s3::authentication
+{
+	auto uri_encode(std::string_view _sv) -> std::string
+	{
+		std::string result;
+		result.reserve(_sv.size());
+		uri_encode_into(_sv, [&result](char _c) { result.push_back(_c); });
+		return result;
+	} // uri_encode
+
+	auto hash_canonical_request(
+		const boost::beast::http::request_parser<boost::beast::http::empty_body>& _parser,
+		const boost::urls::url_view& _url,
+		const std::vector<std::string>& _signed_headers,
+		std::string* _canonical_request) -> std::string
+	{
+		const auto& message = _parser.get();
+
+		sha_256_hasher hasher;
+		canonical_request_writer out{hasher, _canonical_request};
+
+		// HTTP Verb
+		out.append(to_std_string_view(message.method_string()));
+		out.put('\n');
+
+		// Canonical URI
+		for (const auto segment : _url.segments()) {
+			out.put('/');
+			out.append_uri_encoded(segment);
+		}
+		out.put('\n');
+
+		// Canonical Query String
+		{
+			// The Query Parameters come from the URL, so they are already URI-encoded. The views
+			// refer to the URL's buffer, so sorting them does not copy the parameters.
+			std::vector<std::pair<std::string_view, std::string_view>> params;
+			params.reserve(_url.encoded_params().size());
+
+			for (const auto& param : _url.encoded_params()) {
+				// Regarding Query Parameter-based authentication, the S3 documentation says the following:
+				// "The Canonical Query String must include all the query parameters from the preceding table except
+				// for X-Amz-Signature."
+				// Since signatures are not used in generating themselves, exclude them for all authentication types.
+				if (param.key == "X-Amz-Signature") {
+					continue;
+				}
+
+				params.emplace_back(
+					std::string_view{param.key.data(), param.key.size()},
+					param.has_value ? std::string_view{param.value.data(), param.value.size()} : std::string_view{});
+			}
+
+			std::sort(std::begin(params), std::end(params));
+
+			bool first = true;
+			for (const auto& [key, value] : params) {
+				if (!first) {
+					out.put('&');
+				}
+
+				out.append(key);
+				out.put('=');
+				out.append(value);
+
+				first = false;
+			}
+		}
+		out.put('\n');
+
+		std::vector<std::string_view> sorted_signed_headers(std::begin(_signed_headers), std::end(_signed_headers));
+		std::sort(std::begin(sorted_signed_headers), std::end(sorted_signed_headers));
+
+		// Canonical Headers
+		// Headers which appear more than once are combined into a single, comma-separated list.
+		for (const auto name : sorted_signed_headers) {
+			const auto [first, last] = message.equal_range(boost::beast::string_view{name.data(), name.size()});
+			if (first == last) {
+				continue;
+			}
+
+			out.append_lowercase(name);
+			out.put(':');
+
+			for (auto iter = first; iter != last; ++iter) {
+				if (iter != first) {
+					out.put(',');
+				}
+
+				out.append(trim(to_std_string_view(iter->value())));
+			}
+
+			out.put('\n');
+		}
+		out.put('\n');
+
+		// Signed Headers
+		{
+			bool first = true;
+			for (const auto name : sorted_signed_headers) {
+				if (!first) {
+					out.put(';');
+				}
+
+				out.append(name);
+
+				first = false;
+			}
+		}
+		out.put('\n');
+
+		// Hashed Payload
+		if (const auto iter = message.find("X-Amz-Content-SHA256"); iter != message.end()) {
+			out.append(to_std_string_view(iter->value()));
+		}
+		else {
+			out.append("UNSIGNED-PAYLOAD");
+		}
+
+		out.flush();
+
+		return hex_encode(hasher.finalize());
+	} // hash_canonical_request
+} // namespace irods::s3::authentication
@@ -0,0 +1,355 @@
+#include "irods/private/s3_api/checksum.hpp"
+
+#include <fmt/format.h>
+#include <openssl/evp.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__)
+#  include <nmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#  include <arm_acle.h>
+#endif
+
+namespace
+{
+	using crc_tables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+	// Builds the tables for the slicing-by-8 algorithm for a reflected polynomial.
+	constexpr auto make_crc_tables(std::uint32_t _polynomial) -> crc_tables
+	{
+		crc_tables tables{};
+
+		for (std::uint32_t i = 0; i < 256; ++i) {
+			auto crc = i;
+			for (int bit = 0; bit < 8; ++bit) {
+				crc = (crc & 1) ? (crc >> 1) ^ _polynomial : crc >> 1;
+			}
+			tables[0][i] = crc;
+		}
+
+		for (std::uint32_t i = 0; i < 256; ++i) {
+			for (std::size_t t = 1; t < tables.size(); ++t) {
+				tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xff];
+			}
+		}
+
+		return tables;
+	} // make_crc_tables
+
+	constexpr auto crc32_tables = make_crc_tables(0xedb88320);
+	constexpr auto crc32c_tables = make_crc_tables(0x82f63b78);
+
+	auto crc_slicing_by_8(const crc_tables& _tables, std::uint32_t _crc, std::string_view _data) noexcept
+		-> std::uint32_t
+	{
+		auto crc = ~_crc;
+		const auto* p = reinterpret_cast<const unsigned char*>(_data.data());
+		auto n = _data.size();
+
+		while (n >= 8) {
+			const auto lo = crc ^ (std::uint32_t{p[0]} | std::uint32_t{p[1]} << 8 | std::uint32_t{p[2]} << 16 |
+			                       std::uint32_t{p[3]} << 24);
+
+			crc = _tables[7][lo & 0xff] ^ _tables[6][(lo >> 8) & 0xff] ^ _tables[5][(lo >> 16) & 0xff] ^
+			      _tables[4][lo >> 24] ^ _tables[3][p[4]] ^ _tables[2][p[5]] ^ _tables[1][p[6]] ^ _tables[0][p[7]];
+
+			p += 8;
+			n -= 8;
+		}
+
+		while (n-- > 0) {
+			crc = (crc >> 8) ^ _tables[0][(crc ^ *p++) & 0xff];
+		}
+
+		return ~crc;
+	} // crc_slicing_by_8
+
+#if defined(__x86_64__)
+	__attribute__((target("sse4.2"))) auto crc32c_sse42(std::uint32_t _crc, std::string_view _data) noexcept
+		-> std::uint32_t
+	{
+		std::uint64_t crc = ~_crc;
+		const auto* p = _data.data();
+		auto n = _data.size();
+
+		while (n >= 8) {
+			std::uint64_t word;
+			std::memcpy(&word, p, sizeof(word));
+			crc = _mm_crc32_u64(crc, word);
+			p += 8;
+			n -= 8;
+		}
+
+		auto crc32 = static_cast<std::uint32_t>(crc);
+		while (n-- > 0) {
+			crc32 = _mm_crc32_u8(crc32, static_cast<unsigned char>(*p++));
+		}
+
+		return ~crc32;
+	} // crc32c_sse42
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+	auto crc32c_armv8(std::uint32_t _crc, std::string_view _data) noexcept -> std::uint32_t
+	{
+		auto crc = ~_crc;
+		const auto* p = _data.data();
+		auto n = _data.size();
+
+		while (n >= 8) {
+			std::uint64_t word;
+			std::memcpy(&word, p, sizeof(word));
+			crc = __crc32cd(crc, word);
+			p += 8;
+			n -= 8;
+		}
+
+		while (n-- > 0) {
+			crc = __crc32cb(crc, static_cast<std::uint8_t>(*p++));
+		}
+
+		return ~crc;
+	} // crc32c_armv8
+#endif
+
+	auto crc32c_portable(std::uint32_t _crc, std::string_view _data) noexcept -> std::uint32_t
+	{
+		return crc_slicing_by_8(crc32c_tables, _crc, _data);
+	} // crc32c_portable
+
+	using crc32c_function = std::uint32_t (*)(std::uint32_t, std::string_view) noexcept;
+
+	// Picks the fastest implementation of CRC-32C supported by the CPU.
+	auto select_crc32c() noexcept -> crc32c_function
+	{
+#if defined(__x86_64__)
+		if (__builtin_cpu_supports("sse4.2")) {
+			return crc32c_sse42;
+		}
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+		return crc32c_armv8;
+#endif
+
+		return crc32c_portable;
+	} // select_crc32c
+
+	auto to_lower(char _c) noexcept -> char
+	{
+		return (_c >= 'A' && _c <= 'Z') ? static_cast<char>(_c - 'A' + 'a') : _c;
+	} // to_lower
+
+	// Returns the value of a hexadecimal digit, or -1 if the character is not a hexadecimal digit.
+	auto hex_digit_value(char _c) noexcept -> int
+	{
+		if (_c >= '0' && _c <= '9') {
+			return _c - '0';
+		}
+
+		if (_c >= 'a' && _c <= 'f') {
+			return _c - 'a' + 10;
+		}
+
+		if (_c >= 'A' && _c <= 'F') {
+			return _c - 'A' + 10;
+		}
+
+		return -1;
+	} // hex_digit_value
+
+	// Appends the bytes encoded by the hexadecimal string to _out. Returns false if the string is
+	// not valid hexadecimal.
+	auto hex_decode_into(std::string_view _hex, std::string& _out) -> bool
+	{
+		if (_hex.size() % 2 != 0) {
+			return false;
+		}
+
+		for (std::size_t i = 0; i < _hex.size(); i += 2) {
+			const auto hi = hex_digit_value(_hex[i]);
+			const auto lo = hex_digit_value(_hex[i + 1]);
+
+			if (hi < 0 || lo < 0) {
+				return false;
+			}
+
+			_out.push_back(static_cast<char>((hi << 4) | lo));
+		}
+
+		return true;
+	} // hex_decode_into
+
+	[[noreturn]] auto throw_openssl_error(const char* _operation) -> void
+	{
+		throw std::runtime_error{std::string{"OpenSSL digest operation failed: "} + _operation};
+	} // throw_openssl_error
+
+	constexpr std::size_t md5_size = 16;
+} // anonymous namespace
+
+namespace irods::s3
+{
+	auto checksum_algorithm_from_header_name(std::string_view _name) -> std::optional<checksum_algorithm>
+	{
+		for (const auto algorithm : {checksum_algorithm::crc32, checksum_algorithm::crc32c, checksum_algorithm::sha256})
+		{
+			const auto name = checksum_header_name(algorithm);
+
+			if (_name.size() == name.size() &&
+			    std::equal(std::begin(_name), std::end(_name), std::begin(name), [](char _lhs, char _rhs) {
+					return to_lower(_lhs) == _rhs;
+				}))
+			{
+				return algorithm;
+			}
+		}
+
+		return std::nullopt;
+	} // checksum_algorithm_from_header_name
+
+	auto checksum_header_name(checksum_algorithm _algorithm) noexcept -> std::string_view
+	{
+		switch (_algorithm) {
+			case checksum_algorithm::crc32:
+				return "x-amz-checksum-crc32";
+			case checksum_algorithm::crc32c:
+				return "x-amz-checksum-crc32c";
+			case checksum_algorithm::sha256:
+				return "x-amz-checksum-sha256";
+		}
+
+		return {};
+	} // checksum_header_name
+
+	auto crc32(std::uint32_t _crc, std::string_view _data) noexcept -> std::uint32_t
+	{
+		return crc_slicing_by_8(crc32_tables, _crc, _data);
+	} // crc32
+
+	auto crc32c(std::uint32_t _crc, std::string_view _data) noexcept -> std::uint32_t
+	{
+		static const auto impl = select_crc32c();
+		return impl(_crc, _data);
+	} // crc32c
+
+	checksum_calculator::checksum_calculator(checksum_algorithm _algorithm)
+		: algorithm_{_algorithm}
+	{
+		if (algorithm_ == checksum_algorithm::sha256) {
+			hasher_.emplace();
+		}
+	} // constructor
+
+	auto checksum_calculator::update(std::string_view _data) -> void
+	{
+		switch (algorithm_) {
+			case checksum_algorithm::crc32:
+				crc_ = crc32(crc_, _data);
+				break;
+			case checksum_algorithm::crc32c:
+				crc_ = crc32c(crc_, _data);
+				break;
+			case checksum_algorithm::sha256:
+				hasher_->update(_data);
+				break;
+		}
+	} // update
+
+	auto checksum_calculator::finalize() -> std::string
+	{
+		if (algorithm_ == checksum_algorithm::sha256) {
+			return base64_encode(hasher_->finalize());
+		}
+
+		// CRCs are transmitted in big-endian byte order.
+		const char bytes[] = {
+			static_cast<char>(crc_ >> 24),
+			static_cast<char>(crc_ >> 16),
+			static_cast<char>(crc_ >> 8),
+			static_cast<char>(crc_)};
+
+		return base64_encode({bytes, sizeof(bytes)});
+	} // finalize
+
+	struct md5_calculator::impl
+	{
+		EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+
+		~impl()
+		{
+			EVP_MD_CTX_free(ctx);
+		}
+	}; // struct md5_calculator::impl
+
+	md5_calculator::md5_calculator()
+		: impl_{std::make_unique<impl>()}
+	{
+		if (!impl_->ctx || EVP_DigestInit_ex(impl_->ctx, EVP_md5(), nullptr) != 1) {
+			throw_openssl_error("EVP_DigestInit_ex");
+		}
+	} // constructor
+
+	md5_calculator::~md5_calculator() = default;
+
+	auto md5_calculator::update(std::string_view _data) -> void
+	{
+		if (EVP_DigestUpdate(impl_->ctx, _data.data(), _data.size()) != 1) {
+			throw_openssl_error("EVP_DigestUpdate");
+		}
+	} // update
+
+	auto md5_calculator::finalize() -> std::string
+	{
+		std::string result(md5_size, '\0');
+		unsigned int size = 0;
+
+		if (EVP_DigestFinal_ex(impl_->ctx, reinterpret_cast<unsigned char*>(result.data()), &size) != 1) {
+			throw_openssl_error("EVP_DigestFinal_ex");
+		}
+
+		return result;
+	} // finalize
+
+	auto make_etag(std::string_view _md5) -> std::string
+	{
+		return '"' + authentication::hex_encode(_md5) + '"';
+	} // make_etag
+
+	auto make_multipart_etag(const std::vector<std::string>& _part_etags) -> std::optional<std::string>
+	{
+		std::string digests;
+		digests.reserve(_part_etags.size() * md5_size);
+
+		for (std::string_view etag : _part_etags) {
+			if (etag.size() >= 2 && etag.front() == '"' && etag.back() == '"') {
+				etag = etag.substr(1, etag.size() - 2);
+			}
+
+			if (etag.size() != 2 * md5_size || !hex_decode_into(etag, digests)) {
+				return std::nullopt;
+			}
+		}
+
+		md5_calculator md5;
+		md5.update(digests);
+
+		return fmt::format("\"{}-{}\"", authentication::hex_encode(md5.finalize()), _part_etags.size());
+	} // make_multipart_etag
+
+	auto base64_encode(std::string_view _data) -> std::string
+	{
+		// EVP_EncodeBlock writes 4 bytes for every 3 bytes of input, plus a null terminator.
+		std::string result(4 * ((_data.size() + 2) / 3) + 1, '\0');
+
+		const auto size = EVP_EncodeBlock(
+			reinterpret_cast<unsigned char*>(result.data()),
+			reinterpret_cast<const unsigned char*>(_data.data()),
+			static_cast<int>(_data.size()));
+
+		result.resize(static_cast<std::size_t>(size));
+
+		return result;
+	} // base64_encode
+} // namespace irods::s3
@@ -0,0 +1,129 @@
+#include "irods/private/s3_api/collection_cache.hpp"
+
+#include <functional>
+#include <iterator>
+
+namespace
+{
+	// Removes trailing slashes, except for the root collection.
+	auto normalize(std::string_view _path) noexcept -> std::string_view
+	{
+		while (_path.size() > 1 && _path.back() == '/') {
+			_path.remove_suffix(1);
+		}
+
+		return _path;
+	} // normalize
+} // anonymous namespace
+
+namespace irods::s3
+{
+	collection_cache::collection_cache(std::size_t _capacity, std::chrono::seconds _time_to_live)
+		: capacity_per_shard_{(_capacity + shard_count - 1) / shard_count}
+		, time_to_live_{_time_to_live}
+	{
+	} // constructor
+
+	auto collection_cache::contains(std::string_view _zone, std::string_view _path, clock_type::time_point _now)
+		-> bool
+	{
+		if (!enabled()) {
+			return false;
+		}
+
+		const auto key = make_key(_zone, _path);
+		auto& shard = shard_for(key);
+
+		{
+			std::scoped_lock lock{shard.mtx};
+
+			if (const auto iter = shard.entries.find(key); iter != std::end(shard.entries)) {
+				if (_now < iter->second) {
+					hits_.fetch_add(1, std::memory_order_relaxed);
+					return true;
+				}
+
+				shard.entries.erase(iter);
+			}
+		}
+
+		misses_.fetch_add(1, std::memory_order_relaxed);
+
+		return false;
+	} // contains
+
+	auto collection_cache::insert(std::string_view _zone, std::string_view _path, clock_type::time_point _now) -> void
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		auto key = make_key(_zone, _path);
+		auto& shard = shard_for(key);
+
+		std::scoped_lock lock{shard.mtx};
+
+		if (shard.entries.size() >= capacity_per_shard_ && shard.entries.count(key) == 0) {
+			// Make room by removing the entries which have expired. If all entries are still
+			// valid, remove an arbitrary one.
+			std::erase_if(shard.entries, [_now](const auto& _kv) { return _now >= _kv.second; });
+
+			if (shard.entries.size() >= capacity_per_shard_) {
+				shard.entries.erase(std::begin(shard.entries));
+			}
+		}
+
+		shard.entries.insert_or_assign(std::move(key), _now + time_to_live_);
+	} // insert
+
+	auto collection_cache::erase(std::string_view _zone, std::string_view _path) -> void
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		invalidations_.fetch_add(1, std::memory_order_relaxed);
+
+		// Collections below _path may live in any shard. Deleting collections is rare compared
+		// to writing objects, so every shard is searched.
+		const auto key = make_key(_zone, _path);
+		const auto is_affected = [&key](const auto& _kv) {
+			const std::string_view k = _kv.first;
+			return k == key || (k.size() > key.size() && k.starts_with(key) && k[key.size()] == '/');
+		};
+
+		for (auto& shard : shards_) {
+			std::scoped_lock lock{shard.mtx};
+			std::erase_if(shard.entries, is_affected);
+		}
+	} // erase
+
+	auto collection_cache::to_json() const -> nlohmann::json
+	{
+		const auto hits = hits_.load(std::memory_order_relaxed);
+		const auto misses = misses_.load(std::memory_order_relaxed);
+		const auto lookups = hits + misses;
+
+		return {
+			{"hits", hits},
+			{"misses", misses},
+			{"hit_rate", (lookups > 0) ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0},
+			{"invalidations", invalidations_.load(std::memory_order_relaxed)}};
+	} // to_json
+
+	auto collection_cache::make_key(std::string_view _zone, std::string_view _path) -> std::string
+	{
+		// Zone names never contain a colon.
+		_path = normalize(_path);
+
+		std::string key;
+		key.reserve(_zone.size() + _path.size() + 1);
+		key.append(_zone).append(1, ':').append(_path);
+		return key;
+	} // make_key
+
+	auto collection_cache::shard_for(const std::string& _key) -> shard_type&
+	{
+		return shards_[std::hash<std::string>{}(_key) % shard_count];
+	} // shard_for
+} // namespace irods::s3
@@ -1,17 +1,14 @@
 #include "irods/private/s3_api/common.hpp"
 
 #include "irods/private/s3_api/globals.hpp"
+#include "irods/private/s3_api/identity.hpp"
 #include "irods/private/s3_api/log.hpp"
 #include "irods/private/s3_api/session.hpp"
 #include "irods/private/s3_api/version.hpp"
 
-#include <irods/irods_at_scope_exit.hpp>
 #include <irods/irods_exception.hpp>
 #include <irods/rcConnect.h>
-#include <irods/rcMisc.h> // For addKeyVal().
 #include <irods/rodsErrorTable.h>
-#include <irods/rodsKeyWdDef.h> // For KW_CLOSE_OPEN_REPLICAS.
-#include <irods/switch_user.h>
 
 #ifdef IRODS_DEV_PACKAGE_IS_AT_LEAST_IRODS_5
 #  include <irods/authenticate.h>
@@ -106,23 +103,15 @@ namespace irods
 
 		auto conn = irods::http::globals::connection_pool().get_connection();
 
-		http::logging::trace("{}: Changing identity associated with connection to [{}].", __func__, _username);
-
-		SwitchUserInput input{};
-
-		irods::at_scope_exit clear_options{[&input] { clearKeyVal(&input.options); }};
-
-		irods::strncpy_null_terminated(input.username, _username.c_str());
-		irods::strncpy_null_terminated(input.zone, zone.c_str());
-		addKeyVal(&input.options, KW_CLOSE_OPEN_REPLICAS, "");
-
-		if (const auto ec = rc_switch_user(static_cast<RcComm*>(conn), &input); ec < 0) {
+		// irods::connection_pool cannot be asked for a connection carrying a particular identity,
+		// and does not know whether the last request left replicas open on the connection. The
+		// identity is always changed, which closes such replicas. Only the streaming connection
+		// pool reuses connections without switching.
+		if (const auto ec = http::change_identity(static_cast<RcComm&>(conn), _username, zone); ec < 0) {
 			http::logging::error("{}: rc_switch_user error: {}", __func__, ec);
 			THROW(ec, "rc_switch_user error.");
 		}
 
-		http::logging::trace("{}: Successfully changed identity associated with connection to [{}].", __func__, _username);
-
 		return irods::http::connection_facade{std::move(conn)};
 	} // get_connection
 } // namespace irods
@@ -9,13 +9,69 @@
 uint64_t irods::s3::get_put_object_buffer_size_in_bytes()
 {
 	const nlohmann::json& config = irods::http::globals::configuration();
-	return config.value(nlohmann::json::json_pointer{"/irods_client/put_object_buffer_size_in_bytes"}, 8192);
+	return config.value(nlohmann::json::json_pointer{"/irods_client/put_object_buffer_size_in_bytes"}, 1048576);
+}
+
+uint64_t irods::s3::get_put_object_pipeline_depth()
+{
+	const nlohmann::json& config = irods::http::globals::configuration();
+	return config.value(nlohmann::json::json_pointer{"/irods_client/put_object_pipeline_depth"}, 2);
+}
+
+uint64_t irods::s3::get_put_object_parallel_write_streams()
+{
+	const nlohmann::json& config = irods::http::globals::configuration();
+	return config.value(nlohmann::json::json_pointer{"/irods_client/put_object_parallel_write_streams"}, 1);
+}
+
+uint64_t irods::s3::get_put_object_parallel_write_threshold_in_bytes()
+{
+	const nlohmann::json& config = irods::http::globals::configuration();
+	return config.value(
+		nlohmann::json::json_pointer{"/irods_client/put_object_parallel_write_threshold_in_bytes"}, 67108864);
 }
 
 uint64_t irods::s3::get_get_object_buffer_size_in_bytes()
 {
 	const nlohmann::json& config = irods::http::globals::configuration();
-	return config.value(nlohmann::json::json_pointer{"/irods_client/get_object_buffer_size_in_bytes"}, 8192);
+	return config.value(nlohmann::json::json_pointer{"/irods_client/get_object_buffer_size_in_bytes"}, 1048576);
+}
+
+uint64_t irods::s3::get_get_object_pipeline_depth()
+{
+	const nlohmann::json& config = irods::http::globals::configuration();
+	return config.value(nlohmann::json::json_pointer{"/irods_client/get_object_pipeline_depth"}, 2);
+}
+
+uint64_t irods::s3::get_get_object_parallel_read_streams()
+{
+	const nlohmann::json& config = irods::http::globals::configuration();
+	return config.value(nlohmann::json::json_pointer{"/irods_client/get_object_parallel_read_streams"}, 1);
+}
+
+uint64_t irods::s3::get_get_object_parallel_read_threshold_in_bytes()
+{
+	const nlohmann::json& config = irods::http::globals::configuration();
+	return config.value(
+		nlohmann::json::json_pointer{"/irods_client/get_object_parallel_read_threshold_in_bytes"}, 67108864);
+}
+
+uint64_t irods::s3::get_complete_multipart_upload_parallel_part_writes()
+{
+	const nlohmann::json& config = irods::http::globals::configuration();
+	return config.value(nlohmann::json::json_pointer{"/irods_client/complete_multipart_upload_parallel_part_writes"}, 4);
+}
+
+int irods::s3::get_request_timeout_in_seconds()
+{
+	const nlohmann::json& config = irods::http::globals::configuration();
+	return config.value(nlohmann::json::json_pointer{"/s3_server/requests/timeout_in_seconds"}, 30);
+}
+
+uint64_t irods::s3::get_signing_key_cache_size()
+{
+	const nlohmann::json& config = irods::http::globals::configuration();
+	return config.value(nlohmann::json::json_pointer{"/s3_server/signing_key_cache_size"}, 4096);
 }
 
 std::string irods::s3::get_s3_region()
@@ -24,6 +80,18 @@ std::string irods::s3::get_s3_region()
 	return config.value(nlohmann::json::json_pointer{"/s3_server/region"}, "us-east-1");
 }
 
+bool irods::s3::get_multipart_upload_infer_part_size()
+{
+	const nlohmann::json& config = irods::http::globals::configuration();
+	return config.value(nlohmann::json::json_pointer{"/s3_server/multipart_upload_infer_part_size"}, false);
+}
+
+std::string irods::s3::get_zone()
+{
+	const nlohmann::json& config = irods::http::globals::configuration();
+	return config.at(nlohmann::json::json_pointer{"/irods_client/zone"}).get<std::string>();
+}
+
 std::string irods::s3::get_resource()
 {
 	const nlohmann::json& config = irods::http::globals::configuration();
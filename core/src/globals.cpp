@@ -18,6 +18,27 @@ namespace
 	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 	irods::connection_pool* g_conn_pool{};
 
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	irods::http::streaming_connection_pool* g_streaming_conn_pool{};
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	irods::http::buffer_pool* g_buffer_pool{};
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	irods::s3::collection_cache* g_collection_cache{};
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	irods::s3::part_staging_area* g_part_staging_area{};
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	irods::http::permit_pool* g_part_writer_permits{};
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	irods::s3::multipart_journal* g_multipart_journal{};
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	irods::s3::multipart_upload_index* g_multipart_upload_index{};
+
 	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 	boost::dll::shared_library g_bucket_mapping_lib{};
 
@@ -78,6 +99,76 @@ namespace irods::http::globals
 		return *g_conn_pool;
 	} // connection_pool
 
+	auto set_streaming_connection_pool(irods::http::streaming_connection_pool& _cp) -> void
+	{
+		g_streaming_conn_pool = &_cp;
+	} // set_streaming_connection_pool
+
+	auto streaming_connection_pool() -> irods::http::streaming_connection_pool&
+	{
+		return *g_streaming_conn_pool;
+	} // streaming_connection_pool
+
+	auto set_buffer_pool(irods::http::buffer_pool& _bp) -> void
+	{
+		g_buffer_pool = &_bp;
+	} // set_buffer_pool
+
+	auto buffer_pool() -> irods::http::buffer_pool&
+	{
+		return *g_buffer_pool;
+	} // buffer_pool
+
+	auto set_collection_cache(irods::s3::collection_cache& _cache) -> void
+	{
+		g_collection_cache = &_cache;
+	} // set_collection_cache
+
+	auto collection_cache() -> irods::s3::collection_cache&
+	{
+		return *g_collection_cache;
+	} // collection_cache
+
+	auto set_part_staging_area(irods::s3::part_staging_area& _area) -> void
+	{
+		g_part_staging_area = &_area;
+	} // set_part_staging_area
+
+	auto part_staging_area() -> irods::s3::part_staging_area&
+	{
+		return *g_part_staging_area;
+	} // part_staging_area
+
+	auto set_part_writer_permits(irods::http::permit_pool& _permits) -> void
+	{
+		g_part_writer_permits = &_permits;
+	} // set_part_writer_permits
+
+	auto part_writer_permits() -> irods::http::permit_pool&
+	{
+		return *g_part_writer_permits;
+	} // part_writer_permits
+
+	auto set_multipart_journal(irods::s3::multipart_journal& _journal) -> void
+	{
+		g_multipart_journal = &_journal;
+	} // set_multipart_journal
+
+	auto multipart_journal() -> irods::s3::multipart_journal&
+	{
+		return *g_multipart_journal;
+	} // multipart_journal
+
+	auto set_multipart_upload_index(irods::s3::multipart_upload_index& _index) -> void
+	{
+		g_multipart_upload_index = &_index;
+	} // set_multipart_upload_index
+
+	auto multipart_upload_index() -> irods::s3::multipart_upload_index&
+	{
+		return *g_multipart_upload_index;
+	} // multipart_upload_index
+
 	auto set_bucket_mapping_library(boost::dll::shared_library _lib) -> void
 	{
 		g_bucket_mapping_lib = std::move(_lib);
@@ -6,38 +6,158 @@ extern "C" {
 #include "sha256.h"
 }
 
-#include <fmt/core.h>
-#include <sstream>
-#include <iostream>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+	constexpr std::size_t sha_256_size = 32;
+
+	struct evp_md_ctx_deleter
+	{
+		void operator()(EVP_MD_CTX* ctx) const noexcept
+		{
+			EVP_MD_CTX_free(ctx);
+		}
+	};
+
+	using evp_md_ctx_pointer = std::unique_ptr<EVP_MD_CTX, evp_md_ctx_deleter>;
+
+	[[noreturn]] void throw_openssl_error(const char* operation)
+	{
+		throw std::runtime_error{fmt::format("OpenSSL digest operation failed: {}", operation)};
+	}
+} // anonymous namespace
 
 namespace irods::s3::authentication
 {
-	std::string hmac_sha_256(const std::string_view& key, const std::string_view& data)
+	digest_backend default_digest_backend() noexcept
+	{
+		return digest_backend::openssl;
+	}
+
+	std::string_view to_string(digest_backend backend) noexcept
+	{
+		switch (backend) {
+			case digest_backend::portable:
+				return "portable";
+			case digest_backend::openssl:
+				return "openssl";
+		}
+
+		return "unknown";
+	}
+
+	std::string hmac_sha_256(const std::string_view& key, const std::string_view& data, digest_backend backend)
+	{
+		std::string result(sha_256_size, '\0');
+		auto* out = reinterpret_cast<unsigned char*>(result.data());
+
+		if (backend == digest_backend::openssl) {
+			unsigned int result_size = 0;
+			if (!HMAC(
+					EVP_sha256(),
+					key.data(),
+					static_cast<int>(key.length()),
+					reinterpret_cast<const unsigned char*>(data.data()),
+					data.length(),
+					out,
+					&result_size))
+			{
+				throw_openssl_error("HMAC");
+			}
+			return result;
+		}
+
+		hmac_sha256(key.data(), key.length(), data.data(), data.length(), out, sha_256_size);
+		return result;
+	}
+
+	std::string hash_sha_256(const std::string_view& data, digest_backend backend)
 	{
-		namespace logging = irods::http::logging;
-		unsigned char result[32];
-		unsigned int result_size = 32;
-		hmac_sha256(key.data(), key.length(), data.data(), data.length(), result, 32);
-		logging::trace("HMAC size is {} bytes", result_size);
-		return std::string(std::string_view((char*) result, 32));
+		sha_256_hasher hasher{backend};
+		hasher.update(data);
+		return hasher.finalize();
 	}
 
-	std::string hash_sha_256(const std::string_view& data)
+	struct sha_256_hasher::impl
 	{
+		digest_backend backend;
 		Sha256Context ctx;
-		Sha256Initialise(&ctx);
-		Sha256Update(&ctx, static_cast<const void*>(data.data()), data.length());
+		evp_md_ctx_pointer evp_ctx;
+	};
+
+	sha_256_hasher::sha_256_hasher(digest_backend backend)
+		: impl_{std::make_unique<impl>()}
+	{
+		impl_->backend = backend;
+
+		if (backend == digest_backend::openssl) {
+			impl_->evp_ctx.reset(EVP_MD_CTX_new());
+			if (!impl_->evp_ctx || EVP_DigestInit_ex(impl_->evp_ctx.get(), EVP_sha256(), nullptr) != 1) {
+				throw_openssl_error("EVP_DigestInit_ex");
+			}
+			return;
+		}
+
+		Sha256Initialise(&impl_->ctx);
+	}
+
+	sha_256_hasher::~sha_256_hasher() = default;
+
+	void sha_256_hasher::update(const std::string_view& data)
+	{
+		if (impl_->backend == digest_backend::openssl) {
+			if (EVP_DigestUpdate(impl_->evp_ctx.get(), data.data(), data.length()) != 1) {
+				throw_openssl_error("EVP_DigestUpdate");
+			}
+			return;
+		}
+
+		// The portable implementation takes a 32-bit length.
+		auto remaining = data;
+		while (!remaining.empty()) {
+			const auto n = std::min<std::size_t>(remaining.length(), std::numeric_limits<std::uint32_t>::max());
+			Sha256Update(&impl_->ctx, static_cast<const void*>(remaining.data()), static_cast<std::uint32_t>(n));
+			remaining.remove_prefix(n);
+		}
+	}
+
+	std::string sha_256_hasher::finalize()
+	{
+		if (impl_->backend == digest_backend::openssl) {
+			std::string result(sha_256_size, '\0');
+			unsigned int result_size = 0;
+			if (EVP_DigestFinal_ex(
+					impl_->evp_ctx.get(), reinterpret_cast<unsigned char*>(result.data()), &result_size) != 1)
+			{
+				throw_openssl_error("EVP_DigestFinal_ex");
+			}
+			return result;
+		}
+
 		SHA256_HASH hash;
-		Sha256Finalise(&ctx, &hash);
-		return std::string((char*) hash.bytes, 32);
+		Sha256Finalise(&impl_->ctx, &hash);
+		return std::string((char*) hash.bytes, sha_256_size);
 	}
 
 	std::string hex_encode(const std::string_view& data)
 	{
-		std::stringstream s;
-		for (size_t i = 0; i < data.length(); i++) {
-			s << fmt::format("{:02x}", (unsigned char) data[i]);
+		constexpr char digits[] = "0123456789abcdef";
+
+		std::string result(data.length() * 2, '\0');
+		auto* out = result.data();
+		for (const auto c : data) {
+			const auto byte = static_cast<unsigned char>(c);
+			*out++ = digits[byte >> 4];
+			*out++ = digits[byte & 0x0f];
 		}
-		return s.str();
+		return result;
 	}
 } //namespace irods::s3::authentication
@@ -0,0 +1,106 @@
+#include "irods/private/s3_api/identity.hpp"
+
+#include "irods/private/s3_api/common.hpp"
+#include "irods/private/s3_api/log.hpp"
+
+#include <irods/irods_at_scope_exit.hpp>
+#include <irods/rcConnect.h>
+#include <irods/rcMisc.h> // For addKeyVal().
+#include <irods/rodsKeyWdDef.h> // For KW_CLOSE_OPEN_REPLICAS.
+#include <irods/switch_user.h>
+
+#include <string>
+#include <string_view>
+
+namespace logging = irods::http::logging;
+
+namespace
+{
+	// Calls rc_switch_user, asking the server to close the replicas left open on the connection.
+	auto call_switch_user(RcComm& _comm, const std::string& _username, const std::string& _zone) -> int
+	{
+		SwitchUserInput input{};
+
+		irods::at_scope_exit clear_options{[&input] { clearKeyVal(&input.options); }};
+
+		irods::strncpy_null_terminated(input.username, _username.c_str());
+		irods::strncpy_null_terminated(input.zone, _zone.c_str());
+		addKeyVal(&input.options, KW_CLOSE_OPEN_REPLICAS, "");
+
+		return rc_switch_user(&_comm, &input);
+	} // call_switch_user
+} // anonymous namespace
+
+namespace irods::http
+{
+	auto identity_switch_metrics::instance() -> identity_switch_metrics&
+	{
+		static identity_switch_metrics metrics;
+		return metrics;
+	} // instance
+
+	auto identity_switch_metrics::to_json() const -> nlohmann::json
+	{
+		const auto misses = misses_.load(std::memory_order_relaxed);
+		const auto failures = switch_failures_.load(std::memory_order_relaxed);
+		const auto switch_time = switch_time_in_nanoseconds_.load(std::memory_order_relaxed);
+		const auto switches = misses - failures;
+
+		return {
+			{"hits", hits_.load(std::memory_order_relaxed)},
+			{"misses", misses},
+			{"switch_failures", failures},
+			{"total_switch_time_in_microseconds", switch_time / 1000},
+			{"average_switch_time_in_microseconds", (switches > 0) ? switch_time / switches / 1000 : 0}};
+	} // identity_switch_metrics::to_json
+
+	auto has_identity(const RcComm& _comm, const std::string& _username, const std::string& _zone) -> bool
+	{
+		// rc_switch_user updates the client user of the RcComm on success, so the RcComm always
+		// reflects the identity it acts on behalf of.
+		return std::string_view{_comm.clientUser.userName} == _username &&
+		       std::string_view{_comm.clientUser.rodsZone} == _zone;
+	} // has_identity
+
+	auto change_identity(RcComm& _comm, const std::string& _username, const std::string& _zone) -> int
+	{
+		auto& metrics = identity_switch_metrics::instance();
+
+		logging::trace("{}: Changing identity associated with connection to [{}].", __func__, _username);
+
+		const auto start = std::chrono::steady_clock::now();
+
+		if (const auto ec = call_switch_user(_comm, _username, _zone); ec < 0) {
+			metrics.record_switch_failure();
+			return ec;
+		}
+
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		metrics.record_switch(elapsed);
+
+		logging::trace(
+			"{}: Successfully changed identity associated with connection to [{}] in {} microseconds.",
+			__func__,
+			_username,
+			std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+		return 0;
+	} // change_identity
+
+	auto switch_identity(RcComm& _comm, const std::string& _username, const std::string& _zone) -> int
+	{
+		if (has_identity(_comm, _username, _zone)) {
+			logging::trace("{}: Connection already acts on behalf of [{}].", __func__, _username);
+			identity_switch_metrics::instance().record_hit();
+			return 0;
+		}
+
+		return change_identity(_comm, _username, _zone);
+	} // switch_identity
+
+	auto close_open_replicas(RcComm& _comm) -> int
+	{
+		// Switching to the identity the connection already carries only closes the replicas.
+		return call_switch_user(_comm, _comm.clientUser.userName, _comm.clientUser.rodsZone);
+	} // close_open_replicas
+} // namespace irods::http
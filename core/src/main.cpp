@@ -1,7 +1,12 @@
+#include "irods/private/s3_api/authentication.hpp"
 #include "irods/private/s3_api/common.hpp"
 #include "irods/private/s3_api/globals.hpp"
+#include "irods/private/s3_api/hmac.hpp"
+#include "irods/private/s3_api/identity.hpp"
 #include "irods/private/s3_api/log.hpp"
+#include "irods/private/s3_api/multipart_state.hpp"
 #include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/signing_key_cache.hpp"
 #include "irods/private/s3_api/transport.hpp"
 #include "irods/private/s3_api/version.hpp"
 #include "irods/private/s3_api/configuration.hpp"
@@ -20,6 +25,7 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/asio/signal_set.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/asio/thread_pool.hpp>
 #include <boost/beast/core.hpp>
@@ -212,6 +218,28 @@ constexpr auto default_jsonschema() -> std::string_view
                 "multipart_upload_part_files_directory": {
                     "type": "string"
                 },
+                "multipart_upload_part_staging_max_bytes": {
+                    "type": "integer",
+                    "minimum": 0
+                },
+                "multipart_upload_infer_part_size": {
+                    "type": "boolean"
+                },
+                "multipart_upload_journal_file": {
+                    "type": "string"
+                },
+                "multipart_upload_journal_compaction_threshold_in_bytes": {
+                    "type": "integer",
+                    "minimum": 0
+                },
+                "signing_key_cache_size": {
+                    "type": "integer",
+                    "minimum": 0
+                },
+                "metrics_log_interval_in_seconds": {
+                    "type": "integer",
+                    "minimum": 0
+                },
                 "requests": {
                     "type": "object",
                     "properties": {
@@ -358,6 +386,41 @@ constexpr auto default_jsonschema() -> std::string_view
                         "size"
                     ]
                 },
+                "streaming_connection_pool": {
+                    "type": "object",
+                    "properties": {
+                        "size": {
+                            "type": "integer",
+                            "minimum": 0
+                        },
+                        "refresh_timeout_in_seconds": {
+                            "type": "integer",
+                            "minimum": 1
+                        }
+                    }
+                },
+                "buffer_pool": {
+                    "type": "object",
+                    "properties": {
+                        "max_idle_bytes": {
+                            "type": "integer",
+                            "minimum": 0
+                        }
+                    }
+                },
+                "collection_cache": {
+                    "type": "object",
+                    "properties": {
+                        "size": {
+                            "type": "integer",
+                            "minimum": 0
+                        },
+                        "ttl_in_seconds": {
+                            "type": "integer",
+                            "minimum": 1
+                        }
+                    }
+                },
                 "resource": {
                     "type": "string"
                 },
@@ -365,9 +428,41 @@ constexpr auto default_jsonschema() -> std::string_view
                     "type": "integer",
                     "minimum": 1
                 },
+                "put_object_pipeline_depth": {
+                    "type": "integer",
+                    "minimum": 1
+                },
+                "put_object_parallel_write_streams": {
+                    "type": "integer",
+                    "minimum": 1
+                },
+                "put_object_parallel_write_threshold_in_bytes": {
+                    "type": "integer",
+                    "minimum": 0
+                },
                 "get_object_buffer_size_in_bytes": {
                     "type": "integer",
                     "minimum": 1
+                },
+                "get_object_pipeline_depth": {
+                    "type": "integer",
+                    "minimum": 1
+                },
+                "get_object_parallel_read_streams": {
+                    "type": "integer",
+                    "minimum": 1
+                },
+                "get_object_parallel_read_threshold_in_bytes": {
+                    "type": "integer",
+                    "minimum": 0
+                },
+                "complete_multipart_upload_parallel_part_writes": {
+                    "type": "integer",
+                    "minimum": 1
+                },
+                "complete_multipart_upload_max_part_writers": {
+                    "type": "integer",
+                    "minimum": 1
                 }
             },
             "required": [
@@ -417,6 +512,14 @@ auto print_configuration_template() -> void
         "region": "us-east-1",
 
         "multipart_upload_part_files_directory": "/tmp",
+        "multipart_upload_part_staging_max_bytes": 268435456,
+        "multipart_upload_infer_part_size": false,
+        "multipart_upload_journal_file": "",
+        "multipart_upload_journal_compaction_threshold_in_bytes": 67108864,
+
+        "signing_key_cache_size": 4096,
+
+        "metrics_log_interval_in_seconds": 300,
 
         "requests": {{
             "threads": 3,
@@ -459,10 +562,32 @@ auto print_configuration_template() -> void
             "refresh_when_resource_changes_detected": true
         }},
 
+        "streaming_connection_pool": {{
+            "size": 16,
+            "refresh_timeout_in_seconds": 600
+        }},
+
+        "buffer_pool": {{
+            "max_idle_bytes": 268435456
+        }},
+
+        "collection_cache": {{
+            "size": 4096,
+            "ttl_in_seconds": 60
+        }},
+
         "resource": "<string>",
 
-        "put_object_buffer_size_in_bytes": 8192,
-        "get_object_buffer_size_in_bytes": 8192
+        "put_object_buffer_size_in_bytes": 1048576,
+        "put_object_pipeline_depth": 2,
+        "put_object_parallel_write_streams": 1,
+        "put_object_parallel_write_threshold_in_bytes": 67108864,
+        "get_object_buffer_size_in_bytes": 1048576,
+        "get_object_pipeline_depth": 2,
+        "get_object_parallel_read_streams": 1,
+        "get_object_parallel_read_threshold_in_bytes": 67108864,
+        "complete_multipart_upload_parallel_part_writes": 4,
+        "complete_multipart_upload_max_part_writers": 16
     }}
 }}
 )");
@@ -678,6 +803,109 @@ auto init_irods_connection_pool(const json& _config) -> std::unique_ptr<irods::c
 		opts);
 } // init_irods_connection_pool
 
+auto init_streaming_connection_pool(const json& _config) -> std::unique_ptr<irods::http::streaming_connection_pool>
+{
+	const auto& client = _config.at("irods_client");
+	const auto& rodsadmin = client.at("proxy_admin_account");
+
+	irods::http::streaming_connection_pool_options opts;
+	opts.host = client.at("host").get<std::string>();
+	opts.port = client.at("port").get<int>();
+	opts.zone = client.at("zone").get<std::string>();
+	opts.proxy_username = rodsadmin.at("username").get<std::string>();
+	opts.proxy_password = rodsadmin.at("password").get<std::string>();
+	opts.size = client.value(json::json_pointer{"/streaming_connection_pool/size"}, std::size_t{16});
+	opts.refresh_timeout = std::chrono::seconds{
+		client.value(json::json_pointer{"/streaming_connection_pool/refresh_timeout_in_seconds"}, 600)};
+	opts.enable_4_2_compatibility = client.at("enable_4_2_compatibility").get<bool>();
+
+	return std::make_unique<irods::http::streaming_connection_pool>(std::move(opts));
+} // init_streaming_connection_pool
+
+auto init_buffer_pool(const json& _config) -> std::unique_ptr<irods::http::buffer_pool>
+{
+	irods::http::buffer_pool_options opts;
+	opts.max_idle_bytes =
+		_config.value(json::json_pointer{"/irods_client/buffer_pool/max_idle_bytes"}, std::size_t{268435456});
+
+	return std::make_unique<irods::http::buffer_pool>(opts);
+} // init_buffer_pool
+
+auto init_collection_cache(const json& _config) -> std::unique_ptr<irods::s3::collection_cache>
+{
+	const auto size = _config.value(json::json_pointer{"/irods_client/collection_cache/size"}, std::size_t{4096});
+	const auto ttl = std::chrono::seconds{
+		_config.value(json::json_pointer{"/irods_client/collection_cache/ttl_in_seconds"}, 60)};
+
+	return std::make_unique<irods::s3::collection_cache>(size, ttl);
+} // init_collection_cache
+
+auto init_part_writer_permits(const json& _config) -> std::unique_ptr<irods::http::permit_pool>
+{
+	const auto size = _config.value(
+		json::json_pointer{"/irods_client/complete_multipart_upload_max_part_writers"}, std::size_t{16});
+
+	return std::make_unique<irods::http::permit_pool>(size);
+} // init_part_writer_permits
+
+auto init_part_staging_area(const json& _config) -> std::unique_ptr<irods::s3::part_staging_area>
+{
+	const auto max_bytes = _config.value(
+		json::json_pointer{"/s3_server/multipart_upload_part_staging_max_bytes"}, std::size_t{268435456});
+
+	return std::make_unique<irods::s3::part_staging_area>(max_bytes);
+} // init_part_staging_area
+
+auto init_multipart_journal(const json& _config) -> std::unique_ptr<irods::s3::multipart_journal>
+{
+	irods::s3::multipart_journal_options options;
+	options.path = _config.value(json::json_pointer{"/s3_server/multipart_upload_journal_file"}, std::string{});
+	options.compaction_threshold_in_bytes = _config.value(
+		json::json_pointer{"/s3_server/multipart_upload_journal_compaction_threshold_in_bytes"},
+		std::size_t{67108864});
+
+	auto journal = std::make_unique<irods::s3::multipart_journal>(std::move(options));
+
+	// Resume the multipart uploads which were in progress when the server stopped.
+	auto uploads = journal->take_restored_uploads();
+	if (!uploads.empty()) {
+		logging::info("Restoring {} multipart uploads from the multipart upload journal.", uploads.size());
+		irods::s3::api::multipart_global_state::restore(std::move(uploads));
+	}
+
+	return journal;
+} // init_multipart_journal
+
+// Logs the metrics of the caches and pools used by the request handlers.
+auto log_metrics() -> void
+{
+	namespace globals = irods::http::globals;
+
+	logging::info("Identity switch metrics: {}", irods::http::identity_switch_metrics::instance().to_json().dump());
+	logging::info(
+		"Signing key cache metrics: {}", irods::s3::authentication::get_signing_key_cache().to_json().dump());
+	logging::info("Buffer pool metrics: {}", globals::buffer_pool().to_json().dump());
+	logging::info("Collection cache metrics: {}", globals::collection_cache().to_json().dump());
+	logging::info("Part staging area metrics: {}", globals::part_staging_area().to_json().dump());
+	logging::info("Part writer permit metrics: {}", globals::part_writer_permits().to_json().dump());
+	logging::info("Multipart upload journal metrics: {}", globals::multipart_journal().to_json().dump());
+	logging::info("Multipart upload index metrics: {}", globals::multipart_upload_index().to_json().dump());
+} // log_metrics
+
+// Logs the metrics every _interval until the io_context is stopped.
+auto schedule_metrics_logging(net::steady_timer& _timer, std::chrono::seconds _interval) -> void
+{
+	_timer.expires_after(_interval);
+	_timer.async_wait([&_timer, _interval](const beast::error_code& _ec) {
+		if (_ec) {
+			return;
+		}
+
+		log_metrics();
+		schedule_metrics_logging(_timer, _interval);
+	});
+} // schedule_metrics_logging
+
 auto init_bucket_mapping(const json& _mapping_config) -> void
 {
 	const auto& lib_path = _mapping_config.at("plugin_path").get_ref<const std::string&>();
@@ -819,6 +1047,9 @@ auto main(int _argc, char* _argv[]) -> int
 		spdlog::set_pattern("[%Y-%m-%d %T.%e] [P:%P] [%^%l%$] [T:%t] %v");
 
 		logging::info("Initializing server.");
+		logging::debug(
+			"Using the [{}] digest backend.",
+			irods::s3::authentication::to_string(irods::s3::authentication::default_digest_backend()));
 
 		// TODO For LONG running tasks, see the following:
 		//
@@ -853,6 +1084,47 @@ auto main(int _argc, char* _argv[]) -> int
 			irods::http::globals::set_connection_pool(*conn_pool);
 		}
 
+		// Data transfers (e.g. GetObject, PutObject) use a separate pool so that long-running
+		// transfers do not exhaust the connections needed by the other endpoints.
+		logging::trace("Initializing iRODS streaming connection pool.");
+		auto streaming_conn_pool = init_streaming_connection_pool(config);
+		irods::http::globals::set_streaming_connection_pool(*streaming_conn_pool);
+
+		// GetObject, PutObject, and CompleteMultipartUpload borrow their transfer buffers from a
+		// shared pool instead of allocating them for every request.
+		logging::trace("Initializing buffer pool.");
+		auto buffer_pool = init_buffer_pool(config);
+		irods::http::globals::set_buffer_pool(*buffer_pool);
+
+		// PutObject remembers which collections exist so that it does not have to create the
+		// parent collection of every object it writes.
+		logging::trace("Initializing collection cache.");
+		auto collection_cache = init_collection_cache(config);
+		irods::http::globals::set_collection_cache(*collection_cache);
+
+		// UploadPart keeps parts whose offsets are not known yet in memory, so that they can be
+		// written to iRODS without passing through the part files directory.
+		logging::trace("Initializing multipart upload part staging area.");
+		auto part_staging_area = init_part_staging_area(config);
+		irods::http::globals::set_part_staging_area(*part_staging_area);
+
+		// CompleteMultipartUpload bounds the number of streams writing parts across all uploads,
+		// each of which holds an iRODS connection.
+		logging::trace("Initializing part writer permits.");
+		auto part_writer_permits = init_part_writer_permits(config);
+		irods::http::globals::set_part_writer_permits(*part_writer_permits);
+
+		// ListMultipartUploads pages through the uploads in progress using this index. It must
+		// exist before the journal restores the uploads into it.
+		logging::trace("Initializing multipart upload index.");
+		irods::s3::multipart_upload_index multipart_upload_index;
+		irods::http::globals::set_multipart_upload_index(multipart_upload_index);
+
+		// The state of multipart uploads is journaled so that uploads survive a restart.
+		logging::trace("Initializing multipart upload journal.");
+		auto multipart_journal = init_multipart_journal(config);
+		irods::http::globals::set_multipart_journal(*multipart_journal);
+
 		// The io_context is required for all I/O.
 		logging::trace("Initializing HTTP components.");
 		net::io_context ioc{request_thread_count};
@@ -874,6 +1146,12 @@ auto main(int _argc, char* _argv[]) -> int
 			ioc.stop();
 		});
 
+		// The metrics are logged periodically so that they can be observed while the server runs.
+		net::steady_timer metrics_timer{ioc};
+		if (const auto interval = s3_server_config.value("metrics_log_interval_in_seconds", 300); interval > 0) {
+			schedule_metrics_logging(metrics_timer, std::chrono::seconds{interval});
+		}
+
 		// Launch the requested number of dedicated backgroup I/O threads.
 		// These threads are used for long running tasks (e.g. reading/writing bytes, database, etc.)
 		logging::trace("Initializing thread pool for long running I/O tasks.");
@@ -907,6 +1185,8 @@ auto main(int _argc, char* _argv[]) -> int
 		logging::trace("Waiting for I/O thread pool to shut down.");
 		io_threads.join();
 
+		log_metrics();
+
 		logging::trace("Releasing resources for user mapping plugin.");
 		bool plugin_close_error = false;
 		auto um_close = irods::http::globals::user_mapping_library().get<int()>("user_mapping_close");
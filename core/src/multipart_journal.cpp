@@ -0,0 +1,625 @@
+#include "irods/private/s3_api/multipart_journal.hpp"
+
+#include "irods/private/s3_api/checksum.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+namespace
+{
+	// Identifies a journal file and the version of its format.
+	constexpr std::string_view journal_magic{"IRS3MPJ1"};
+
+	// The smallest size of the file. The file grows by doubling.
+	constexpr std::size_t min_capacity = std::size_t{1} * 1024 * 1024;
+
+	// The size and checksum preceding each payload.
+	constexpr std::size_t record_header_size = 2 * sizeof(std::uint32_t);
+
+	[[noreturn]] auto throw_system_error(const std::string& _what) -> void
+	{
+		throw std::system_error{errno, std::generic_category(), _what};
+	} // throw_system_error
+
+	template <typename T>
+	auto append_value(std::vector<char>& _out, T _value) -> void
+	{
+		const auto* p = reinterpret_cast<const char*>(&_value);
+		_out.insert(_out.end(), p, p + sizeof(T));
+	} // append_value
+
+	template <typename T>
+	auto read_value(std::string_view& _in, T& _value) -> bool
+	{
+		if (_in.size() < sizeof(T)) {
+			return false;
+		}
+
+		std::memcpy(&_value, _in.data(), sizeof(T));
+		_in.remove_prefix(sizeof(T));
+
+		return true;
+	} // read_value
+
+	// Appends a string preceded by its 16-bit size.
+	auto append_field(std::vector<char>& _out, std::string_view _field) -> void
+	{
+		append_value(_out, static_cast<std::uint16_t>(_field.size()));
+		_out.insert(_out.end(), _field.begin(), _field.end());
+	} // append_field
+
+	auto read_field(std::string_view& _in, std::string& _field) -> bool
+	{
+		std::uint16_t size{};
+		if (!read_value(_in, size) || _in.size() < size) {
+			return false;
+		}
+
+		_field.assign(_in.substr(0, size));
+		_in.remove_prefix(size);
+
+		return true;
+	} // read_field
+
+	auto to_milliseconds(std::chrono::system_clock::time_point _time) -> std::uint64_t
+	{
+		return static_cast<std::uint64_t>(
+			std::chrono::duration_cast<std::chrono::milliseconds>(_time.time_since_epoch()).count());
+	} // to_milliseconds
+
+	auto from_milliseconds(std::uint64_t _ms) -> std::chrono::system_clock::time_point
+	{
+		return std::chrono::system_clock::time_point{
+			std::chrono::milliseconds{static_cast<std::chrono::milliseconds::rep>(_ms)}};
+	} // from_milliseconds
+
+	// The detail of an upload_created record is the bucket, the key and the owner of the upload.
+	// The initiation time is the value of the record.
+	auto encode_upload_entry(const irods::s3::multipart_upload_entry& _upload) -> std::vector<char>
+	{
+		std::vector<char> detail;
+		append_field(detail, _upload.bucket);
+		append_field(detail, _upload.key);
+		append_field(detail, _upload.owner);
+		return detail;
+	} // encode_upload_entry
+
+	// The detail of a part_uploaded record is the time the part was received followed by its ETag.
+	// The size of the part is the value of the record.
+	auto encode_uploaded_part(const irods::s3::multipart_upload_part& _part) -> std::vector<char>
+	{
+		std::vector<char> detail;
+		append_value(detail, to_milliseconds(_part.last_modified));
+		detail.insert(detail.end(), _part.etag.begin(), _part.etag.end());
+		return detail;
+	} // encode_uploaded_part
+
+	// Writes all of _data to _fd. Returns false on failure.
+	auto write_all(int _fd, const char* _data, std::size_t _size) -> bool
+	{
+		while (_size > 0) {
+			const auto n = ::write(_fd, _data, _size);
+
+			if (n < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return false;
+			}
+
+			_data += n;
+			_size -= static_cast<std::size_t>(n);
+		}
+
+		return true;
+	} // write_all
+} // anonymous namespace
+
+namespace irods::s3
+{
+	multipart_journal::multipart_journal(multipart_journal_options _options)
+		: options_{std::move(_options)}
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		fd_ = ::open(options_.path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+		if (fd_ < 0) {
+			throw_system_error("Could not open multipart journal [" + options_.path + "]");
+		}
+
+		try {
+			replay();
+		}
+		catch (...) {
+			unmap();
+			::close(fd_);
+			throw;
+		}
+	} // constructor
+
+	multipart_journal::~multipart_journal()
+	{
+		unmap();
+
+		if (fd_ >= 0) {
+			::close(fd_);
+		}
+	} // destructor
+
+	auto multipart_journal::take_restored_uploads() -> std::unordered_map<std::string, upload_state>
+	{
+		std::scoped_lock lock{mtx_};
+		return std::exchange(restored_, {});
+	} // take_restored_uploads
+
+	auto multipart_journal::record_upload_created(const multipart_upload_entry& _upload) -> void
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		const auto detail = encode_upload_entry(_upload);
+
+		std::scoped_lock lock{mtx_};
+		append(
+			record_type::upload_created,
+			_upload.upload_id,
+			0,
+			to_milliseconds(_upload.initiated),
+			{detail.data(), detail.size()});
+	} // record_upload_created
+
+	auto multipart_journal::record_part_size(std::string_view _upload_id, std::uint64_t _part_size) -> void
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		std::scoped_lock lock{mtx_};
+		append(record_type::part_size, _upload_id, 0, _part_size);
+	} // record_part_size
+
+	auto multipart_journal::record_part(std::string_view _upload_id, unsigned int _part_number, std::uint64_t _size)
+		-> void
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		std::scoped_lock lock{mtx_};
+		append(record_type::part, _upload_id, _part_number, _size);
+	} // record_part
+
+	auto multipart_journal::record_part_uploaded(
+		std::string_view _upload_id,
+		unsigned int _part_number,
+		const multipart_upload_part& _part) -> void
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		const auto detail = encode_uploaded_part(_part);
+
+		std::scoped_lock lock{mtx_};
+		append(record_type::part_uploaded, _upload_id, _part_number, _part.size, {detail.data(), detail.size()});
+	} // record_part_uploaded
+
+	auto multipart_journal::record_staged_part(std::string_view _upload_id, unsigned int _part_number) -> void
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		std::scoped_lock lock{mtx_};
+		append(record_type::staged_part, _upload_id, _part_number);
+	} // record_staged_part
+
+	auto multipart_journal::record_upload_ended(std::string_view _upload_id) -> void
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		std::scoped_lock lock{mtx_};
+
+		// Nothing is known about the upload, so there is nothing to forget.
+		if (!uploads_.contains(std::string{_upload_id})) {
+			return;
+		}
+
+		append(record_type::upload_ended, _upload_id);
+	} // record_upload_ended
+
+	auto multipart_journal::to_json() const -> nlohmann::json
+	{
+		std::scoped_lock lock{mtx_};
+
+		return {
+			{"enabled", enabled()},
+			{"size_in_bytes", tail_},
+			{"capacity_in_bytes", capacity_},
+			{"uploads", uploads_.size()},
+			{"appended_records", appended_records_},
+			{"failed_appends", failed_appends_},
+			{"compactions", compactions_}};
+	} // to_json
+
+	auto multipart_journal::encode(
+		std::vector<char>& _out,
+		record_type _type,
+		std::string_view _upload_id,
+		unsigned int _part_number,
+		std::uint64_t _value,
+		std::string_view _detail) -> void
+	{
+		const auto header_offset = _out.size();
+		_out.resize(header_offset + record_header_size);
+
+		append_value(_out, static_cast<std::uint8_t>(_type));
+		append_value(_out, static_cast<std::uint16_t>(_upload_id.size()));
+		_out.insert(_out.end(), _upload_id.begin(), _upload_id.end());
+		append_value(_out, static_cast<std::uint32_t>(_part_number));
+		append_value(_out, _value);
+		_out.insert(_out.end(), _detail.begin(), _detail.end());
+
+		const std::string_view payload{
+			_out.data() + header_offset + record_header_size, _out.size() - header_offset - record_header_size};
+		const auto size = static_cast<std::uint32_t>(payload.size());
+		const auto crc = crc32c(0, payload);
+
+		std::memcpy(_out.data() + header_offset, &size, sizeof(size));
+		std::memcpy(_out.data() + header_offset + sizeof(size), &crc, sizeof(crc));
+	} // encode
+
+	auto multipart_journal::encode_upload(std::vector<char>& _out, std::string_view _upload_id, const upload_type& _upload)
+		-> void
+	{
+		if (_upload.entry) {
+			const auto detail = encode_upload_entry(*_upload.entry);
+			encode(
+				_out,
+				record_type::upload_created,
+				_upload_id,
+				0,
+				to_milliseconds(_upload.entry->initiated),
+				{detail.data(), detail.size()});
+		}
+
+		if (_upload.part_size) {
+			encode(_out, record_type::part_size, _upload_id, 0, *_upload.part_size);
+		}
+
+		for (const auto& [part_number, part] : _upload.parts) {
+			encode(_out, record_type::part, _upload_id, part_number, part.size);
+
+			if (part.uploaded) {
+				const auto detail = encode_uploaded_part(*part.uploaded);
+				encode(
+					_out,
+					record_type::part_uploaded,
+					_upload_id,
+					part_number,
+					part.uploaded->size,
+					{detail.data(), detail.size()});
+			}
+
+			if (part.staged) {
+				encode(_out, record_type::staged_part, _upload_id, part_number);
+			}
+		}
+	} // encode_upload
+
+	auto multipart_journal::apply(std::string_view _payload) -> bool
+	{
+		std::uint8_t type{};
+		std::uint16_t upload_id_size{};
+		std::uint32_t part_number{};
+		std::uint64_t value{};
+
+		if (!read_value(_payload, type) || !read_value(_payload, upload_id_size) || _payload.size() < upload_id_size) {
+			return false;
+		}
+
+		std::string upload_id{_payload.substr(0, upload_id_size)};
+		_payload.remove_prefix(upload_id_size);
+
+		if (!read_value(_payload, part_number) || !read_value(_payload, value)) {
+			return false;
+		}
+
+		// Whatever follows the fixed fields is the detail of the record. Only the records which
+		// describe an upload or an uploaded part have one.
+		auto detail = _payload;
+
+		switch (static_cast<record_type>(type)) {
+			case record_type::part_size:
+				if (!detail.empty()) {
+					return false;
+				}
+				uploads_[std::move(upload_id)].part_size = value;
+				return true;
+
+			case record_type::part: {
+				if (!detail.empty()) {
+					return false;
+				}
+
+				// The part is being uploaded again, unless a part held in memory was written.
+				auto& part = uploads_[std::move(upload_id)].parts[part_number];
+				if (!part.staged || part.size != value) {
+					part.uploaded.reset();
+				}
+				part.size = value;
+				part.staged = false;
+				return true;
+			}
+
+			case record_type::staged_part:
+				if (!detail.empty()) {
+					return false;
+				}
+				if (const auto iter = uploads_.find(upload_id); iter != uploads_.end()) {
+					if (const auto part = iter->second.parts.find(part_number); part != iter->second.parts.end()) {
+						part->second.staged = true;
+					}
+				}
+				return true;
+
+			case record_type::upload_ended:
+				if (!detail.empty()) {
+					return false;
+				}
+				uploads_.erase(upload_id);
+				return true;
+
+			case record_type::upload_created: {
+				multipart_upload_entry entry;
+				entry.upload_id = upload_id;
+				entry.initiated = from_milliseconds(value);
+
+				if (!read_field(detail, entry.bucket) || !read_field(detail, entry.key) ||
+				    !read_field(detail, entry.owner) || !detail.empty())
+				{
+					return false;
+				}
+
+				uploads_[std::move(upload_id)].entry = std::move(entry);
+				return true;
+			}
+
+			case record_type::part_uploaded: {
+				std::uint64_t last_modified{};
+				if (!read_value(detail, last_modified)) {
+					return false;
+				}
+
+				auto& part = uploads_[std::move(upload_id)].parts[part_number];
+				part.size = value;
+				part.uploaded = multipart_upload_part{
+					.size = value, .etag = std::string{detail}, .last_modified = from_milliseconds(last_modified)};
+				return true;
+			}
+		}
+
+		return false;
+	} // apply
+
+	auto multipart_journal::replay() -> void
+	{
+		struct stat st{};
+		if (::fstat(fd_, &st) != 0) {
+			throw_system_error("Could not stat multipart journal [" + options_.path + "]");
+		}
+
+		const auto file_size = static_cast<std::size_t>(st.st_size);
+		map(std::max(file_size, min_capacity));
+
+		if (file_size == 0) {
+			std::memcpy(data_, journal_magic.data(), journal_magic.size());
+		}
+		else if (file_size < journal_magic.size() ||
+		         std::string_view{data_, journal_magic.size()} != journal_magic)
+		{
+			errno = EINVAL;
+			throw_system_error("[" + options_.path + "] is not a multipart journal");
+		}
+
+		// Replay until the first record which is empty, cut short, or corrupt.
+		auto pos = journal_magic.size();
+
+		while (pos + record_header_size <= capacity_) {
+			std::uint32_t size{};
+			std::uint32_t crc{};
+			std::memcpy(&size, data_ + pos, sizeof(size));
+			std::memcpy(&crc, data_ + pos + sizeof(size), sizeof(crc));
+
+			if (size == 0 || pos + record_header_size + size > capacity_) {
+				break;
+			}
+
+			const std::string_view payload{data_ + pos + record_header_size, size};
+			if (crc32c(0, payload) != crc || !apply(payload)) {
+				break;
+			}
+
+			pos += record_header_size + size;
+		}
+
+		// Clear the remains of a record which was being written when the server stopped, so that
+		// it is not mistaken for part of the records appended next.
+		tail_ = pos;
+		std::memset(data_ + tail_, 0, capacity_ - tail_);
+
+		// Parts held in memory did not survive the restart.
+		for (auto& [upload_id, upload] : uploads_) {
+			std::erase_if(upload.parts, [](const auto& _part) { return _part.second.staged; });
+
+			auto& restored = restored_[upload_id];
+			restored.part_size = upload.part_size;
+			restored.entry = upload.entry;
+			for (const auto& [part_number, part] : upload.parts) {
+				restored.part_sizes.emplace(part_number, part.size);
+
+				if (part.uploaded) {
+					restored.uploaded_parts.emplace(part_number, *part.uploaded);
+				}
+			}
+		}
+
+		compact_at_ = options_.compaction_threshold_in_bytes;
+		compact_if_needed();
+	} // replay
+
+	auto multipart_journal::append(
+		record_type _type,
+		std::string_view _upload_id,
+		unsigned int _part_number,
+		std::uint64_t _value,
+		std::string_view _detail) -> void
+	{
+		std::vector<char> record;
+		encode(record, _type, _upload_id, _part_number, _value, _detail);
+
+		if (!apply({record.data() + record_header_size, record.size() - record_header_size})) {
+			return;
+		}
+
+		if (!reserve(record.size())) {
+			++failed_appends_;
+			return;
+		}
+
+		std::memcpy(data_ + tail_, record.data(), record.size());
+		tail_ += record.size();
+		++appended_records_;
+
+		compact_if_needed();
+	} // append
+
+	auto multipart_journal::reserve(std::size_t _size) -> bool
+	{
+		if (!data_) {
+			return false;
+		}
+
+		if (tail_ + _size <= capacity_) {
+			return true;
+		}
+
+		const auto capacity = std::max(capacity_ * 2, tail_ + _size);
+
+		if (::ftruncate(fd_, static_cast<off_t>(capacity)) != 0) {
+			return false;
+		}
+
+		void* p = ::mremap(data_, capacity_, capacity, MREMAP_MAYMOVE);
+		if (p == MAP_FAILED) {
+			return false;
+		}
+
+		data_ = static_cast<char*>(p);
+		capacity_ = capacity;
+
+		return true;
+	} // reserve
+
+	auto multipart_journal::compact_if_needed() -> void
+	{
+		if (tail_ < compact_at_) {
+			return;
+		}
+
+		std::vector<char> image(journal_magic.begin(), journal_magic.end());
+
+		for (const auto& [upload_id, upload] : uploads_) {
+			encode_upload(image, upload_id, upload);
+		}
+
+		// Compacting a journal which is mostly live would not be worth the copy.
+		if (image.size() * 2 > tail_) {
+			compact_at_ = tail_ + std::max(options_.compaction_threshold_in_bytes, image.size());
+			return;
+		}
+
+		// Write the compacted journal to a new file and move it into place, so that the journal
+		// is intact if the server stops part way through.
+		const auto tmp_path = options_.path + ".tmp";
+		const auto capacity = std::max(min_capacity, image.size() * 2);
+
+		const int fd = ::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+		if (fd < 0) {
+			compact_at_ = tail_ + options_.compaction_threshold_in_bytes;
+			return;
+		}
+
+		if (!write_all(fd, image.data(), image.size()) || ::ftruncate(fd, static_cast<off_t>(capacity)) != 0 ||
+		    ::fsync(fd) != 0 || ::rename(tmp_path.c_str(), options_.path.c_str()) != 0)
+		{
+			::close(fd);
+			::unlink(tmp_path.c_str());
+			compact_at_ = tail_ + options_.compaction_threshold_in_bytes;
+			return;
+		}
+
+		unmap();
+		::close(fd_);
+		fd_ = fd;
+
+		tail_ = image.size();
+
+		try {
+			map(capacity);
+		}
+		catch (const std::system_error&) {
+			// Appends fail until the server is restarted, which replays the compacted journal.
+			compact_at_ = SIZE_MAX;
+			return;
+		}
+
+		compact_at_ = std::max(options_.compaction_threshold_in_bytes, image.size() * 2);
+		++compactions_;
+	} // compact_if_needed
+
+	auto multipart_journal::map(std::size_t _capacity) -> void
+	{
+		struct stat st{};
+		if (::fstat(fd_, &st) != 0) {
+			throw_system_error("Could not stat multipart journal [" + options_.path + "]");
+		}
+
+		if (static_cast<std::size_t>(st.st_size) < _capacity && ::ftruncate(fd_, static_cast<off_t>(_capacity)) != 0)
+		{
+			throw_system_error("Could not grow multipart journal [" + options_.path + "]");
+		}
+
+		void* p = ::mmap(nullptr, _capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+		if (p == MAP_FAILED) {
+			throw_system_error("Could not map multipart journal [" + options_.path + "]");
+		}
+
+		data_ = static_cast<char*>(p);
+		capacity_ = _capacity;
+	} // map
+
+	auto multipart_journal::unmap() noexcept -> void
+	{
+		if (data_) {
+			::munmap(data_, capacity_);
+			data_ = nullptr;
+			capacity_ = 0;
+		}
+	} // unmap
+} // namespace irods::s3
@@ -0,0 +1,202 @@
+#include "irods/private/s3_api/multipart_upload_index.hpp"
+
+#include <limits>
+#include <utility>
+
+namespace
+{
+	using clock_type = std::chrono::system_clock;
+
+	constexpr auto min_time = std::numeric_limits<std::int64_t>::min();
+
+	auto to_nanoseconds(clock_type::time_point _time) -> std::int64_t
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(_time.time_since_epoch()).count();
+	} // to_nanoseconds
+
+	auto from_nanoseconds(std::int64_t _ns) -> clock_type::time_point
+	{
+		return clock_type::time_point{std::chrono::duration_cast<clock_type::duration>(std::chrono::nanoseconds{_ns})};
+	} // from_nanoseconds
+
+	// Returns the smallest string which is greater than every string beginning with _prefix, or an
+	// empty std::optional if there is none (i.e. _prefix consists of '\xff' bytes only).
+	auto prefix_successor(std::string_view _prefix) -> std::optional<std::string>
+	{
+		std::string successor{_prefix};
+
+		while (!successor.empty()) {
+			auto& last = reinterpret_cast<unsigned char&>(successor.back());
+
+			if (last != std::numeric_limits<unsigned char>::max()) {
+				++last;
+				return successor;
+			}
+
+			successor.pop_back();
+		}
+
+		return std::nullopt;
+	} // prefix_successor
+} // anonymous namespace
+
+namespace irods::s3
+{
+	auto multipart_upload_index::insert(multipart_upload_entry _upload) -> void
+	{
+		std::scoped_lock lock{mtx_};
+
+		if (order_keys_.contains(_upload.upload_id)) {
+			return;
+		}
+
+		order_key key{
+			std::move(_upload.bucket), std::move(_upload.key), to_nanoseconds(_upload.initiated), _upload.upload_id};
+
+		order_keys_.emplace(std::move(_upload.upload_id), key);
+		uploads_.emplace(std::move(key), std::move(_upload.owner));
+	} // insert
+
+	auto multipart_upload_index::erase(const std::string& _upload_id) -> void
+	{
+		std::scoped_lock lock{mtx_};
+
+		if (const auto iter = order_keys_.find(_upload_id); iter != order_keys_.end()) {
+			uploads_.erase(iter->second);
+			order_keys_.erase(iter);
+		}
+	} // erase
+
+	auto multipart_upload_index::find(const std::string& _upload_id) const -> std::optional<multipart_upload_entry>
+	{
+		std::scoped_lock lock{mtx_};
+
+		const auto iter = order_keys_.find(_upload_id);
+		if (iter == order_keys_.end()) {
+			return std::nullopt;
+		}
+
+		const auto& [bucket, key, initiated, upload_id] = iter->second;
+
+		return multipart_upload_entry{
+			.bucket = bucket,
+			.key = key,
+			.upload_id = upload_id,
+			.owner = uploads_.at(iter->second),
+			.initiated = from_nanoseconds(initiated)};
+	} // find
+
+	auto multipart_upload_index::list(const multipart_upload_listing_options& _options) const
+		-> multipart_upload_listing
+	{
+		multipart_upload_listing listing;
+
+		if (_options.max_uploads == 0) {
+			return listing;
+		}
+
+		std::scoped_lock lock{mtx_};
+
+		auto iter = first_upload_from(_options.bucket, std::string{_options.prefix});
+
+		if (!_options.key_marker.empty()) {
+			std::optional<decltype(iter)> after_marker;
+
+			// Resume after the upload which ended the previous page.
+			if (!_options.upload_id_marker.empty()) {
+				if (const auto marker = order_keys_.find(std::string{_options.upload_id_marker});
+				    marker != order_keys_.end() && std::get<0>(marker->second) == _options.bucket &&
+				    std::get<1>(marker->second) == _options.key_marker)
+				{
+					after_marker = uploads_.upper_bound(marker->second);
+				}
+			}
+
+			// Otherwise resume after every upload of the key marker, or after every key rolled up
+			// into the key marker if the previous page ended with a common prefix.
+			if (!after_marker) {
+				const bool marker_is_common_prefix =
+					!_options.delimiter.empty() && _options.key_marker.starts_with(_options.prefix) &&
+					_options.key_marker.size() >= _options.prefix.size() + _options.delimiter.size() &&
+					_options.key_marker.ends_with(_options.delimiter);
+
+				if (marker_is_common_prefix) {
+					after_marker = first_upload_after_prefix(_options.bucket, _options.key_marker);
+				}
+				else {
+					// The key marker followed by a null byte is the smallest key greater than it.
+					after_marker = first_upload_from(_options.bucket, std::string{_options.key_marker} + '\0');
+				}
+			}
+
+			if (*after_marker == uploads_.end() || (iter != uploads_.end() && iter->first < (*after_marker)->first)) {
+				iter = *after_marker;
+			}
+		}
+
+		std::size_t count = 0;
+
+		while (iter != uploads_.end()) {
+			const auto& [bucket, key, initiated, upload_id] = iter->first;
+
+			if (bucket != _options.bucket || !key.starts_with(_options.prefix)) {
+				break;
+			}
+
+			if (count == _options.max_uploads) {
+				listing.is_truncated = true;
+				break;
+			}
+
+			++count;
+
+			if (!_options.delimiter.empty()) {
+				if (const auto pos = key.find(_options.delimiter, _options.prefix.size()); pos != std::string::npos) {
+					auto common_prefix = key.substr(0, pos + _options.delimiter.size());
+					iter = first_upload_after_prefix(bucket, common_prefix);
+
+					listing.next_key_marker = common_prefix;
+					listing.next_upload_id_marker.clear();
+					listing.common_prefixes.push_back(std::move(common_prefix));
+					continue;
+				}
+			}
+
+			listing.uploads.push_back(
+				{.bucket = bucket,
+			     .key = key,
+			     .upload_id = upload_id,
+			     .owner = iter->second,
+			     .initiated = from_nanoseconds(initiated)});
+
+			listing.next_key_marker = key;
+			listing.next_upload_id_marker = upload_id;
+			++iter;
+		}
+
+		return listing;
+	} // list
+
+	auto multipart_upload_index::to_json() const -> nlohmann::json
+	{
+		std::scoped_lock lock{mtx_};
+		return {{"uploads", uploads_.size()}};
+	} // to_json
+
+	auto multipart_upload_index::first_upload_from(std::string_view _bucket, std::string _key) const
+		-> std::map<order_key, std::string>::const_iterator
+	{
+		return uploads_.lower_bound(order_key{std::string{_bucket}, std::move(_key), min_time, std::string{}});
+	} // first_upload_from
+
+	auto multipart_upload_index::first_upload_after_prefix(std::string_view _bucket, std::string_view _prefix) const
+		-> std::map<order_key, std::string>::const_iterator
+	{
+		if (auto successor = prefix_successor(_prefix); successor) {
+			return first_upload_from(_bucket, std::move(*successor));
+		}
+
+		// Every key of the bucket begins with the prefix. Move on to the next bucket.
+		return first_upload_from(std::string{_bucket} + '\0', std::string{});
+	} // first_upload_after_prefix
+} // namespace irods::s3
@@ -0,0 +1,130 @@
+#include "irods/private/s3_api/part_size_index.hpp"
+
+#include <bit>
+#include <charconv>
+#include <system_error>
+
+namespace
+{
+	// Returns the lowest set bit of _i, which is the length of the range covered by node _i of a
+	// Fenwick tree.
+	constexpr auto lowest_bit(std::size_t _i) noexcept -> std::size_t
+	{
+		return _i & (~_i + 1);
+	} // lowest_bit
+} // anonymous namespace
+
+namespace irods::s3
+{
+	auto parse_part_number(std::string_view _value) -> std::optional<unsigned int>
+	{
+		unsigned int part_number = 0;
+		const auto [ptr, ec] = std::from_chars(_value.data(), _value.data() + _value.size(), part_number);
+
+		if (ec != std::errc{} || ptr != _value.data() + _value.size()) {
+			return std::nullopt;
+		}
+
+		if (part_number == 0 || part_number > max_part_number) {
+			return std::nullopt;
+		}
+
+		return part_number;
+	} // parse_part_number
+
+	auto part_size_index::set(unsigned int _part_number, std::uint64_t _size) -> void
+	{
+		if (_part_number == 0 || _part_number > max_part_number) {
+			return;
+		}
+
+		if (_part_number >= sizes_.size()) {
+			grow(_part_number);
+		}
+
+		auto& slot = sizes_[_part_number];
+		const auto old_size = slot.value_or(0);
+		const std::uint64_t count_delta = slot ? 0 : 1;
+
+		if (!slot) {
+			++part_count_;
+		}
+		slot = _size;
+
+		// Unsigned arithmetic wraps, so a smaller size is applied as a negative delta.
+		const auto size_delta = _size - old_size;
+
+		for (std::size_t i = _part_number; i < size_tree_.size(); i += lowest_bit(i)) {
+			size_tree_[i] += size_delta;
+			count_tree_[i] += count_delta;
+		}
+	} // set
+
+	auto part_size_index::get(unsigned int _part_number) const -> std::optional<std::uint64_t>
+	{
+		if (_part_number == 0 || _part_number >= sizes_.size()) {
+			return std::nullopt;
+		}
+
+		return sizes_[_part_number];
+	} // get
+
+	auto part_size_index::offset_of(unsigned int _part_number) const -> std::optional<std::uint64_t>
+	{
+		if (_part_number == 0) {
+			return std::nullopt;
+		}
+
+		const auto preceding = _part_number - 1;
+
+		if (preceding >= sizes_.size() || prefix_count(preceding) != preceding) {
+			return std::nullopt;
+		}
+
+		return prefix_sum(preceding);
+	} // offset_of
+
+	auto part_size_index::grow(unsigned int _part_number) -> void
+	{
+		const auto capacity = std::bit_ceil(static_cast<std::size_t>(_part_number) + 1);
+
+		sizes_.resize(capacity);
+		size_tree_.assign(capacity, 0);
+		count_tree_.assign(capacity, 0);
+
+		// Rebuild the trees in linear time by pushing each node into its parent.
+		for (std::size_t i = 1; i < capacity; ++i) {
+			if (sizes_[i]) {
+				size_tree_[i] += *sizes_[i];
+				count_tree_[i] += 1;
+			}
+
+			if (const auto parent = i + lowest_bit(i); parent < capacity) {
+				size_tree_[parent] += size_tree_[i];
+				count_tree_[parent] += count_tree_[i];
+			}
+		}
+	} // grow
+
+	auto part_size_index::prefix_sum(unsigned int _part_number) const noexcept -> std::uint64_t
+	{
+		std::uint64_t sum = 0;
+
+		for (std::size_t i = _part_number; i > 0; i -= lowest_bit(i)) {
+			sum += size_tree_[i];
+		}
+
+		return sum;
+	} // prefix_sum
+
+	auto part_size_index::prefix_count(unsigned int _part_number) const noexcept -> std::uint64_t
+	{
+		std::uint64_t count = 0;
+
+		for (std::size_t i = _part_number; i > 0; i -= lowest_bit(i)) {
+			count += count_tree_[i];
+		}
+
+		return count;
+	} // prefix_count
+} // namespace irods::s3
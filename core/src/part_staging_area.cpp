@@ -0,0 +1,246 @@
+#include "irods/private/s3_api/part_staging_area.hpp"
+
+#include <sys/mman.h>
+
+#include <iterator>
+#include <utility>
+
+namespace irods::s3
+{
+	staged_part::staged_part(part_staging_area& _area, char* _data, std::size_t _size)
+		: area_{&_area}
+		, data_{_data}
+		, size_{_size}
+	{
+	} // constructor
+
+	staged_part::~staged_part()
+	{
+		area_->deallocate(data_, size_);
+	} // destructor
+
+	part_staging_area::part_staging_area(std::size_t _max_bytes)
+		: max_bytes_{_max_bytes}
+	{
+	} // constructor
+
+	auto part_staging_area::allocate(std::size_t _size) -> std::unique_ptr<staged_part>
+	{
+		if (!enabled()) {
+			return nullptr;
+		}
+
+		// Reserve room for the part before mapping the memory.
+		if (used_bytes_.fetch_add(_size, std::memory_order_relaxed) + _size > max_bytes_) {
+			used_bytes_.fetch_sub(_size, std::memory_order_relaxed);
+			rejected_parts_.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		char* data = nullptr;
+
+		if (_size > 0) {
+			// Pages are only backed by memory once they are written, and are returned to the
+			// system as soon as the part is unmapped.
+			void* p = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+			if (p == MAP_FAILED) {
+				used_bytes_.fetch_sub(_size, std::memory_order_relaxed);
+				rejected_parts_.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			data = static_cast<char*>(p);
+		}
+
+		staged_parts_total_.fetch_add(1, std::memory_order_relaxed);
+
+		return std::unique_ptr<staged_part>{new staged_part{*this, data, _size}};
+	} // allocate
+
+	auto part_staging_area::insert(
+		const std::string& _upload_id,
+		unsigned int _part_number,
+		std::unique_ptr<staged_part> _part) -> void
+	{
+		std::unique_ptr<staged_part> replaced;
+
+		std::scoped_lock lock{mtx_};
+		auto& slot = uploads_[_upload_id].parts[_part_number];
+		replaced = std::exchange(slot, std::move(_part));
+	} // insert
+
+	auto part_staging_area::part_numbers(const std::string& _upload_id) const -> std::vector<unsigned int>
+	{
+		std::vector<unsigned int> part_numbers;
+
+		std::scoped_lock lock{mtx_};
+
+		if (const auto iter = uploads_.find(_upload_id); iter != std::end(uploads_)) {
+			part_numbers.reserve(iter->second.parts.size());
+			for (const auto& [part_number, part] : iter->second.parts) {
+				part_numbers.push_back(part_number);
+			}
+		}
+
+		return part_numbers;
+	} // part_numbers
+
+	auto part_staging_area::take(const std::string& _upload_id, unsigned int _part_number)
+		-> std::unique_ptr<staged_part>
+	{
+		std::scoped_lock lock{mtx_};
+
+		const auto upload_iter = uploads_.find(_upload_id);
+		if (upload_iter == std::end(uploads_)) {
+			return nullptr;
+		}
+
+		auto& upload = upload_iter->second;
+		const auto part_iter = upload.parts.find(_part_number);
+		if (part_iter == std::end(upload.parts)) {
+			return nullptr;
+		}
+
+		auto part = std::move(part_iter->second);
+		upload.parts.erase(part_iter);
+		++upload.in_flight;
+
+		return part;
+	} // take
+
+	auto part_staging_area::release(const std::string& _upload_id) -> void
+	{
+		std::vector<std::function<void()>> idle_waiters;
+
+		{
+			std::scoped_lock lock{mtx_};
+
+			if (const auto iter = uploads_.find(_upload_id); iter != std::end(uploads_)) {
+				idle_waiters = end_flight(iter->second);
+				erase_if_idle(iter);
+			}
+		}
+
+		for (auto& on_idle : idle_waiters) {
+			on_idle();
+		}
+	} // release
+
+	auto part_staging_area::restore(
+		const std::string& _upload_id,
+		unsigned int _part_number,
+		std::unique_ptr<staged_part> _part) -> void
+	{
+		std::vector<std::function<void()>> idle_waiters;
+
+		// If a newer copy of the part has been staged, _part is released after the lock.
+		{
+			std::scoped_lock lock{mtx_};
+
+			// The upload has been discarded while the part was in flight.
+			const auto iter = uploads_.find(_upload_id);
+			if (iter == std::end(uploads_)) {
+				return;
+			}
+
+			idle_waiters = end_flight(iter->second);
+			iter->second.parts.try_emplace(_part_number, std::move(_part));
+		}
+
+		for (auto& on_idle : idle_waiters) {
+			on_idle();
+		}
+	} // restore
+
+	auto part_staging_area::try_take_all(const std::string& _upload_id, std::function<void()> _on_idle)
+		-> std::optional<std::map<unsigned int, std::unique_ptr<staged_part>>>
+	{
+		std::scoped_lock lock{mtx_};
+
+		const auto iter = uploads_.find(_upload_id);
+		if (iter == std::end(uploads_)) {
+			return std::map<unsigned int, std::unique_ptr<staged_part>>{};
+		}
+
+		if (iter->second.in_flight > 0) {
+			if (_on_idle) {
+				iter->second.idle_waiters.push_back(std::move(_on_idle));
+			}
+			return std::nullopt;
+		}
+
+		auto parts = std::move(iter->second.parts);
+		uploads_.erase(iter);
+
+		return parts;
+	} // try_take_all
+
+	auto part_staging_area::erase(const std::string& _upload_id) -> void
+	{
+		upload_type upload;
+
+		{
+			std::scoped_lock lock{mtx_};
+
+			const auto iter = uploads_.find(_upload_id);
+			if (iter == std::end(uploads_)) {
+				return;
+			}
+
+			upload = std::move(iter->second);
+			uploads_.erase(iter);
+		}
+
+		// The parts are released once the lock is no longer held. Nothing is left to wait for.
+		for (auto& on_idle : upload.idle_waiters) {
+			on_idle();
+		}
+	} // erase
+
+	auto part_staging_area::to_json() const -> nlohmann::json
+	{
+		std::size_t uploads = 0;
+
+		{
+			std::scoped_lock lock{mtx_};
+			uploads = uploads_.size();
+		}
+
+		return {
+			{"uploads", uploads},
+			{"staged_parts_total", staged_parts_total_.load(std::memory_order_relaxed)},
+			{"rejected_parts", rejected_parts_.load(std::memory_order_relaxed)},
+			{"used_bytes", used_bytes_.load(std::memory_order_relaxed)},
+			{"max_bytes", max_bytes_}};
+	} // to_json
+
+	auto part_staging_area::end_flight(upload_type& _upload) -> std::vector<std::function<void()>>
+	{
+		if (_upload.in_flight > 0) {
+			--_upload.in_flight;
+		}
+
+		if (_upload.in_flight > 0) {
+			return {};
+		}
+
+		return std::exchange(_upload.idle_waiters, {});
+	} // end_flight
+
+	auto part_staging_area::erase_if_idle(std::unordered_map<std::string, upload_type>::iterator _iter) -> void
+	{
+		if (_iter->second.parts.empty() && _iter->second.in_flight == 0) {
+			uploads_.erase(_iter);
+		}
+	} // erase_if_idle
+
+	auto part_staging_area::deallocate(char* _data, std::size_t _size) noexcept -> void
+	{
+		if (_data) {
+			munmap(_data, _size);
+		}
+
+		used_bytes_.fetch_sub(_size, std::memory_order_relaxed);
+	} // deallocate
+} // namespace irods::s3
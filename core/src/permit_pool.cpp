@@ -0,0 +1,164 @@
+#include "irods/private/s3_api/permit_pool.hpp"
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace irods::http
+{
+	permit_pool::permit::permit(permit_pool& _pool)
+		: pool_{&_pool}
+	{
+	} // constructor
+
+	permit_pool::permit::permit(permit&& _other) noexcept
+		: pool_{std::exchange(_other.pool_, nullptr)}
+	{
+	} // move constructor
+
+	auto permit_pool::permit::operator=(permit&& _other) noexcept -> permit&
+	{
+		if (this != &_other) {
+			release();
+			pool_ = std::exchange(_other.pool_, nullptr);
+		}
+
+		return *this;
+	} // move assignment operator
+
+	permit_pool::permit::~permit()
+	{
+		release();
+	} // destructor
+
+	auto permit_pool::permit::release() noexcept -> void
+	{
+		if (auto* pool = std::exchange(pool_, nullptr); pool) {
+			pool->release();
+		}
+	} // release
+
+	permit_pool::waiter::waiter(const boost::asio::any_io_executor& _executor)
+		: timer{_executor, boost::asio::steady_timer::time_point::max()}
+	{
+	} // constructor
+
+	permit_pool::permit_pool(std::size_t _size)
+		: size_{std::max<std::size_t>(1, _size)}
+		, available_{size_}
+	{
+	} // constructor
+
+	auto permit_pool::async_acquire() -> boost::asio::awaitable<permit>
+	{
+		auto w = std::make_shared<waiter>(co_await boost::asio::this_coro::executor);
+
+		{
+			std::scoped_lock lock{mtx_};
+
+			if (available_ > 0) {
+				--available_;
+				acquired_total_.fetch_add(1, std::memory_order_relaxed);
+				co_return permit{*this};
+			}
+
+			waiters_.push_back(w);
+		}
+
+		waits_total_.fetch_add(1, std::memory_order_relaxed);
+
+		// If the coroutine is destroyed while it waits (e.g. on shutdown), the permit it may have
+		// been granted is passed on.
+		struct abandon_guard
+		{
+			permit_pool& pool;
+			const std::shared_ptr<waiter>& w;
+			bool dismissed = false;
+
+			~abandon_guard()
+			{
+				if (!dismissed) {
+					pool.abandon(w);
+				}
+			}
+		} guard{*this, w};
+
+		// release() expires the timer once the permit is granted. Until then, the timer only
+		// completes when it is cancelled.
+		while (true) {
+			boost::system::error_code ec;
+			co_await w->timer.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+			std::scoped_lock lock{mtx_};
+			if (w->granted) {
+				break;
+			}
+		}
+
+		guard.dismissed = true;
+		acquired_total_.fetch_add(1, std::memory_order_relaxed);
+
+		co_return permit{*this};
+	} // async_acquire
+
+	auto permit_pool::to_json() const -> nlohmann::json
+	{
+		std::size_t available = 0;
+		std::size_t waiting = 0;
+
+		{
+			std::scoped_lock lock{mtx_};
+			available = available_;
+			waiting = waiters_.size();
+		}
+
+		return {
+			{"size", size_},
+			{"available", available},
+			{"waiting", waiting},
+			{"acquired_total", acquired_total_.load(std::memory_order_relaxed)},
+			{"waits_total", waits_total_.load(std::memory_order_relaxed)}};
+	} // to_json
+
+	auto permit_pool::release() noexcept -> void
+	{
+		std::shared_ptr<waiter> w;
+
+		{
+			std::scoped_lock lock{mtx_};
+
+			if (waiters_.empty()) {
+				++available_;
+				return;
+			}
+
+			w = std::move(waiters_.front());
+			waiters_.pop_front();
+			w->granted = true;
+		}
+
+		// The timer is only touched from the executor of the waiting coroutine. Moving its expiry
+		// into the past also completes a wait which has not started yet.
+		boost::asio::post(w->timer.get_executor(), [w] {
+			w->timer.expires_at(boost::asio::steady_timer::time_point::min());
+		});
+	} // release
+
+	auto permit_pool::abandon(const std::shared_ptr<waiter>& _waiter) noexcept -> void
+	{
+		{
+			std::scoped_lock lock{mtx_};
+
+			if (!_waiter->granted) {
+				waiters_.erase(std::remove(std::begin(waiters_), std::end(waiters_), _waiter), std::end(waiters_));
+				return;
+			}
+		}
+
+		release();
+	} // abandon
+} // namespace irods::http
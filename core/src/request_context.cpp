@@ -0,0 +1,29 @@
+#include "irods/private/s3_api/request_context.hpp"
+
+#include "irods/private/s3_api/bucket.hpp"
+
+#include <utility>
+
+namespace irods::http
+{
+	request_context::request_context(parser_type&& _parser, route&& _route)
+		: parser_{std::move(_parser)}
+		, op_{_route.op}
+		, url_{std::move(_route.url)}
+		, path_{url_.path()}
+		, bucket_resolved_{false}
+	{
+	} // request_context (constructor)
+
+	auto request_context::bucket() -> const std::optional<irods::experimental::filesystem::path>&
+	{
+		if (!bucket_resolved_) {
+			if (!url_.segments().empty()) {
+				bucket_ = irods::s3::resolve_bucket(url_.segments());
+			}
+			bucket_resolved_ = true;
+		}
+
+		return bucket_;
+	} // bucket
+} // namespace irods::http
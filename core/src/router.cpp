@@ -0,0 +1,281 @@
+#include "irods/private/s3_api/router.hpp"
+
+#include "irods/private/s3_api/log.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+
+namespace
+{
+	namespace http = boost::beast::http;
+
+	using irods::http::operation;
+
+	// Each bit represents a property of the request which influences routing. Most of them
+	// are query parameter keys. The rest describe the target and headers.
+	using feature_set = std::uint32_t;
+
+	// clang-format off
+	constexpr feature_set f_uploads        = 1u << 0;
+	constexpr feature_set f_max_parts      = 1u << 1;
+	constexpr feature_set f_encoding_type  = 1u << 2;
+	constexpr feature_set f_list_type      = 1u << 3;
+	constexpr feature_set f_prefix         = 1u << 4;
+	constexpr feature_set f_location       = 1u << 5;
+	constexpr feature_set f_object_lock    = 1u << 6;
+	constexpr feature_set f_tagging        = 1u << 7;
+	constexpr feature_set f_versioning     = 1u << 8;
+	constexpr feature_set f_delete         = 1u << 9;
+	constexpr feature_set f_upload_id      = 1u << 10;
+	constexpr feature_set f_root_target    = 1u << 11;
+	constexpr feature_set f_distribution   = 1u << 12;
+	constexpr feature_set f_copy_source    = 1u << 13;
+
+	constexpr auto significant_query_keys = std::to_array<std::pair<std::string_view, feature_set>>({
+		{"uploads",       f_uploads},
+		{"max-parts",     f_max_parts},
+		{"encoding-type", f_encoding_type},
+		{"list-type",     f_list_type},
+		{"prefix",        f_prefix},
+		{"location",      f_location},
+		{"object-lock",   f_object_lock},
+		{"tagging",       f_tagging},
+		{"versioning",    f_versioning},
+		{"delete",        f_delete},
+		{"uploadId",      f_upload_id}
+	});
+	// clang-format on
+
+	enum class segment_constraint : std::uint8_t
+	{
+		any,
+		none,
+		one
+	};
+
+	struct rule
+	{
+		segment_constraint segments;
+		feature_set required; // All of these features must be present.
+		feature_set any_of;   // At least one of these features must be present (ignored if zero).
+		operation op;
+	};
+
+	// The rules for each HTTP method are evaluated in order. The first matching rule wins,
+	// so more specific rules must appear before less specific ones.
+
+	// clang-format off
+	constexpr auto get_rules = std::to_array<rule>({
+		{segment_constraint::any,  f_uploads,       0, operation::list_multipart_uploads},
+		{segment_constraint::any,  0,               f_max_parts | f_upload_id, operation::list_parts},
+		{segment_constraint::none, 0,               0, operation::list_objects_v2},
+		{segment_constraint::any,  0,               f_encoding_type | f_list_type | f_prefix, operation::list_objects_v2},
+		{segment_constraint::any,  f_root_target,   0, operation::list_buckets},
+		// This is a special string which invokes the ListDistributions API from AWS CloudFront. This
+		// could cause problems if your bucket is named "2020-05-31" and there is an object inside
+		// called "distribution".
+		{segment_constraint::any,  f_distribution,  0, operation::list_distributions},
+		{segment_constraint::any,  f_location,      0, operation::get_bucket_location},
+		{segment_constraint::any,  f_object_lock,   0, operation::get_object_lock_configuration},
+		{segment_constraint::any,  f_tagging,       0, operation::get_object_tagging},
+		{segment_constraint::any,  f_versioning,    0, operation::get_bucket_versioning},
+		{segment_constraint::any,  0,               0, operation::get_object}
+	});
+
+	constexpr auto put_rules = std::to_array<rule>({
+		{segment_constraint::any,  f_copy_source,   0, operation::copy_object},
+		{segment_constraint::any,  0,               0, operation::put_object}
+	});
+
+	constexpr auto delete_rules = std::to_array<rule>({
+		{segment_constraint::none, 0,               0, operation::delete_bucket},
+		{segment_constraint::any,  f_upload_id,     0, operation::abort_multipart_upload},
+		{segment_constraint::any,  f_tagging,       0, operation::delete_object_tagging},
+		{segment_constraint::any,  0,               0, operation::delete_object}
+	});
+
+	constexpr auto head_rules = std::to_array<rule>({
+		{segment_constraint::one,  0,               0, operation::head_bucket},
+		{segment_constraint::any,  0,               0, operation::head_object}
+	});
+
+	constexpr auto post_rules = std::to_array<rule>({
+		{segment_constraint::any,  f_delete,        0, operation::delete_objects},
+		{segment_constraint::any,  f_upload_id,     0, operation::complete_multipart_upload},
+		{segment_constraint::any,  0,               0, operation::create_multipart_upload}
+	});
+	// clang-format on
+
+	auto rules_for(http::verb _method) noexcept -> std::span<const rule>
+	{
+		switch (_method) {
+			case http::verb::get:
+				return get_rules;
+			case http::verb::put:
+				return put_rules;
+			case http::verb::delete_:
+				return delete_rules;
+			case http::verb::head:
+				return head_rules;
+			case http::verb::post:
+				return post_rules;
+			default:
+				return {};
+		}
+	} // rules_for
+
+	auto collect_features(const boost::urls::url_view& _url, std::string_view _target, bool _has_copy_source) noexcept
+		-> feature_set
+	{
+		feature_set features = 0;
+
+		// Visit each query parameter exactly once. Dereferencing an encoded key yields a view
+		// which decodes as it is compared, so "upload%49d" matches "uploadId" without
+		// materializing a decoded copy of the key.
+		for (const auto& param : _url.encoded_params()) {
+			const boost::urls::decode_view key = *param.key;
+
+			for (const auto& [name, feature] : significant_query_keys) {
+				if (key == name) {
+					features |= feature;
+					break;
+				}
+			}
+		}
+
+		if (_target == "/") {
+			features |= f_root_target;
+		}
+		else if (_target == "/2020-05-31/distribution") {
+			features |= f_distribution;
+		}
+
+		if (_has_copy_source) {
+			features |= f_copy_source;
+		}
+
+		return features;
+	} // collect_features
+
+	auto satisfies(segment_constraint _constraint, std::size_t _segment_count) noexcept -> bool
+	{
+		switch (_constraint) {
+			case segment_constraint::none:
+				return 0 == _segment_count;
+			case segment_constraint::one:
+				return 1 == _segment_count;
+			default:
+				return true;
+		}
+	} // satisfies
+} // anonymous namespace
+
+namespace irods::http
+{
+	auto to_string(operation _op) noexcept -> std::string_view
+	{
+		// clang-format off
+		switch (_op) {
+			case operation::list_buckets:                  return "ListBuckets";
+			case operation::list_objects_v2:               return "ListObjects";
+			case operation::list_multipart_uploads:        return "ListMultipartUploads";
+			case operation::list_parts:                    return "ListParts";
+			case operation::list_distributions:            return "ListDistributions";
+			case operation::get_bucket_location:           return "GetBucketLocation";
+			case operation::get_object_lock_configuration: return "GetObjectLockConfiguration";
+			case operation::get_object_tagging:            return "GetObjectTagging";
+			case operation::get_bucket_versioning:         return "GetBucketVersioning";
+			case operation::get_object:                    return "GetObject";
+			case operation::copy_object:                   return "CopyObject";
+			case operation::put_object:                    return "PutObject";
+			case operation::delete_bucket:                 return "DeleteBucket";
+			case operation::abort_multipart_upload:        return "AbortMultipartUpload";
+			case operation::delete_object_tagging:         return "DeleteObjectTagging";
+			case operation::delete_object:                 return "DeleteObject";
+			case operation::head_bucket:                   return "HeadBucket";
+			case operation::head_object:                   return "HeadObject";
+			case operation::delete_objects:                return "DeleteObjects";
+			case operation::complete_multipart_upload:     return "CompleteMultipartUpload";
+			case operation::create_multipart_upload:       return "CreateMultipartUpload";
+			default:                                       return "Unsupported";
+		}
+		// clang-format on
+	} // to_string
+
+	auto parse_url(const request_type& _request, boost::urls::url& _url) -> void
+	{
+		if (const auto host_iter = _request.find(boost::beast::http::field::host); host_iter != _request.end()) {
+			const auto host = host_iter->value();
+			_url.set_encoded_host(host.find(':') != std::string::npos ? host.substr(0, host.find(':')) : host);
+		}
+		_url.set_scheme("http");
+
+		const auto& target = _request.target();
+		const auto params_pos = target.find('?');
+
+		// If a query parameters delimiter was in the original target, make sure to set the query in the parsed URL.
+		if (params_pos != std::string::npos) {
+			_url.set_encoded_query(target.substr(params_pos + 1));
+		}
+
+		// If no query parameters delimiter is in the target, then the target and the path are one and the same.
+		const auto encoded_path = (params_pos != std::string::npos) ? target.substr(0, params_pos) : target;
+
+		// Decode the "path" part of the request. An encoded path string can and often does differ from the path sent
+		// from the client. For instance, spaces, percent signs, and plus signs can be encoded even though the path is
+		// supposed to have these literal characters in them.
+		const auto psv_path = boost::urls::pct_string_view{encoded_path};
+		std::string decoded_path;
+		decoded_path.resize(psv_path.decoded_size());
+		psv_path.decode({}, boost::urls::string_token::assign_to(decoded_path));
+		logging::debug("{}: encoded_path [{}], decoded_path [{}]", __func__, encoded_path, decoded_path);
+		_url.set_path(decoded_path);
+	} // parse_url
+
+	auto resolve_operation(
+		boost::beast::http::verb _method,
+		const boost::urls::url_view& _url,
+		std::string_view _target,
+		bool _has_copy_source) noexcept -> operation
+	{
+		const auto rules = rules_for(_method);
+		if (rules.empty()) {
+			return operation::unsupported;
+		}
+
+		const auto features = collect_features(_url, _target, _has_copy_source);
+		const auto segment_count = _url.segments().size();
+
+		for (const auto& r : rules) {
+			if ((features & r.required) != r.required) {
+				continue;
+			}
+
+			if (r.any_of != 0 && (features & r.any_of) == 0) {
+				continue;
+			}
+
+			if (satisfies(r.segments, segment_count)) {
+				return r.op;
+			}
+		}
+
+		return operation::unsupported;
+	} // resolve_operation
+
+	auto resolve_route(const request_type& _request) -> route
+	{
+		route r{operation::unsupported, {}};
+		parse_url(_request, r.url);
+
+		const auto target = _request.target();
+		const bool has_copy_source = _request.find("x-amz-copy-source") != _request.end();
+		r.op = resolve_operation(
+			_request.method(), r.url, std::string_view{target.data(), target.size()}, has_copy_source);
+
+		return r;
+	} // resolve_route
+} // namespace irods::http
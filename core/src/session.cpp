@@ -6,7 +6,10 @@
 #include "irods/private/s3_api/configuration.hpp"
 
 #include <boost/beast/version.hpp>
+#include <boost/asio/co_spawn.hpp>
 #include <boost/asio/dispatch.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/asio/signal_set.hpp>
 #include <boost/asio/thread_pool.hpp>
@@ -17,10 +20,9 @@
 
 #include <nlohmann/json.hpp>
 
-#include <algorithm>
-#include <array>
 #include <chrono>
-#include <iterator>
+#include <exception>
+#include <sstream>
 #include <utility>
 
 #ifdef IRODS_WRITE_REQUEST_TO_TEMP_FILE
@@ -29,38 +31,6 @@
 
 namespace irods::http
 {
-	void get_url_from_parser(
-		boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		boost::urls::url& url)
-	{
-		auto& message = parser.get();
-
-		auto host = message.find("Host")->value();
-		url.set_encoded_host(host.find(':') != std::string::npos ? host.substr(0, host.find(':')) : host);
-		url.set_scheme("http");
-
-		const auto& target = message.target();
-		const auto params_pos = target.find('?');
-
-		// If a query parameters delimiter was in the original target, make sure to set the query in the parsed URL.
-		if (params_pos != std::string::npos) {
-			url.set_encoded_query(target.substr(params_pos + 1));
-		}
-
-		// If no query parameters delimiter is in the target, then the target and the path are one and the same.
-		const auto encoded_path = (params_pos != std::string::npos) ? target.substr(0, params_pos) : target;
-
-		// Decode the "path" part of the request. An encoded path string can and often does differ from the path sent
-		// from the client. For instance, spaces, percent signs, and plus signs can be encoded even though the path is
-		// supposed to have these literal characters in them.
-		const auto psv_path = boost::urls::pct_string_view{encoded_path};
-		std::string decoded_path;
-		decoded_path.resize(psv_path.decoded_size());
-		psv_path.decode({}, boost::urls::string_token::assign_to(decoded_path));
-		logging::debug("{}: encoded_path [{}], decoded_path [{}]", __func__, encoded_path, decoded_path);
-		url.set_path(decoded_path);
-	}
-
 	session::session(boost::asio::ip::tcp::socket&& socket, int _max_body_size, int _timeout_in_seconds)
 		: stream_(std::move(socket))
 		, max_body_size_{_max_body_size}
@@ -88,6 +58,7 @@ namespace irods::http
 	{
 		// Construct a new parser for each message.
 		parser_.emplace();
+		continue_pending_ = false;
 
 		// Apply the limit defined in the configuration file.
 		parser_->body_limit(max_body_size_);
@@ -124,6 +95,8 @@ namespace irods::http
 		// Process client request and send a response.
 		//
 
+		++requests_received_;
+
 		auto& req_ = parser_->get();
 
 		// Print the headers.
@@ -140,247 +113,155 @@ namespace irods::http
 		logging::debug("{}: Chunked: {}", __func__, req_.chunked());
 		logging::debug("{}: Needs EOF: {}", __func__, req_.need_eof());
 
-		std::string url_string = static_cast<std::string>(req_.find("Host")->value()).append(req_.target());
-		logging::debug("{}: Candidate url string: {}", __func__, url_string);
-
 		namespace http = boost::beast::http;
 
-		// build the url_view - must be done within background task as url_view is not copyable
-		boost::urls::url url2;
-		get_url_from_parser(*parser_, url2);
-		boost::urls::url_view url = url2;
+		auto route = resolve_route(req_);
+		logging::debug("{}: {} detected", __func__, to_string(route.op));
+
+		switch (route.op) {
+			case operation::list_objects_v2:
+				return dispatch(std::move(route), &irods::s3::actions::handle_listobjects_v2);
+			case operation::list_buckets:
+				return dispatch(std::move(route), &irods::s3::actions::handle_listbuckets);
+			case operation::get_object:
+				return dispatch(std::move(route), &irods::s3::actions::handle_getobject);
+			case operation::copy_object:
+				return dispatch(std::move(route), &irods::s3::actions::handle_copyobject);
+			case operation::put_object:
+				return dispatch(std::move(route), &irods::s3::actions::handle_putobject);
+			case operation::abort_multipart_upload:
+				return dispatch(std::move(route), &irods::s3::actions::handle_abortmultipartupload);
+			case operation::delete_object:
+				return dispatch(std::move(route), &irods::s3::actions::handle_deleteobject);
+			case operation::head_bucket:
+				return dispatch(std::move(route), &irods::s3::actions::handle_headbucket);
+			case operation::head_object:
+				return dispatch(std::move(route), &irods::s3::actions::handle_headobject);
+			case operation::delete_objects:
+				return dispatch(std::move(route), &irods::s3::actions::handle_deleteobjects);
+			case operation::complete_multipart_upload:
+				return dispatch(std::move(route), &irods::s3::actions::handle_completemultipartupload);
+			case operation::create_multipart_upload:
+				return dispatch(std::move(route), &irods::s3::actions::handle_createmultipartupload);
+			case operation::list_multipart_uploads:
+				return dispatch(std::move(route), &irods::s3::actions::handle_listmultipartuploads);
+			case operation::list_parts:
+				return dispatch(std::move(route), &irods::s3::actions::handle_listparts);
+
+			case operation::get_bucket_location: {
+				boost::beast::http::response<boost::beast::http::string_body> response;
+				std::string s3_region = irods::s3::get_s3_region();
+				boost::property_tree::ptree document;
+				document.add("LocationConstraint", s3_region);
+				std::stringstream s;
+				boost::property_tree::xml_parser::xml_writer_settings<std::string> settings;
+				settings.indent_char = ' ';
+				settings.indent_count = 4;
+				boost::property_tree::write_xml(s, document, settings);
+				response.body() = s.str();
+				response.result(boost::beast::http::status::ok);
+				return send(std::move(response));
+			}
+
+			case operation::get_object_lock_configuration: {
+				boost::beast::http::response<boost::beast::http::string_body> response;
+				response.body() = "<?xml version='1.0' encoding='utf-8'?>"
+				                  "<ObjectLockConfiguration/>";
+				response.result(boost::beast::http::status::ok);
+				return send(std::move(response));
+			}
+
+			case operation::get_object_tagging: {
+				boost::beast::http::response<boost::beast::http::string_body> response;
+				response.body() = "<?xml version='1.0' encoding='utf-8'?>"
+				                  "<Tagging><TagSet/></Tagging>";
+				response.result(boost::beast::http::status::ok);
+				return send(std::move(response));
+			}
+
+			case operation::get_bucket_versioning: {
+				boost::beast::http::response<boost::beast::http::string_body> response;
+				response.body() = "<?xml version='1.0' encoding='utf-8'?>"
+				                  "<VersioningConfiguration xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\"/>";
+				response.result(boost::beast::http::status::ok);
+				return send(std::move(response));
+			}
+
+			case operation::list_distributions:
+			case operation::delete_bucket:
+			case operation::delete_object_tagging:
+				return send(irods::http::fail(http::status::not_implemented));
 
-		const auto& segments = url.segments();
-		const auto& params = url.params();
+			default:
+				logging::error(
+					"{}: Someone tried to make an HTTP request with a method that is not yet supported", __func__);
+				return send(irods::http::fail(http::status::not_implemented));
+		}
+	} // on_read
 
-		static constexpr auto listobjects_params = std::array{"encoding-type", "list-type", "prefix"};
-		const auto listobjects_detected =
-			std::any_of(listobjects_params.cbegin(), listobjects_params.cend(), [&params](const auto& _p) {
-				return params.contains(_p);
-			});
+	auto session::dispatch(route&& _route, handler_type _handler) -> void
+	{
+		continue_pending_ =
+			boost::beast::iequals(parser_->get()[boost::beast::http::field::expect], "100-continue");
 
-		switch (req_.method()) {
-			case boost::beast::http::verb::get:
-				if (params.contains("uploads")) {
-					// TODO(#108): Implement ListMultipartUploads
-					logging::debug("{}: ListMultipartUploads detected", __func__);
-					send(irods::http::fail(http::status::not_implemented));
-				}
-				else if (params.contains("max-parts")) {
-					// TODO(#107): Implement ListParts
-					logging::debug("{}: ListParts detected", __func__);
-					send(irods::http::fail(http::status::not_implemented));
-				}
-				else if (segments.empty() || listobjects_detected) {
-					logging::debug("{}: ListObjects detected", __func__);
-					auto shared_this = shared_from_this();
-					irods::http::globals::background_task([shared_this, &parser = this->parser_]() mutable {
-						// build the url_view - must be done within background task as url_view is not copyable
-						boost::urls::url url;
-						get_url_from_parser(*parser, url);
-						boost::urls::url_view url_view = url;
-						irods::s3::actions::handle_listobjects_v2(shared_this, *parser, url_view);
-					});
-				}
-				else {
-					if (req_.target() == "/") {
-						logging::debug("{}: ListBuckets detected", __func__);
-						auto shared_this = shared_from_this();
-						irods::http::globals::background_task([shared_this, &parser = this->parser_]() mutable {
-							// build the url_view - must be done within background task as url_view is not copyable
-							boost::urls::url url;
-							get_url_from_parser(*parser, url);
-							boost::urls::url_view url_view = url;
-							irods::s3::actions::handle_listbuckets(shared_this, *parser, url_view);
-						});
-					}
-					else if (req_.target() == "/2020-05-31/distribution") {
-						// This is a special string which invokes the ListDistributions API from AWS CloudFront. This
-						// could cause problems if your bucket is named "2020-05-31" and there is an object inside
-						// called "distribution".
-						logging::debug("{}: ListDistributions (AWS CloudFront) detected?", __func__);
-						send(irods::http::fail(http::status::not_implemented));
-					}
-					else if (params.find("location") != params.end()) {
-						// This is GetBucketLocation
-						logging::debug("{}: GetBucketLocation detected", __func__);
-						boost::beast::http::response<boost::beast::http::string_body> response;
-						std::string s3_region = irods::s3::get_s3_region();
-						boost::property_tree::ptree document;
-						document.add("LocationConstraint", s3_region);
-						std::stringstream s;
-						boost::property_tree::xml_parser::xml_writer_settings<std::string> settings;
-						settings.indent_char = ' ';
-						settings.indent_count = 4;
-						boost::property_tree::write_xml(s, document, settings);
-						response.body() = s.str();
-						response.result(boost::beast::http::status::ok);
-						send(std::move(response));
-					}
-					else if (params.find("object-lock") != params.end()) {
-						logging::debug("{}: GetObjectLockConfiguration detected", __func__);
-						boost::beast::http::response<boost::beast::http::string_body> response;
-						response.body() = "<?xml version='1.0' encoding='utf-8'?>"
-										  "<ObjectLockConfiguration/>";
-						response.result(boost::beast::http::status::ok);
-						send(std::move(response));
-					}
-					else if (params.find("tagging") != params.end()) {
-						logging::debug("{}: GetObjectTagging detected", __func__);
-						boost::beast::http::response<boost::beast::http::string_body> response;
-						response.body() = "<?xml version='1.0' encoding='utf-8'?>"
-										  "<Tagging><TagSet/></Tagging>";
-						response.result(boost::beast::http::status::ok);
-						send(std::move(response));
-					}
-					else if (params.find("versioning") != params.end()) {
-						logging::debug("{}: GetBucketVersioning detected", __func__);
-						boost::beast::http::response<boost::beast::http::string_body> response;
-						response.body() =
-							"<?xml version='1.0' encoding='utf-8'?>"
-							"<VersioningConfiguration xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\"/>";
-						response.result(boost::beast::http::status::ok);
-						send(std::move(response));
-					}
-					else {
-						logging::debug("{}: GetObject detected", __func__);
-						auto shared_this = shared_from_this();
-						irods::http::globals::background_task([shared_this, &parser = this->parser_]() mutable {
-							// build the url_view - must be done within background task as url_view is not copyable
-							boost::urls::url url;
-							get_url_from_parser(*parser, url);
-							boost::urls::url_view url_view = url;
-							irods::s3::actions::handle_getobject(shared_this, *parser, url_view);
-						});
-					}
-				}
-				break;
-			case boost::beast::http::verb::put:
-				if (req_.find("x-amz-copy-source") != req_.end()) {
-					logging::debug("{}: CopyObject detected", __func__);
-					auto shared_this = shared_from_this();
-					irods::http::globals::background_task([shared_this, &parser = this->parser_]() mutable {
-						// build the url_view - must be done within background task as url_view is not copyable
-						boost::urls::url url;
-						get_url_from_parser(*parser, url);
-						boost::urls::url_view url_view = url;
-						irods::s3::actions::handle_copyobject(shared_this, *parser, url_view);
-					});
-				}
-				else {
-					// putobject
-					logging::debug("{}: PutObject detected", __func__);
-					auto shared_this = shared_from_this();
-					irods::http::globals::background_task([shared_this, &parser = this->parser_]() mutable {
-						// build the url_view - must be done within background task as url_view is not copyable
-						boost::urls::url url;
-						get_url_from_parser(*parser, url);
-						boost::urls::url_view url_view = url;
-						irods::s3::actions::handle_putobject(shared_this, *parser, url_view);
-					});
-				}
-				break;
-			case boost::beast::http::verb::delete_:
-				if (segments.empty()) {
-					logging::debug("{}: DeleteBucket detected?", __func__);
-					send(irods::http::fail(http::status::not_implemented));
-				}
-				else if (params.find("uploadId") != params.end()) {
-					logging::debug("{}: AbortMultipartUpload detected", __func__);
-					auto shared_this = shared_from_this();
-					irods::http::globals::background_task([shared_this, &parser = this->parser_]() mutable {
-						// build the url_view - must be done within background task as url_view is not copyable
-						boost::urls::url url;
-						get_url_from_parser(*parser, url);
-						boost::urls::url_view url_view = url;
-						irods::s3::actions::handle_abortmultipartupload(shared_this, *parser, url_view);
-					});
-				}
-				else if (params.find("tagging") != params.end()) {
-					logging::debug("{}: DeleteObjectTagging detected", __func__);
-					send(irods::http::fail(http::status::not_implemented));
-				}
-				else {
-					logging::debug("{}: DeleteObject detected", __func__);
-					auto shared_this = shared_from_this();
-					irods::http::globals::background_task([shared_this, &parser = this->parser_]() mutable {
-						// build the url_view - must be done within background task as url_view is not copyable
-						boost::urls::url url;
-						get_url_from_parser(*parser, url);
-						boost::urls::url_view url_view = url;
-						irods::s3::actions::handle_deleteobject(shared_this, *parser, url_view);
-					});
-				}
-				break;
-			case boost::beast::http::verb::head:
-				// Determine if it is HeadBucket or HeadObject
-				if (1 == segments.size()) {
-					logging::debug("{}: HeadBucket detected", __func__);
-					auto shared_this = shared_from_this();
-					irods::http::globals::background_task([shared_this, &parser = this->parser_]() mutable {
-						// build the url_view - must be done within background task as url_view is not copyable
-						boost::urls::url url;
-						get_url_from_parser(*parser, url);
-						boost::urls::url_view url_view = url;
-						irods::s3::actions::handle_headbucket(shared_this, *parser, url_view);
-					});
+		auto ctx = std::make_shared<request_context>(std::move(*parser_), std::move(_route));
+		parser_.reset();
+
+		const auto request_number = requests_received_;
+
+		boost::asio::co_spawn(
+			stream_.get_executor(),
+			_handler(shared_from_this(), std::move(ctx)),
+			[self = shared_from_this(), request_number](std::exception_ptr _eptr) {
+				if (!_eptr) {
+					return;
 				}
-				else {
-					logging::debug("{}: HeadObject detected", __func__);
-					auto shared_this = shared_from_this();
-					irods::http::globals::background_task([shared_this, &parser = this->parser_]() mutable {
-						// build the url_view - must be done within background task as url_view is not copyable
-						boost::urls::url url;
-						get_url_from_parser(*parser, url);
-						boost::urls::url_view url_view = url;
-						irods::s3::actions::handle_headobject(shared_this, *parser, url_view);
-					});
+
+				try {
+					std::rethrow_exception(_eptr);
 				}
-				break;
-			case boost::beast::http::verb::post:
-				// check for DeleteObjects
-				if (params.contains("delete")) {
-					logging::debug("{}: DeleteObjects detected", __func__);
-					auto shared_this = shared_from_this();
-					irods::http::globals::background_task([shared_this, &parser = this->parser_]() mutable {
-						// build the url_view - must be done within background task as url_view is not copyable
-						boost::urls::url url;
-						get_url_from_parser(*parser, url);
-						boost::urls::url_view url_view = url;
-						irods::s3::actions::handle_deleteobjects(shared_this, *parser, url_view);
-					});
+				catch (const std::exception& e) {
+					logging::error("dispatch: Unhandled exception in request handler: {}", e.what());
 				}
-				else if (const auto upload_id_param = url.params().find("uploadId");
-				         upload_id_param != url.params().end()) {
-					logging::debug("{}: CompleteMultipartUpload detected", __func__);
-					auto shared_this = shared_from_this();
-					irods::http::globals::background_task([shared_this, &parser = this->parser_]() mutable {
-						// build the url_view - must be done within background task as url_view is not copyable
-						boost::urls::url url;
-						get_url_from_parser(*parser, url);
-						boost::urls::url_view url_view = url;
-						irods::s3::actions::handle_completemultipartupload(shared_this, *parser, url_view);
-					});
+				catch (...) {
+					logging::error("dispatch: Unhandled unknown exception in request handler");
 				}
-				else {
-					logging::debug("{}: CreateMultipartUpload detected", __func__);
-					auto shared_this = shared_from_this();
-					irods::http::globals::background_task([shared_this, &parser = this->parser_]() mutable {
-						// build the url_view - must be done within background task as url_view is not copyable
-						boost::urls::url url;
-						get_url_from_parser(*parser, url);
-						boost::urls::url_view url_view = url;
-						irods::s3::actions::handle_createmultipartupload(shared_this, *parser, url_view);
-					});
+
+				// Without a response, the client would only see the connection drop. The state
+				// of the connection is unknown (e.g. part of the body may be unread), so it is
+				// closed once the response has been written.
+				if (self->responses_started_.load(std::memory_order_relaxed) < request_number) {
+					auto response = irods::http::fail(boost::beast::http::status::internal_server_error);
+					response.keep_alive(false);
+					self->send(std::move(response));
 				}
-				break;
-			default:
-				logging::error(
-					"{}: Someone tried to make an HTTP request with a method that is not yet supported", __func__);
-				send(irods::http::fail(http::status::not_implemented));
+			});
+	} // dispatch
+
+	auto session::async_send_continue() -> boost::asio::awaitable<boost::beast::error_code>
+	{
+		namespace http = boost::beast::http;
+
+		boost::beast::error_code ec;
+
+		if (!std::exchange(continue_pending_, false)) {
+			co_return ec;
 		}
 
-	} // on_read
+		http::response<http::empty_body> response{http::status::continue_, 11};
+
+		refresh_timeout();
+		co_await http::async_write(stream_, response, boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+
+		if (ec) {
+			logging::error("{}: Error sending [100-continue] response: {}", __func__, ec.message());
+		}
+		else {
+			logging::debug("{}: Sent 100-continue", __func__);
+		}
+
+		co_return ec;
+	} // async_send_continue
 
 	auto session::on_write(bool close, boost::beast::error_code ec, std::size_t bytes_transferred) -> void
 	{
@@ -0,0 +1,146 @@
+#include "irods/private/s3_api/signing_key_cache.hpp"
+
+#include <date/date.h>
+
+#include <charconv>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace irods::s3::authentication
+{
+	signing_key_cache::signing_key_cache(std::size_t _capacity)
+		: capacity_per_shard_{(_capacity + shard_count - 1) / shard_count}
+	{
+	} // constructor
+
+	auto signing_key_cache::find(
+		std::string_view _access_key_id,
+		std::string_view _date,
+		std::string_view _region,
+		std::uint64_t _generation,
+		clock_type::time_point _now) -> std::optional<entry>
+	{
+		if (!enabled()) {
+			return std::nullopt;
+		}
+
+		const auto key = make_key(_access_key_id, _date, _region);
+		auto& shard = shard_for(key);
+
+		{
+			std::scoped_lock lock{shard.mtx};
+
+			if (const auto iter = shard.entries.find(key); iter != std::end(shard.entries)) {
+				if (iter->second.generation == _generation && _now < iter->second.expires_at) {
+					hits_.fetch_add(1, std::memory_order_relaxed);
+					return iter->second.data;
+				}
+
+				shard.entries.erase(iter);
+			}
+		}
+
+		misses_.fetch_add(1, std::memory_order_relaxed);
+
+		return std::nullopt;
+	} // find
+
+	auto signing_key_cache::insert(
+		std::string_view _access_key_id,
+		std::string_view _date,
+		std::string_view _region,
+		std::uint64_t _generation,
+		entry _entry,
+		clock_type::time_point _now) -> void
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		const auto expires_at = signing_key_expiration(_date);
+		if (!expires_at || *expires_at <= _now) {
+			return;
+		}
+
+		auto key = make_key(_access_key_id, _date, _region);
+		auto& shard = shard_for(key);
+
+		std::scoped_lock lock{shard.mtx};
+
+		if (shard.entries.size() >= capacity_per_shard_ && shard.entries.count(key) == 0) {
+			// Make room by removing the entries which can no longer be used. If all entries are
+			// still valid, remove an arbitrary one.
+			std::erase_if(shard.entries, [_generation, _now](const auto& _kv) {
+				return _kv.second.generation != _generation || _now >= _kv.second.expires_at;
+			});
+
+			if (shard.entries.size() >= capacity_per_shard_) {
+				shard.entries.erase(std::begin(shard.entries));
+			}
+		}
+
+		shard.entries.insert_or_assign(std::move(key), value{std::move(_entry), _generation, *expires_at});
+	} // insert
+
+	auto signing_key_cache::to_json() const -> nlohmann::json
+	{
+		const auto hits = hits_.load(std::memory_order_relaxed);
+		const auto misses = misses_.load(std::memory_order_relaxed);
+		const auto lookups = hits + misses;
+
+		return {
+			{"hits", hits},
+			{"misses", misses},
+			{"hit_rate", (lookups > 0) ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0}};
+	} // to_json
+
+	auto signing_key_cache::make_key(std::string_view _access_key_id, std::string_view _date, std::string_view _region)
+		-> std::string
+	{
+		// Access key IDs, dates, and regions never contain a forward slash. This matches how they
+		// are joined in the credential scope.
+		std::string key;
+		key.reserve(_access_key_id.size() + _date.size() + _region.size() + 2);
+		key.append(_access_key_id).append(1, '/').append(_date).append(1, '/').append(_region);
+		return key;
+	} // make_key
+
+	auto signing_key_cache::shard_for(const std::string& _key) -> shard_type&
+	{
+		return shards_[std::hash<std::string>{}(_key) % shard_count];
+	} // shard_for
+
+	auto signing_key_expiration(std::string_view _date) -> std::optional<std::chrono::system_clock::time_point>
+	{
+		constexpr std::size_t date_length = 8; // YYYYMMDD
+
+		if (_date.size() != date_length) {
+			return std::nullopt;
+		}
+
+		const auto parse = [](std::string_view _sv) -> std::optional<int> {
+			int n{};
+			const auto* last = _sv.data() + _sv.size();
+			if (const auto [ptr, ec] = std::from_chars(_sv.data(), last, n); ec != std::errc{} || ptr != last) {
+				return std::nullopt;
+			}
+			return n;
+		};
+
+		const auto year = parse(_date.substr(0, 4));
+		const auto month = parse(_date.substr(4, 2));
+		const auto day = parse(_date.substr(6, 2));
+
+		if (!year || !month || !day || *year < 0) {
+			return std::nullopt;
+		}
+
+		const auto ymd = date::year{*year} / static_cast<unsigned>(*month) / static_cast<unsigned>(*day);
+		if (!ymd.ok()) {
+			return std::nullopt;
+		}
+
+		return date::sys_days{ymd} + date::days{1};
+	} // signing_key_expiration
+} // namespace irods::s3::authentication
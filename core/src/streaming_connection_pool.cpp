@@ -0,0 +1,178 @@
+#include "irods/private/s3_api/streaming_connection_pool.hpp"
+
+#include "irods/private/s3_api/identity.hpp"
+#include "irods/private/s3_api/log.hpp"
+
+#include <irods/irods_exception.hpp>
+#include <irods/rcConnect.h>
+#include <irods/rodsErrorTable.h>
+
+#ifdef IRODS_DEV_PACKAGE_IS_AT_LEAST_IRODS_5
+#  include <irods/authenticate.h>
+#  include <irods/irods_auth_constants.hpp> // For AUTH_PASSWORD_KEY.
+#endif // IRODS_DEV_PACKAGE_IS_AT_LEAST_IRODS_5
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace logging = irods::http::logging;
+
+namespace irods::http
+{
+	streaming_connection_pool::streaming_connection_pool(streaming_connection_pool_options _options)
+		: options_{std::move(_options)}
+	{
+		idle_.reserve(options_.size);
+	} // constructor
+
+	auto streaming_connection_pool::get_connection(const std::string& _username) -> connection_pointer
+	{
+		if (options_.enable_4_2_compatibility) {
+			return connection_pointer{connect(_username)};
+		}
+
+		while (true) {
+			idle_connection idle;
+
+			{
+				std::scoped_lock lock{mtx_};
+
+				if (idle_.empty()) {
+					break;
+				}
+
+				// Prefer a connection which already acts on behalf of the user so that the identity
+				// switch can be skipped. Otherwise, take the most recently returned connection
+				// because it is the least likely to have timed out.
+				auto iter = std::find_if(std::rbegin(idle_), std::rend(idle_), [this, &_username](const auto& _idle) {
+					return has_identity(*static_cast<const RcComm*>(*_idle.conn), _username, options_.zone);
+				});
+
+				if (iter == std::rend(idle_)) {
+					iter = std::rbegin(idle_);
+				}
+
+				idle = std::move(*iter);
+				idle_.erase(std::next(iter).base());
+			}
+
+			if (clock_type::now() - idle.created_at >= options_.refresh_timeout) {
+				logging::trace("{}: Disconnecting expired connection.", __func__);
+				continue;
+			}
+
+			// A failure usually means the connection was broken while it was idle. Try the next one.
+			if (const auto ec = switch_identity(static_cast<RcComm&>(*idle.conn), _username, options_.zone); ec < 0) {
+				logging::warn("{}: rc_switch_user error: {}. Disconnecting connection.", __func__, ec);
+				continue;
+			}
+
+			return make_pointer(std::move(idle.conn), idle.created_at);
+		}
+
+		// The new connection is authenticated as the user directly, so no identity switch is needed.
+		logging::trace("{}: No idle connections available. Creating new connection for [{}].", __func__, _username);
+		return make_pointer(connect(_username), clock_type::now());
+	} // get_connection
+
+	auto streaming_connection_pool::connect(const std::string& _username)
+		-> std::unique_ptr<irods::experimental::client_connection>
+	{
+		auto conn = std::make_unique<irods::experimental::client_connection>(
+			irods::experimental::defer_authentication,
+			options_.host,
+			options_.port,
+			irods::experimental::fully_qualified_username{options_.proxy_username, options_.zone},
+			irods::experimental::fully_qualified_username{_username, options_.zone});
+
+		auto* conn_ptr = static_cast<RcComm*>(*conn);
+
+		// The login functions require a mutable buffer.
+		auto password = options_.proxy_password;
+
+#ifdef IRODS_DEV_PACKAGE_IS_AT_LEAST_IRODS_5
+		const auto json_input = nlohmann::json{{"scheme", "native"}, {irods::AUTH_PASSWORD_KEY, password}};
+		if (const auto ec = rc_authenticate_client(conn_ptr, json_input.dump().c_str()); ec < 0)
+#else
+		if (const auto ec = clientLoginWithPassword(conn_ptr, password.data()); ec < 0)
+#endif // IRODS_DEV_PACKAGE_IS_AT_LEAST_IRODS_5
+		{
+			logging::error("{}: iRODS authentication error: {}", __func__, ec);
+			THROW(ec, "iRODS authentication error.");
+		}
+
+		return conn;
+	} // connect
+
+	auto streaming_connection_pool::mark_streams_closed(const connection_pointer& _conn) noexcept -> void
+	{
+		// Connections which are not pooled (i.e. in 4.2 compatibility mode) have no deleter of
+		// the pool. They are disconnected on release.
+		if (auto* deleter = std::get_deleter<connection_deleter>(_conn); deleter) {
+			deleter->mark_streams_closed();
+		}
+	} // mark_streams_closed
+
+	streaming_connection_pool::connection_deleter::connection_deleter(
+		streaming_connection_pool& _pool,
+		clock_type::time_point _created_at)
+		: pool_{&_pool}
+		, created_at_{_created_at}
+	{
+	} // constructor
+
+	streaming_connection_pool::connection_deleter::connection_deleter(const connection_deleter& _other)
+		: pool_{_other.pool_}
+		, created_at_{_other.created_at_}
+		, streams_closed_{_other.streams_closed_.load(std::memory_order_acquire)}
+	{
+	} // copy constructor
+
+	auto streaming_connection_pool::connection_deleter::operator()(irods::experimental::client_connection* _conn)
+		-> void
+	{
+		pool_->release(
+			std::unique_ptr<irods::experimental::client_connection>{_conn},
+			created_at_,
+			streams_closed_.load(std::memory_order_acquire));
+	} // operator()
+
+	auto streaming_connection_pool::make_pointer(
+		std::unique_ptr<irods::experimental::client_connection> _conn,
+		clock_type::time_point _created_at) -> connection_pointer
+	{
+		return {_conn.release(), connection_deleter{*this, _created_at}};
+	} // make_pointer
+
+	auto streaming_connection_pool::release(
+		std::unique_ptr<irods::experimental::client_connection> _conn,
+		clock_type::time_point _created_at,
+		bool _streams_closed) -> void
+	{
+		try {
+			// The user of the connection did not confirm that its streams were closed (e.g. a write
+			// failed, or an exception was thrown). Close the replicas left open so that the
+			// connection can be reused without switching its identity.
+			if (!_streams_closed) {
+				if (const auto ec = close_open_replicas(static_cast<RcComm&>(*_conn)); ec < 0) {
+					logging::warn("{}: Could not close open replicas: {}. Disconnecting connection.", __func__, ec);
+					return;
+				}
+			}
+
+			std::scoped_lock lock{mtx_};
+
+			if (idle_.size() < options_.size) {
+				idle_.push_back({std::move(_conn), _created_at});
+				return;
+			}
+		}
+		catch (...) {
+		}
+
+		// The pool is full. The connection is disconnected when _conn goes out of scope.
+	} // release
+} // namespace irods::http
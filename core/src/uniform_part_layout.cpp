@@ -0,0 +1,33 @@
+#include "irods/private/s3_api/uniform_part_layout.hpp"
+
+#include <algorithm>
+
+namespace irods::s3
+{
+	auto uniform_part_layout::record_part_size(unsigned int _part_number, std::uint64_t _size) noexcept -> bool
+	{
+		if (_size == part_size_) {
+			return true;
+		}
+
+		// A part written earlier was placed as though this part had the shared size.
+		if (_part_number < last_predicted_part_) {
+			return false;
+		}
+
+		first_irregular_part_ = std::min(first_irregular_part_, _part_number);
+
+		return true;
+	} // record_part_size
+
+	auto uniform_part_layout::predict_offset(unsigned int _part_number) noexcept -> std::optional<std::uint64_t>
+	{
+		if (_part_number == 0 || _part_number > first_irregular_part_) {
+			return std::nullopt;
+		}
+
+		last_predicted_part_ = std::max(last_predicted_part_, _part_number);
+
+		return std::uint64_t{_part_number - 1} * part_size_;
+	} // predict_offset
+} // namespace irods::s3
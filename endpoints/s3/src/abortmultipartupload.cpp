@@ -4,8 +4,10 @@
 #include "irods/private/s3_api/common_routines.hpp"
 #include "irods/private/s3_api/connection.hpp"
 #include "irods/private/s3_api/log.hpp"
+#include "irods/private/s3_api/multipart_state.hpp"
 #include "irods/private/s3_api/common.hpp"
 #include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/offload.hpp"
 #include "irods/private/s3_api/configuration.hpp"
 #include "irods/private/s3_api/globals.hpp"
 
@@ -28,9 +30,11 @@
 #include <mutex>
 #include <condition_variable>
 #include <memory>
+#include <optional>
 #include <thread>
 #include <chrono>
 #include <string>
+#include <utility>
 #include <sstream>
 
 namespace asio = boost::asio;
@@ -38,22 +42,6 @@ namespace beast = boost::beast;
 namespace fs = irods::experimental::filesystem;
 namespace logging = irods::http::logging;
 
-namespace irods::s3::api::multipart_global_state
-{
-	extern std::unordered_map<std::string, std::unordered_map<unsigned int, uint64_t>> part_size_map;
-	extern std::unordered_map<
-		std::string,
-		std::tuple<
-			irods::experimental::io::replica_token,
-			irods::experimental::io::replica_number,
-			std::shared_ptr<irods::experimental::client_connection>,
-			std::shared_ptr<irods::experimental::io::client::native_transport>,
-			std::shared_ptr<irods::experimental::io::odstream>>>
-		replica_token_number_and_odstream_map;
-
-	extern std::mutex multipart_global_state_mutex;
-} // end namespace irods::s3::api::multipart_global_state
-
 namespace
 {
 
@@ -75,11 +63,13 @@ namespace
 	};
 } //namespace
 
-void irods::s3::actions::handle_abortmultipartupload(
+static void handle_abortmultipartupload_impl(
 	irods::http::session_pointer_type session_ptr,
-	boost::beast::http::request_parser<boost::beast::http::empty_body>& empty_body_parser,
-	const boost::urls::url_view& url)
+	irods::http::request_context_pointer request_ctx)
 {
+	auto& empty_body_parser = request_ctx->parser();
+	const auto& url = request_ctx->url();
+
 	namespace part_shmem = irods::s3::api::multipart_global_state;
 
 	beast::http::response<beast::http::empty_body> response;
@@ -98,7 +88,7 @@ void irods::s3::actions::handle_abortmultipartupload(
 	auto conn = irods::get_connection(*irods_username);
 
 	fs::path path;
-	if (auto bucket = irods::s3::resolve_bucket(url.segments()); bucket.has_value()) {
+	if (const auto& bucket = request_ctx->bucket(); bucket.has_value()) {
 		path = bucket.value();
 		path = irods::s3::finish_path(path, url.segments());
 		logging::debug("{}: AbortMultipartUpload path={}", __func__, path.string());
@@ -135,23 +125,32 @@ void irods::s3::actions::handle_abortmultipartupload(
 		return;
 	}
 
-	// delete the entry in the replica_token_number_and_odstream_map
-	if (part_shmem::replica_token_number_and_odstream_map.find(upload_id) !=
-	    part_shmem::replica_token_number_and_odstream_map.end())
-	{
+	// take the open replica, if any, out of the upload state and close it
+	std::optional<part_shmem::open_replica_type> replica;
+	if (const auto upload = part_shmem::find_upload(upload_id); upload) {
+		std::lock_guard<std::mutex> guard(upload->mtx);
+		replica = std::exchange(upload->replica, std::nullopt);
+	}
+
+	if (replica) {
 		// Read all of the shared pointers in the tuple to make sure they are destructed in
 		// the order we require. std::tuple does not guarantee order of destruction.
-		auto conn_ptr = std::get<2>(part_shmem::replica_token_number_and_odstream_map[upload_id]);
-		auto transport_ptr = std::get<3>(part_shmem::replica_token_number_and_odstream_map[upload_id]);
-		auto dstream_ptr = std::get<4>(part_shmem::replica_token_number_and_odstream_map[upload_id]);
+		auto conn_ptr = std::get<2>(*replica);
+		auto transport_ptr = std::get<3>(*replica);
+		auto dstream_ptr = std::get<4>(*replica);
+		replica.reset();
+
 		if (dstream_ptr) {
 			dstream_ptr->close();
+			if (!dstream_ptr->fail() && conn_ptr) {
+				irods::http::streaming_connection_pool::mark_streams_closed(conn_ptr);
+			}
 		}
-
-		// delete the entry
-		part_shmem::replica_token_number_and_odstream_map.erase(upload_id);
 	}
 
+	// discard the parts held in memory
+	irods::http::globals::part_staging_area().erase(upload_id);
+
 	// get the base location for the part files
 	const nlohmann::json& config = irods::http::globals::configuration();
 	std::string part_file_location =
@@ -187,12 +186,18 @@ void irods::s3::actions::handle_abortmultipartupload(
 	}
 
 	// clean up shmem - on failures we don't want to clean up as this could be resent
-	{
-		std::lock_guard<std::mutex> guard(part_shmem::multipart_global_state_mutex);
-		part_shmem::part_size_map.erase(upload_id);
-	}
+	part_shmem::erase_upload(upload_id);
+	irods::http::globals::multipart_upload_index().erase(upload_id);
+	irods::http::globals::multipart_journal().record_upload_ended(upload_id);
 
 	logging::debug("{}: returned [{}]", __func__, response.reason());
 	session_ptr->send(std::move(response));
 	return;
+} // handle_abortmultipartupload_impl
+
+asio::awaitable<void> irods::s3::actions::handle_abortmultipartupload(
+	irods::http::session_pointer_type session_ptr,
+	irods::http::request_context_pointer request_ctx)
+{
+	co_await irods::http::offload([&] { handle_abortmultipartupload_impl(session_ptr, request_ctx); });
 } // handle_abortmultipartupload
@@ -1,14 +1,19 @@
 #include "irods/private/s3_api/s3_api.hpp"
 #include "irods/private/s3_api/authentication.hpp"
 #include "irods/private/s3_api/bucket.hpp"
+#include "irods/private/s3_api/checksum.hpp"
 #include "irods/private/s3_api/common_routines.hpp"
 #include "irods/private/s3_api/connection.hpp"
+#include "irods/private/s3_api/identity.hpp"
 #include "irods/private/s3_api/log.hpp"
+#include "irods/private/s3_api/multipart_state.hpp"
 #include "irods/private/s3_api/common.hpp"
 #include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/offload.hpp"
 #include "irods/private/s3_api/configuration.hpp"
 #include "irods/private/s3_api/globals.hpp"
 
+#include <irods/client_connection.hpp>
 #include <irods/dstream.hpp>
 #include <irods/transport/default_transport.hpp>
 #include <irods/irods_exception.hpp>
@@ -20,38 +25,41 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/experimental/channel.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 #include <fmt/format.h>
 #include <spdlog/spdlog.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <regex>
 #include <cstdio>
 #include <vector>
+#include <map>
 #include <mutex>
+#include <optional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <sstream>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 namespace asio = boost::asio;
 namespace beast = boost::beast;
 namespace fs = irods::experimental::filesystem;
 namespace logging = irods::http::logging;
 
-namespace irods::s3::api::multipart_global_state
-{
-	extern std::unordered_map<std::string, std::unordered_map<unsigned int, uint64_t>> part_size_map;
-	extern std::unordered_map<
-		std::string,
-		std::tuple<
-			irods::experimental::io::replica_token,
-			irods::experimental::io::replica_number,
-			std::shared_ptr<irods::experimental::client_connection>,
-			std::shared_ptr<irods::experimental::io::client::native_transport>,
-			std::shared_ptr<irods::experimental::io::odstream>>>
-		replica_token_number_and_odstream_map;
-
-	extern std::mutex multipart_global_state_mutex;
-} // end namespace irods::s3::api::multipart_global_state
-
 namespace
 {
 
@@ -65,34 +73,340 @@ namespace
 		uint64_t part_size;
 	};
 
-	struct upload_status
+	// A part which was not written to its final location when it was uploaded, and so must be
+	// written to iRODS by CompleteMultipartUpload.
+	struct pending_part
+	{
+		// The index of the part in completion_context::parts.
+		std::size_t index;
+
+		// The copy of the part held in memory, or nullptr if the part is in its part file.
+		const irods::s3::staged_part* staged_part;
+	};
+
+	// The state shared by the coroutines which write the parts of an upload to iRODS.
+	struct completion_context
 	{
-		int task_done_counter = 0;
-		bool fail_flag = false;
-		std::string error_string;
+		std::string irods_username;
+		std::string path;
+		std::string upload_id;
+		std::uint64_t buffer_size;
+		std::vector<part_info> parts;
+		std::map<unsigned int, std::unique_ptr<irods::s3::staged_part>> staged_parts;
+		std::optional<irods::experimental::io::replica_token> replica_token;
+		std::optional<irods::experimental::io::replica_number> replica_number;
+
+		// The parts to write, in order of their offsets.
+		std::vector<pending_part> pending;
+
+		std::atomic<bool> failed{false};
 	};
+
+	// Returns the ETag without its surrounding quotes, which clients may or may not send back.
+	auto strip_quotes(std::string_view _etag) -> std::string_view
+	{
+		if (_etag.size() >= 2 && _etag.front() == '"' && _etag.back() == '"') {
+			return _etag.substr(1, _etag.size() - 2);
+		}
+
+		return _etag;
+	} // strip_quotes
+
+	// A stream to the replica being written. Each coroutine uses a single stream for all of its
+	// parts rather than opening one per part.
+	struct part_writer
+	{
+		explicit part_writer(std::shared_ptr<irods::experimental::client_connection> _conn)
+			: conn_ptr{std::move(_conn)}
+			, xtrans{*conn_ptr}
+		{
+		}
+
+		std::shared_ptr<irods::experimental::client_connection> conn_ptr;
+		irods::experimental::io::client::default_transport xtrans;
+		irods::experimental::io::odstream d;
+
+		// The offset the stream is positioned at. Adjacent parts are written without a seek.
+		std::uint64_t position = 0;
+	}; // struct part_writer
+
+	// A read-only mapping of a part file. Writing the mapped pages to iRODS saves copying the file
+	// through an intermediate buffer.
+	class mapped_part_file
+	{
+	  public:
+		explicit mapped_part_file(const std::string& _filename)
+		{
+			const int fd = ::open(_filename.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd < 0) {
+				return;
+			}
+
+			struct stat st{};
+			if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+				void* p = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+				if (p != MAP_FAILED) {
+					::madvise(p, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+					data_ = static_cast<const char*>(p);
+					size_ = static_cast<std::size_t>(st.st_size);
+				}
+			}
+
+			::close(fd);
+		}
+
+		mapped_part_file(const mapped_part_file&) = delete;
+		auto operator=(const mapped_part_file&) -> mapped_part_file& = delete;
+
+		~mapped_part_file()
+		{
+			if (data_) {
+				::munmap(const_cast<char*>(data_), size_);
+			}
+		}
+
+		auto data() const noexcept -> const char*
+		{
+			return data_;
+		} // data
+
+		auto size() const noexcept -> std::size_t
+		{
+			return size_;
+		} // size
+
+	  private:
+		const char* data_{};
+		std::size_t size_{};
+	}; // class mapped_part_file
+
+	// Returns the parts which must be written to iRODS. A part without a staged copy or a part
+	// file was written to iRODS directly by UploadPart. This is a blocking operation.
+	auto find_pending_parts(const completion_context& _ctx) -> std::vector<pending_part>
+	{
+		std::vector<pending_part> pending;
+
+		for (std::size_t i = 0; i < _ctx.parts.size(); ++i) {
+			const auto part_number = static_cast<unsigned int>(i + 1);
+
+			if (const auto iter = _ctx.staged_parts.find(part_number); iter != _ctx.staged_parts.end()) {
+				pending.push_back({i, iter->second.get()});
+				continue;
+			}
+
+			std::error_code ec;
+			if (std::filesystem::exists(_ctx.parts[i].part_filename, ec)) {
+				pending.push_back({i, nullptr});
+			}
+			else {
+				logging::debug(
+					"{}: upload_id={} part_number={} Part was uploaded directly to iRODS. Skipping...",
+					__func__,
+					_ctx.upload_id,
+					part_number);
+			}
+		}
+
+		return pending;
+	} // find_pending_parts
+
+	// Splits the pending parts into at most _count contiguous ranges holding a similar number of
+	// bytes. Each range is given as the half-open interval [first, last) of indices into
+	// completion_context::pending.
+	auto split_pending_parts(const completion_context& _ctx, std::size_t _count)
+		-> std::vector<std::pair<std::size_t, std::size_t>>
+	{
+		std::uint64_t total_bytes = 0;
+		for (const auto& p : _ctx.pending) {
+			total_bytes += _ctx.parts[p.index].part_size;
+		}
+
+		std::vector<std::pair<std::size_t, std::size_t>> ranges;
+		std::size_t first = 0;
+		std::uint64_t bytes = 0;
+
+		for (std::size_t i = 0; i < _ctx.pending.size(); ++i) {
+			bytes += _ctx.parts[_ctx.pending[i].index].part_size;
+
+			// Close the range once it holds its share of the bytes. The last range takes the rest.
+			if (ranges.size() + 1 < _count && bytes * _count >= total_bytes * (ranges.size() + 1)) {
+				ranges.emplace_back(first, i + 1);
+				first = i + 1;
+			}
+		}
+
+		if (first < _ctx.pending.size()) {
+			ranges.emplace_back(first, _ctx.pending.size());
+		}
+
+		return ranges;
+	} // split_pending_parts
+
+	// Opens a stream to the replica being written. This is a blocking operation. Returns nullptr
+	// on failure.
+	auto open_part_writer(const completion_context& _ctx) -> std::unique_ptr<part_writer>
+	{
+		auto writer = std::make_unique<part_writer>(
+			irods::http::globals::streaming_connection_pool().get_connection(_ctx.irods_username));
+		writer->d.open(
+			writer->xtrans, *_ctx.replica_token, _ctx.path, *_ctx.replica_number, std::ios::out | std::ios::in);
+
+		if (!writer->d.is_open()) {
+			logging::error("{}: Failed to open dstream to iRODS path={} upload_id={}", __func__, _ctx.path, _ctx.upload_id);
+			return nullptr;
+		}
+
+		return writer;
+	} // open_part_writer
+
+	// Writes a single part to iRODS, either from memory or from its part file. This is a
+	// blocking operation. Returns false on failure.
+	auto write_part(const completion_context& _ctx, part_writer& _writer, const pending_part& _pending) -> bool
+	{
+		const auto part_number = static_cast<unsigned int>(_pending.index + 1);
+		const auto& part = _ctx.parts[_pending.index];
+
+		logging::debug(
+			"{}: upload_id={} part_number={} [filename={}][offset={}][size={}]",
+			__func__,
+			_ctx.upload_id,
+			part_number,
+			part.part_filename,
+			part.part_offset,
+			part.part_size);
+
+		if (_writer.position != part.part_offset) {
+			_writer.d.seekp(static_cast<std::streamoff>(part.part_offset));
+			_writer.position = part.part_offset;
+		}
+
+		std::uint64_t bytes_written = 0;
+
+		if (_pending.staged_part) {
+			// write the part from memory in a single call
+			_writer.d.write(_pending.staged_part->data(), static_cast<std::streamsize>(_pending.staged_part->size()));
+			bytes_written = _pending.staged_part->size();
+		}
+		else if (const mapped_part_file file{part.part_filename}; file.data()) {
+			// write the mapped part file in a single call
+			_writer.d.write(file.data(), static_cast<std::streamsize>(file.size()));
+			bytes_written = file.size();
+		}
+		else {
+			// The part file could not be mapped (e.g. it is empty). Fall back to reading it.
+			std::ifstream ifs{part.part_filename, std::ifstream::in | std::ifstream::binary};
+			if (!ifs.is_open()) {
+				logging::error(
+					"{}: Failed to open part file [{}] upload_id={} part_number={}",
+					__func__,
+					part.part_filename,
+					_ctx.upload_id,
+					part_number);
+				return false;
+			}
+
+			// borrow a read/write buffer from the pool
+			auto buffer = irods::http::globals::buffer_pool().acquire(_ctx.buffer_size);
+
+			while (ifs && _writer.d && !_ctx.failed) {
+				ifs.read(buffer.data(), static_cast<std::streamsize>(_ctx.buffer_size));
+				const auto read_bytes = static_cast<std::size_t>(ifs.gcount());
+
+				if (read_bytes > 0) {
+					_writer.d.write(buffer.data(), static_cast<std::streamsize>(read_bytes));
+					bytes_written += read_bytes;
+				}
+			}
+		}
+
+		_writer.position += bytes_written;
+
+		if (!_writer.d) {
+			logging::error(
+				"{}: Failed in writing part to iRODS upload_id={} part_number={}",
+				__func__,
+				_ctx.upload_id,
+				part_number);
+			return false;
+		}
+
+		logging::debug(
+			"{}: upload_id={} part_number={} wrote {} bytes at offset {} - part_size={}",
+			__func__,
+			_ctx.upload_id,
+			part_number,
+			bytes_written,
+			part.part_offset,
+			part.part_size);
+
+		return true;
+	} // write_part
+
+	// Writes the pending parts in [_first, _last) to iRODS through a single stream, stopping at
+	// the first failure. Each write runs on the background thread pool, which keeps the strand
+	// free while it is in progress.
+	auto write_parts(completion_context& _ctx, std::size_t _first, std::size_t _last) -> asio::awaitable<void>
+	{
+		if (_ctx.failed) {
+			co_return;
+		}
+
+		// The number of streams writing parts is bounded across all uploads. The permit is held
+		// until the stream is closed.
+		const auto permit = co_await irods::http::globals::part_writer_permits().async_acquire();
+
+		std::unique_ptr<part_writer> writer;
+
+		for (auto i = _first; i < _last && !_ctx.failed; ++i) {
+			const auto ok = co_await irods::http::offload([&] {
+				if (!writer) {
+					writer = open_part_writer(_ctx);
+				}
+
+				return writer && write_part(_ctx, *writer, _ctx.pending[i]);
+			});
+
+			if (!ok) {
+				_ctx.failed = true;
+			}
+		}
+
+		if (writer) {
+			co_await irods::http::offload([&writer] {
+				writer->d.close();
+				if (!writer->d.fail()) {
+					irods::http::streaming_connection_pool::mark_streams_closed(writer->conn_ptr);
+				}
+				writer.reset();
+			});
+		}
+	} // write_parts
 } //namespace
 
-void irods::s3::actions::handle_completemultipartupload(
+asio::awaitable<void> irods::s3::actions::handle_completemultipartupload(
 	irods::http::session_pointer_type session_ptr,
-	boost::beast::http::request_parser<boost::beast::http::empty_body>& empty_body_parser,
-	const boost::urls::url_view& url)
+	irods::http::request_context_pointer request_ctx)
 {
+	auto& empty_body_parser = request_ctx->parser();
+	const auto& url = request_ctx->url();
+
 	namespace part_shmem = irods::s3::api::multipart_global_state;
 
 	beast::http::response<beast::http::empty_body> response;
 
 	// Authenticate
-	auto irods_username = irods::s3::authentication::authenticates(empty_body_parser, url);
+	auto irods_username = co_await irods::http::offload(
+		[&] { return irods::s3::authentication::authenticates(empty_body_parser, url); });
 	if (!irods_username) {
 		logging::error("{}: Failed to authenticate.", __func__);
 		response.result(beast::http::status::forbidden);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
-	auto conn = irods::get_connection(*irods_username);
+	auto conn = co_await irods::http::offload([&] { return irods::get_connection(*irods_username); });
 
 	std::filesystem::path s3_bucket;
 	std::filesystem::path s3_key;
@@ -111,7 +425,7 @@ void irods::s3::actions::handle_completemultipartupload(
 	logging::debug("{} s3_bucket={} s3_key={}", __func__, s3_bucket.string(), s3_key.string());
 
 	fs::path path;
-	if (auto bucket = irods::s3::resolve_bucket(url.segments()); bucket.has_value()) {
+	if (const auto& bucket = request_ctx->bucket(); bucket.has_value()) {
 		path = bucket.value();
 		path = irods::s3::finish_path(path, url.segments());
 		logging::debug("{}: CompleteMultipartUpload path={}", __func__, path.string());
@@ -121,7 +435,7 @@ void irods::s3::actions::handle_completemultipartupload(
 		response.result(beast::http::status::forbidden);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
 	// get the uploadId from the param list
@@ -135,7 +449,7 @@ void irods::s3::actions::handle_completemultipartupload(
 		response.result(beast::http::status::bad_request);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
 	// Do not allow an upload_id that is not in the format we have defined. People could do bad things
@@ -145,16 +459,28 @@ void irods::s3::actions::handle_completemultipartupload(
 		response.result(beast::http::status::bad_request);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
 	beast::http::response<beast::http::string_body> string_body_response(std::move(response));
 	string_body_response.result(beast::http::status::ok);
 
+	// Ask the client for the body if it is waiting for permission to send it.
+	if (const auto ec = co_await session_ptr->async_send_continue(); ec) {
+		co_return;
+	}
+
 	// change the parser to a string_body parser and read the body
 	empty_body_parser.eager(true);
 	beast::http::request_parser<boost::beast::http::string_body> parser{std::move(empty_body_parser)};
-	beast::http::read(session_ptr->stream().socket(), session_ptr->get_buffer(), parser);
+	beast::error_code ec;
+	session_ptr->refresh_timeout();
+	co_await beast::http::async_read(
+		session_ptr->stream(), session_ptr->get_buffer(), parser, asio::redirect_error(asio::use_awaitable, ec));
+	if (ec) {
+		logging::error("{}: Error reading request body: {}", __func__, ec.message());
+		co_return;
+	}
 
 	std::string& request_body = parser.get().body();
 	logging::debug("{}: request_body\n{}", __func__, request_body);
@@ -162,6 +488,9 @@ void irods::s3::actions::handle_completemultipartupload(
 	int max_part_number = -1;
 	int min_part_number = 1000;
 	int part_number_count = 0;
+
+	// The ETags the client received for each part, keyed on part number.
+	std::map<int, std::string> part_etags;
 	boost::property_tree::ptree request_body_property_tree;
 	try {
 		std::stringstream ss;
@@ -171,9 +500,14 @@ void irods::s3::actions::handle_completemultipartupload(
 		     request_body_property_tree.get_child("CompleteMultipartUpload")) {
 			const std::string& tag = v.first;
 			if (tag == "Part") {
+				std::optional<int> part_number;
+				std::string part_etag;
 				for (boost::property_tree::ptree::value_type& v2 : v.second) {
 					const std::string& tag = v2.first;
-					if (tag == "PartNumber") {
+					if (tag == "ETag") {
+						part_etag = v2.second.get_value<std::string>();
+					}
+					else if (tag == "PartNumber") {
 						int current_part_number = v2.second.get_value<int>();
 						if (current_part_number < min_part_number) {
 							min_part_number = current_part_number;
@@ -182,8 +516,12 @@ void irods::s3::actions::handle_completemultipartupload(
 							max_part_number = current_part_number;
 						}
 						++part_number_count;
+						part_number = current_part_number;
 					}
 				}
+				if (part_number) {
+					part_etags[*part_number] = std::move(part_etag);
+				}
 			}
 		}
 	}
@@ -192,14 +530,14 @@ void irods::s3::actions::handle_completemultipartupload(
 		response.result(boost::beast::http::status::bad_request);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 	catch (...) {
 		logging::debug("{}: Unknown error parsing XML body.", __func__);
 		response.result(boost::beast::http::status::bad_request);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
 	// At this point we are just checking that the part numbers start
@@ -210,7 +548,7 @@ void irods::s3::actions::handle_completemultipartupload(
 		response.result(boost::beast::http::status::bad_request);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
 	if (max_part_number != part_number_count) {
@@ -218,21 +556,71 @@ void irods::s3::actions::handle_completemultipartupload(
 		response.result(boost::beast::http::status::bad_request);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
+	}
+
+	// The state recorded by CreateMultipartUpload and UploadPart, if any.
+	const auto upload = part_shmem::find_upload(upload_id);
+
+	// Each part listed must have been received in full, with the ETag returned by UploadPart. The
+	// ETag of the object is derived from the MD5 digests the server computed for the parts.
+	std::vector<std::string> ordered_part_etags;
+	ordered_part_etags.reserve(part_etags.size());
+	{
+		std::unique_lock<std::mutex> guard;
+		if (upload) {
+			guard = std::unique_lock<std::mutex>{upload->mtx};
+		}
+
+		for (const auto& [part_number, part_etag] : part_etags) {
+			const irods::s3::multipart_upload_part* part = nullptr;
+			if (upload) {
+				if (const auto iter = upload->uploaded_parts.find(static_cast<unsigned int>(part_number));
+				    iter != upload->uploaded_parts.end())
+				{
+					part = &iter->second;
+				}
+			}
+
+			if (!part || strip_quotes(part->etag) != strip_quotes(part_etag)) {
+				if (guard.owns_lock()) {
+					guard.unlock();
+				}
+
+				irods::s3::api::common_routines::send_error_response(
+					session_ptr,
+					beast::http::status::bad_request,
+					"InvalidPart",
+					fmt::format(
+						"Part [{}] of upload [{}] was not uploaded, or its ETag does not match", part_number, upload_id),
+					url.path(),
+					__func__);
+				co_return;
+			}
+
+			ordered_part_etags.push_back(part->etag);
+		}
+	}
+
+	const auto etag = irods::s3::make_multipart_etag(ordered_part_etags);
+	if (!etag) {
+		logging::error("{}: Upload ID [{}] - At least one part has an invalid ETag.", __func__, upload_id);
+		response.result(boost::beast::http::status::internal_server_error);
+		logging::debug("{}: returned [{}]", __func__, response.reason());
+		session_ptr->send(std::move(response));
+		co_return;
 	}
 
 	// debug
 	if (spdlog::get_level() == spdlog::level::debug || spdlog::get_level() == spdlog::level::trace) {
-		std::lock_guard<std::mutex> guard(part_shmem::multipart_global_state_mutex);
 		logging::info("{}:{} {}: ******* THIS RAN ********", __FILE__, __LINE__, __func__);
 
-		if (part_shmem::part_size_map.find(upload_id) != part_shmem::part_size_map.end()) {
+		if (upload) {
+			std::lock_guard<std::mutex> guard(upload->mtx);
 			logging::debug("{}:{} {}: ------------------", __FILE__, __LINE__, __func__);
 			for (int i = 1; i <= part_number_count; ++i) {
-				bool found = part_shmem::part_size_map[upload_id].find(i) != part_shmem::part_size_map[upload_id].end();
-				if (found) {
-					logging::debug(
-						"{}:{} {}: {}: {}", __FILE__, __LINE__, __func__, i, part_shmem::part_size_map[upload_id][i]);
+				if (const auto part_size = upload->part_sizes.get(i); part_size) {
+					logging::debug("{}:{} {}: {}: {}", __FILE__, __LINE__, __func__, i, *part_size);
 				}
 				else {
 					logging::debug("{}:{} {}: {}: UNKNOWN", __FILE__, __LINE__, __func__, i);
@@ -252,18 +640,20 @@ void irods::s3::actions::handle_completemultipartupload(
 		config.value(nlohmann::json::json_pointer{"/s3_server/multipart_upload_part_files_directory"}, ".");
 
 	{
-		std::lock_guard<std::mutex> guard(part_shmem::multipart_global_state_mutex);
+		std::unique_lock<std::mutex> guard;
+		if (upload) {
+			guard = std::unique_lock<std::mutex>{upload->mtx};
+		}
+
 		uint64_t offset_counter = 0;
 		for (int current_part_number = 1; current_part_number <= max_part_number; ++current_part_number) {
 			std::string part_filename =
 				part_file_location + "/irods_s3_api_" + upload_id + "." + std::to_string(current_part_number);
 
-			if (part_shmem::part_size_map.find(upload_id) != part_shmem::part_size_map.end() &&
-			    part_shmem::part_size_map[upload_id].find(current_part_number) !=
-			        part_shmem::part_size_map[upload_id].end())
-			{
-				// get size from part_size_map in shmem
-				auto part_size = part_shmem::part_size_map[upload_id][current_part_number];
+			const auto known_part_size = upload ? upload->part_sizes.get(current_part_number) : std::nullopt;
+			if (known_part_size) {
+				// get size recorded by UploadPart
+				auto part_size = *known_part_size;
 				part_info_vector.push_back({part_filename, offset_counter, part_size});
 				offset_counter += part_size;
 			}
@@ -279,204 +669,209 @@ void irods::s3::actions::handle_completemultipartupload(
 					response.result(beast::http::status::internal_server_error);
 					logging::debug("{}: returned [{}]", __func__, response.reason());
 					session_ptr->send(std::move(response));
-					return;
+					co_return;
 				}
 			}
 		}
 	}
 
-	uint64_t read_buffer_size = irods::s3::get_put_object_buffer_size_in_bytes();
+	// Parts placed using the part size of the upload assumed that every part preceding them has
+	// that size. If one does not, the parts are not where they belong.
+	if (upload) {
+		std::lock_guard<std::mutex> guard(upload->mtx);
 
-	upload_status upload_status_object;
-	std::condition_variable cv;
-	std::mutex cv_mutex;
+		if (upload->layout) {
+			const auto& layout = *upload->layout;
+			const auto last_part = std::min<unsigned int>(layout.last_predicted_part(), max_part_number + 1);
 
-	// get the replica_token and replica_number from replica_token_number_and_odstream_map
-	const auto& replica_token = std::get<0>(part_shmem::replica_token_number_and_odstream_map[upload_id]);
-	const auto& replica_number = std::get<1>(part_shmem::replica_token_number_and_odstream_map[upload_id]);
-
-	// start tasks on thread pool for part uploads
-	for (int current_part_number = 1; current_part_number <= max_part_number; ++current_part_number) {
-		logging::debug(
-			"{}: pushing upload work on thread pool {}-{} : [filename={}][offset={}][size={}]",
-			__func__,
-			upload_id,
-			current_part_number,
-			part_info_vector[current_part_number - 1].part_filename,
-			part_info_vector[current_part_number - 1].part_offset,
-			part_info_vector[current_part_number - 1].part_size);
-
-		irods::http::globals::background_task(
-			[session_ptr,
-		     irods_username,
-		     path,
-		     &cv_mutex,
-		     &cv,
-		     &upload_status_object,
-		     &replica_token,
-		     &replica_number,
-		     current_part_number,
-		     upload_id,
-		     part_filename = part_info_vector[current_part_number - 1].part_filename,
-		     part_offset = part_info_vector[current_part_number - 1].part_offset,
-		     part_size = part_info_vector[current_part_number - 1].part_size, // don't really need this
-		     read_buffer_size,
-		     func = __func__]() mutable {
-				uint64_t read_write_byte_counter = 0;
-
-				// upon exit, increment the task_done_counter and notify the coordinating thread
-				const irods::at_scope_exit signal_done{[&cv_mutex,
-			                                            &cv,
-			                                            &upload_status_object,
-			                                            upload_id,
-			                                            current_part_number,
-			                                            part_offset,
-			                                            part_size,
-			                                            &read_write_byte_counter,
-			                                            func]() {
-					{
-						std::lock_guard<std::mutex> lk(cv_mutex);
-						(upload_status_object.task_done_counter)++;
-					}
-					logging::debug(
-						"{}: upload_id={} part_number={} wrote {} bytes at offset {} - part_size={}",
-						func,
-						upload_id,
-						current_part_number,
-						read_write_byte_counter,
-						part_offset,
-						part_size);
-					cv.notify_one();
-				}};
-
-				// create a read/write buffer
-				std::vector<char> buf_vector(read_buffer_size);
-
-				// open the part file
-				std::ifstream ifs;
-				ifs.open(part_filename, std::ifstream::in);
-
-				if (!ifs.is_open()) {
-					// if there is no part file then this part was uploaded directly to iRODS
-					logging::debug(
-						"{}: upload_id={} part_number={} Part was uploaded directly to iRODS. Skipping...",
-						func,
+			for (unsigned int i = 1; i < last_part; ++i) {
+				if (part_info_vector[i - 1].part_size != layout.part_size()) {
+					logging::error(
+						"{}: Upload ID [{}] - part_number [{}] has size [{}], but later parts were placed assuming "
+						"the part size [{}].",
+						__func__,
 						upload_id,
-						current_part_number);
-					return;
+						i,
+						part_info_vector[i - 1].part_size,
+						layout.part_size());
+					response.result(beast::http::status::bad_request);
+					logging::debug("{}: returned [{}]", __func__, response.reason());
+					session_ptr->send(std::move(response));
+					co_return;
 				}
+			}
+		}
+	}
 
-				// open dstream for writing to iRODS
-				auto conn = irods::get_connection(*irods_username);
-				irods::experimental::io::client::default_transport xtrans{conn};
-				irods::experimental::io::dstream ds; // irods dstream for writing directly to irods
-				ds.open(
-					xtrans,
-					replica_token,
-					path,
-					irods::experimental::io::replica_number{replica_number}); //, std::ios::out | std::ios::ate);
-
-				if (!ds.is_open()) {
-					std::lock_guard<std::mutex> lk(cv_mutex);
-					upload_status_object.fail_flag = true;
-					std::stringstream ss;
-					ss << "Failed to open dstream to iRODS path=" << path;
-					upload_status_object.error_string = ss.str();
-					logging::error(
-						"{}: {} upload_id={} part_number={}",
-						func,
-						upload_status_object.error_string,
-						upload_id,
-						current_part_number);
-					return;
+	// The parts which UploadPart staged in memory and has not written to iRODS yet. UploadPart
+	// may be in the middle of writing some of them, so wait until it is done with them. The
+	// staging area wakes this coroutine once no part is in flight. The wait is bounded by the
+	// request timeout.
+	std::map<unsigned int, std::unique_ptr<irods::s3::staged_part>> staged_parts;
+	{
+		auto& staging_area = irods::http::globals::part_staging_area();
+		const auto executor = co_await asio::this_coro::executor;
+		const auto deadline =
+			std::chrono::steady_clock::now() + std::chrono::seconds{irods::s3::get_request_timeout_in_seconds()};
+
+		// The callback may outlive this request, so it shares the ownership of the timer. It
+		// cancels the timer on the strand of the session, which is where the timer is waited on.
+		auto timer = std::make_shared<asio::steady_timer>(executor, deadline);
+		const auto wake_up = [executor, timer] {
+			asio::post(executor, [timer] { timer->cancel(); });
+		};
+
+		while (true) {
+			if (auto parts = staging_area.try_take_all(upload_id, wake_up); parts) {
+				staged_parts = std::move(*parts);
+				break;
+			}
+
+			if (std::chrono::steady_clock::now() >= deadline) {
+				logging::error(
+					"{}: Upload ID [{}] - Timed out waiting for UploadPart to finish writing its parts.",
+					__func__,
+					upload_id);
+				irods::s3::api::common_routines::send_error_response(
+					session_ptr,
+					beast::http::status::service_unavailable,
+					"ServiceUnavailable",
+					fmt::format("Parts of upload [{}] are still being written. Please retry.", upload_id),
+					url.path(),
+					__func__);
+				co_return;
+			}
+
+			// Completes when the timer is cancelled by wake_up or when the deadline passes.
+			boost::system::error_code ignored;
+			co_await timer->async_wait(asio::redirect_error(asio::use_awaitable, ignored));
+		}
+
+		// The wait may have used up the time the session allows for sending the response.
+		session_ptr->refresh_timeout();
+	}
+
+	completion_context context{
+		.irods_username = *irods_username,
+		.path = path.string(),
+		.upload_id = upload_id,
+		.buffer_size = irods::s3::get_put_object_buffer_size_in_bytes(),
+		.parts = std::move(part_info_vector),
+		.staged_parts = std::move(staged_parts)};
+
+	if (upload) {
+		co_await irods::http::offload([&context, &upload] {
+			std::lock_guard<std::mutex> guard(upload->mtx);
+
+			// An upload restored from the multipart journal may not have written a part to iRODS since
+			// the server restarted. Reopen its data object to write the remaining parts.
+			if (upload->resumed && !upload->replica) {
+				auto conn = irods::http::globals::streaming_connection_pool().get_connection(context.irods_username);
+				auto tp = std::make_shared<irods::experimental::io::client::default_transport>(*conn);
+				auto d = std::make_shared<irods::experimental::io::odstream>();
+
+				part_shmem::open_data_object(*upload, static_cast<RcComm&>(*conn), *d, *tp, context.path);
+				if (d->is_open()) {
+					upload->replica.emplace(d->replica_token(), d->replica_number(), conn, tp, d);
 				}
+			}
 
-				// seek to start of part
-				ds.seekp(part_offset);
+			if (upload->replica) {
+				context.replica_token = std::get<0>(*upload->replica);
+				context.replica_number = std::get<1>(*upload->replica);
+			}
+		});
+	}
 
-				// read the file in parts into buffer and stream to iRODS
-				while (ifs) {
-					// if someone failed then bail
-					{
-						std::lock_guard<std::mutex> lk(cv_mutex);
-						if (upload_status_object.fail_flag) {
-							break;
-						}
-					}
+	if (!context.replica_token || !context.replica_number) {
+		logging::error("{}: Upload ID [{}] - No part of the upload was written to iRODS.", __func__, upload_id);
+		response.result(beast::http::status::internal_server_error);
+		logging::debug("{}: returned [{}]", __func__, response.reason());
+		session_ptr->send(std::move(response));
+		co_return;
+	}
 
-					// Try to read next chunk of data
-					ifs.read(buf_vector.data(), read_buffer_size);
-					size_t read_bytes = ifs.gcount();
-					read_write_byte_counter += read_bytes;
-					if (read_bytes) {
-						ds.write((char*) buf_vector.data(), read_bytes);
-
-						if (ds.fail()) {
-							std::lock_guard<std::mutex> lk(cv_mutex);
-							upload_status_object.fail_flag = true;
-							upload_status_object.error_string = "Failed in writing part to iRODS";
-							logging::error(
-								"{}: {} upload_id={} part_number={}",
-								func,
-								upload_status_object.error_string,
-								upload_id,
-								current_part_number);
-							break;
-						}
+	context.pending = co_await irods::http::offload([&context] { return find_pending_parts(context); });
+
+	// The pending parts are split into contiguous ranges, each written by a coroutine running on
+	// this session's strand through its own stream. No thread waits for another.
+	if (!context.pending.empty()) {
+		using worker_done_channel = asio::experimental::channel<void(boost::system::error_code)>;
+
+		auto executor = co_await asio::this_coro::executor;
+		const auto ranges = split_pending_parts(
+			context, std::max<std::uint64_t>(1, irods::s3::get_complete_multipart_upload_parallel_part_writes()));
+		worker_done_channel workers_done{executor, ranges.size()};
+
+		for (const auto& [first, last] : ranges) {
+			asio::co_spawn(
+				executor, write_parts(context, first, last), [&context, &workers_done](std::exception_ptr _eptr) {
+					if (_eptr) {
+						context.failed = true;
 					}
-				}
+					workers_done.try_send(boost::system::error_code{});
+				});
+		}
 
-				ds.close();
-				ifs.close();
-				return;
-			});
+		boost::system::error_code ignored;
+		for (std::size_t i = 0; i < ranges.size(); ++i) {
+			co_await workers_done.async_receive(asio::redirect_error(asio::use_awaitable, ignored));
+		}
 	}
 
-	// wait until all threads are complete
-	std::unique_lock<std::mutex> lk(cv_mutex);
-	cv.wait(lk, [&upload_status_object, max_part_number, func = __func__]() {
-		logging::debug("{}: wait: task_done_counter is {}", func, upload_status_object.task_done_counter);
-		return upload_status_object.task_done_counter == max_part_number;
-	});
+	// close the object and forget the open replica of the upload
+	co_await irods::http::offload([&, func = __func__] {
+		std::shared_ptr<irods::experimental::client_connection> conn_ptr;
+		std::shared_ptr<irods::experimental::io::client::native_transport> transport_ptr;
+		std::shared_ptr<irods::experimental::io::odstream> dstream_ptr;
 
-	// close the object and delete the entry in the replica_token_number_and_odstream_map
-	if (part_shmem::replica_token_number_and_odstream_map.find(upload_id) !=
-	    part_shmem::replica_token_number_and_odstream_map.end())
-	{
-		// Read all of the shared pointers in the tuple to make sure they are destructed in
-		// the order we require. std::tuple does not guarantee order of destruction.
-		auto conn_ptr = std::get<2>(part_shmem::replica_token_number_and_odstream_map[upload_id]);
-		auto transport_ptr = std::get<3>(part_shmem::replica_token_number_and_odstream_map[upload_id]);
-		auto dstream_ptr = std::get<4>(part_shmem::replica_token_number_and_odstream_map[upload_id]);
+		{
+			std::lock_guard<std::mutex> guard(upload->mtx);
+
+			if (upload->replica) {
+				// Read all of the shared pointers in the tuple to make sure they are destructed in
+				// the order we require. std::tuple does not guarantee order of destruction.
+				conn_ptr = std::get<2>(*upload->replica);
+				transport_ptr = std::get<3>(*upload->replica);
+				dstream_ptr = std::get<4>(*upload->replica);
+
+				// delete the entry
+				upload->replica.reset();
+			}
+		}
 
-		logging::trace("{}:{} Closing iRODS data object.", __func__, __LINE__);
+		logging::trace("{}:{} Closing iRODS data object.", func, __LINE__);
 		if (dstream_ptr) {
 			dstream_ptr->close();
+			if (!dstream_ptr->fail() && conn_ptr) {
+				irods::http::streaming_connection_pool::mark_streams_closed(conn_ptr);
+			}
 		}
+	});
 
-		// delete the entry
-		part_shmem::replica_token_number_and_odstream_map.erase(upload_id);
-	}
+	// check to see if any part failed
+	if (context.failed) {
+		// Keep the staged parts, as the request could be resent.
+		for (auto& [part_number, part] : context.staged_parts) {
+			irods::http::globals::part_staging_area().insert(upload_id, part_number, std::move(part));
+		}
 
-	// check to see if any threads failed
-	if (upload_status_object.fail_flag) {
-		logging::error("{}: {}", __func__, upload_status_object.error_string);
+		logging::error("{}: Upload ID [{}] - Failed to write the parts to iRODS.", __func__, upload_id);
 		response.result(beast::http::status::internal_server_error);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
 	// remove the temporary part files - on failures we don't want to clean up as this could be resent
-	for (int i = 0; i < max_part_number; ++i) {
-		std::remove(part_info_vector[i].part_filename.c_str());
+	for (const auto& part : context.parts) {
+		std::remove(part.part_filename.c_str());
 	}
 
 	// clean up shmem - on failures we don't want to clean up as this could be resent
-	{
-		std::lock_guard<std::mutex> guard(part_shmem::multipart_global_state_mutex);
-		part_shmem::part_size_map.erase(upload_id);
-	}
+	part_shmem::erase_upload(upload_id);
+	irods::http::globals::multipart_upload_index().erase(upload_id);
+	irods::http::globals::multipart_journal().record_upload_ended(upload_id);
 
 	// Now send the response
 	// Example response:
@@ -498,7 +893,7 @@ void irods::s3::actions::handle_completemultipartupload(
 	document.add("CompleteMultipartUploadResult.Location", s3_region);
 	document.add("CompleteMultipartUploadResult.Bucket", s3_bucket.string());
 	document.add("CompleteMultipartUploadResult.Key", s3_key);
-	document.add("CompleteMultipartUploadResult.ETag", "TBD");
+	document.add("CompleteMultipartUploadResult.ETag", *etag);
 
 	boost::property_tree::write_xml(s, document, settings);
 	string_body_response.body() = s.str();
@@ -506,5 +901,4 @@ void irods::s3::actions::handle_completemultipartupload(
 	string_body_response.result(boost::beast::http::status::ok);
 	logging::debug("{}: returned [{}]", __func__, string_body_response.reason());
 	session_ptr->send(std::move(string_body_response));
-	return;
 }
@@ -6,6 +6,7 @@
 #include "irods/private/s3_api/log.hpp"
 #include "irods/private/s3_api/common.hpp"
 #include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/offload.hpp"
 
 #include <irods/irods_exception.hpp>
 
@@ -22,11 +23,13 @@ namespace beast = boost::beast;
 namespace fs = irods::experimental::filesystem;
 namespace logging = irods::http::logging;
 
-void irods::s3::actions::handle_copyobject(
+static void handle_copyobject_impl(
 	irods::http::session_pointer_type session_ptr,
-	boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-	const boost::urls::url_view& url)
+	irods::http::request_context_pointer request_ctx)
 {
+	auto& parser = request_ctx->parser();
+	const auto& url = request_ctx->url();
+
 	beast::http::response<beast::http::empty_body> response;
 
 	auto irods_username = irods::s3::authentication::authenticates(parser, url);
@@ -51,7 +54,7 @@ void irods::s3::actions::handle_copyobject(
 		session_ptr->send(std::move(response));
 		return;
 	}
-	if (auto bucket = irods::s3::resolve_bucket(url.segments()); bucket.has_value()) {
+	if (const auto& bucket = request_ctx->bucket(); bucket.has_value()) {
 		destination_path = irods::s3::finish_path(bucket.value(), url.segments());
 	}
 	else {
@@ -125,4 +128,11 @@ void irods::s3::actions::handle_copyobject(
 	logging::debug("{}: returned [{}]", __func__, string_body_response.reason());
 	session_ptr->send(std::move(string_body_response));
 	return;
-}
+} // handle_copyobject_impl
+
+asio::awaitable<void> irods::s3::actions::handle_copyobject(
+	irods::http::session_pointer_type session_ptr,
+	irods::http::request_context_pointer request_ctx)
+{
+	co_await irods::http::offload([&] { handle_copyobject_impl(session_ptr, request_ctx); });
+} // handle_copyobject
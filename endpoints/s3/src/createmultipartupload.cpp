@@ -4,9 +4,12 @@
 #include "irods/private/s3_api/common_routines.hpp"
 #include "irods/private/s3_api/connection.hpp"
 #include "irods/private/s3_api/log.hpp"
+#include "irods/private/s3_api/multipart_state.hpp"
 #include "irods/private/s3_api/common.hpp"
 #include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/offload.hpp"
 #include "irods/private/s3_api/configuration.hpp"
+#include "irods/private/s3_api/globals.hpp"
 
 #include <irods/irods_exception.hpp>
 
@@ -19,16 +22,26 @@
 
 #include <fmt/format.h>
 
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <system_error>
+
 namespace asio = boost::asio;
 namespace beast = boost::beast;
 namespace fs = irods::experimental::filesystem;
 namespace logging = irods::http::logging;
 
-void irods::s3::actions::handle_createmultipartupload(
+static void handle_createmultipartupload_impl(
 	irods::http::session_pointer_type session_ptr,
-	boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-	const boost::urls::url_view& url)
+	irods::http::request_context_pointer request_ctx)
 {
+	auto& parser = request_ctx->parser();
+	const auto& url = request_ctx->url();
+
 	beast::http::response<beast::http::empty_body> response;
 
 	// Authenticate
@@ -60,7 +73,7 @@ void irods::s3::actions::handle_createmultipartupload(
 	logging::debug("{} s3_bucket={} s3_key={}", __func__, s3_bucket.string(), s3_key.string());
 
 	fs::path path;
-	if (auto bucket = irods::s3::resolve_bucket(url.segments()); bucket.has_value()) {
+	if (const auto& bucket = request_ctx->bucket(); bucket.has_value()) {
 		path = bucket.value();
 		path = irods::s3::finish_path(path, url.segments());
 		logging::debug("{}: CreateMultipartUpload path={}", __func__, path.string());
@@ -73,12 +86,50 @@ void irods::s3::actions::handle_createmultipartupload(
 		return;
 	}
 
+	// The client may announce the size shared by the parts of the upload (all but the last one).
+	// Parts are then written to iRODS at their offsets as they arrive, in any order.
+	std::optional<std::uint64_t> part_size;
+	if (const auto header = parser.get().find("x-irods-part-size"); header != parser.get().end()) {
+		const std::string value{header->value()};
+		std::uint64_t size = 0;
+		const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), size);
+
+		if (ec != std::errc{} || ptr != value.data() + value.size() || size == 0) {
+			logging::error("{}: Invalid x-irods-part-size header [{}].", __func__, value);
+			response.result(beast::http::status::bad_request);
+			logging::debug("{}: returned [{}]", __func__, response.reason());
+			session_ptr->send(std::move(response));
+			return;
+		}
+
+		part_size = size;
+	}
+
 	beast::http::response<beast::http::string_body> string_body_response(std::move(response));
 	string_body_response.result(boost::beast::http::status::ok);
 
 	// create the UploadId
 	std::string upload_id = boost::lexical_cast<std::string>(boost::uuids::random_generator()());
 
+	// ListMultipartUploads lists the upload until it is completed or aborted.
+	irods::s3::multipart_upload_entry upload_entry{
+		.bucket = s3_bucket.string(),
+		.key = s3_key.string(),
+		.upload_id = upload_id,
+		.owner = *irods_username,
+		.initiated = std::chrono::system_clock::now()};
+	irods::http::globals::multipart_journal().record_upload_created(upload_entry);
+	irods::http::globals::multipart_upload_index().insert(std::move(upload_entry));
+
+	if (part_size) {
+		namespace part_shmem = irods::s3::api::multipart_global_state;
+
+		const auto upload = part_shmem::find_or_create_upload(upload_id);
+		std::lock_guard<std::mutex> guard(upload->mtx);
+		upload->layout.emplace(*part_size);
+		irods::http::globals::multipart_journal().record_part_size(upload_id, *part_size);
+	}
+
 	boost::property_tree::ptree document;
 	document.add("InitiateMultipartUploadResult", "");
 	document.add("InitiateMultipartUploadResult.Bucket", s3_bucket.c_str());
@@ -96,4 +147,11 @@ void irods::s3::actions::handle_createmultipartupload(
 
 	string_body_response.prepare_payload();
 	session_ptr->send(std::move(string_body_response));
-}
+} // handle_createmultipartupload_impl
+
+asio::awaitable<void> irods::s3::actions::handle_createmultipartupload(
+	irods::http::session_pointer_type session_ptr,
+	irods::http::request_context_pointer request_ctx)
+{
+	co_await irods::http::offload([&] { handle_createmultipartupload_impl(session_ptr, request_ctx); });
+} // handle_createmultipartupload
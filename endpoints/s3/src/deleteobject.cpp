@@ -2,10 +2,13 @@
 #include "irods/private/s3_api/authentication.hpp"
 #include "irods/private/s3_api/bucket.hpp"
 #include "irods/private/s3_api/common_routines.hpp"
+#include "irods/private/s3_api/configuration.hpp"
 #include "irods/private/s3_api/connection.hpp"
+#include "irods/private/s3_api/globals.hpp"
 #include "irods/private/s3_api/log.hpp"
 #include "irods/private/s3_api/common.hpp"
 #include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/offload.hpp"
 
 #include <irods/filesystem.hpp>
 
@@ -39,11 +42,13 @@ namespace beast = boost::beast;
 namespace fs = irods::experimental::filesystem;
 namespace logging = irods::http::logging;
 
-void irods::s3::actions::handle_deleteobject(
+static void handle_deleteobject_impl(
 	irods::http::session_pointer_type session_ptr,
-	boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-	const boost::urls::url_view& url)
+	irods::http::request_context_pointer request_ctx)
 {
+	auto& parser = request_ctx->parser();
+	const auto& url = request_ctx->url();
+
 	beast::http::response<beast::http::empty_body> response;
 
 	// Permission verification stuff should go roughly here.
@@ -61,7 +66,7 @@ void irods::s3::actions::handle_deleteobject(
 	auto conn = irods::get_connection(*irods_username);
 
 	fs::path path;
-	if (auto bucket = irods::s3::resolve_bucket(url.segments()); bucket.has_value()) {
+	if (const auto& bucket = request_ctx->bucket(); bucket.has_value()) {
 		path = bucket.value();
 		path = irods::s3::finish_path(path, url.segments());
 		// Remove trailing slash - it confuses iRODS.
@@ -92,6 +97,7 @@ void irods::s3::actions::handle_deleteobject(
 		if (fs::client::is_collection(status)) {
 			if (fs::client::remove_all(conn, path, fs::remove_options::no_trash) >= 0) {
 				logging::debug("{}: Remove [{}] (collection) successful", __func__, path.c_str());
+				irods::http::globals::collection_cache().erase(irods::s3::get_zone(), path.string());
 				response.result(beast::http::status::ok);
 			}
 			else {
@@ -136,4 +142,11 @@ void irods::s3::actions::handle_deleteobject(
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
 	}
-}
+} // handle_deleteobject_impl
+
+asio::awaitable<void> irods::s3::actions::handle_deleteobject(
+	irods::http::session_pointer_type session_ptr,
+	irods::http::request_context_pointer request_ctx)
+{
+	co_await irods::http::offload([&] { handle_deleteobject_impl(session_ptr, request_ctx); });
+} // handle_deleteobject
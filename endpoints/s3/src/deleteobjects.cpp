@@ -2,10 +2,13 @@
 #include "irods/private/s3_api/authentication.hpp"
 #include "irods/private/s3_api/bucket.hpp"
 #include "irods/private/s3_api/common_routines.hpp"
+#include "irods/private/s3_api/configuration.hpp"
 #include "irods/private/s3_api/connection.hpp"
+#include "irods/private/s3_api/globals.hpp"
 #include "irods/private/s3_api/log.hpp"
 #include "irods/private/s3_api/common.hpp"
 #include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/offload.hpp"
 
 #include <irods/filesystem.hpp>
 
@@ -44,34 +47,28 @@ namespace beast = boost::beast;
 namespace fs = irods::experimental::filesystem;
 namespace logging = irods::http::logging;
 
-void irods::s3::actions::handle_deleteobjects(
+asio::awaitable<void> irods::s3::actions::handle_deleteobjects(
 	irods::http::session_pointer_type session_ptr,
-	boost::beast::http::request_parser<boost::beast::http::empty_body>& empty_body_parser,
-	const boost::urls::url_view& url)
+	irods::http::request_context_pointer request_ctx)
 {
+	auto& empty_body_parser = request_ctx->parser();
+	const auto& url = request_ctx->url();
+
 	beast::http::response<beast::http::string_body> response;
 
 	// Permission verification stuff should go roughly here.
 
-	auto irods_username = irods::s3::authentication::authenticates(empty_body_parser, url);
+	auto irods_username = co_await irods::http::offload(
+		[&] { return irods::s3::authentication::authenticates(empty_body_parser, url); });
 	if (!irods_username) {
 		response.result(beast::http::status::forbidden);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
-	// change the parser to a string_body parser and read the body
-	empty_body_parser.eager(true);
-	beast::http::request_parser<boost::beast::http::string_body> parser{std::move(empty_body_parser)};
-	beast::http::read(session_ptr->stream().socket(), session_ptr->get_buffer(), parser);
-
-	// Reconnect to the iRODS server as the target user.
-	// The rodsadmin account from the config file will act as the proxy for the user.
-	auto conn = irods::get_connection(*irods_username);
-
 	fs::path path;
-	if (auto bucket = irods::s3::resolve_bucket(url.segments()); bucket.has_value()) {
+	if (const auto& bucket = request_ctx->bucket(); bucket.has_value()) {
 		path = bucket.value();
 	}
 	else {
@@ -79,9 +76,30 @@ void irods::s3::actions::handle_deleteobjects(
 		logging::debug("{}: Could not find bucket", __func__);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
+	}
+
+	// Ask the client for the body if it is waiting for permission to send it.
+	if (const auto ec = co_await session_ptr->async_send_continue(); ec) {
+		co_return;
 	}
 
+	// change the parser to a string_body parser and read the body
+	empty_body_parser.eager(true);
+	beast::http::request_parser<boost::beast::http::string_body> parser{std::move(empty_body_parser)};
+	beast::error_code ec;
+	session_ptr->refresh_timeout();
+	co_await beast::http::async_read(
+		session_ptr->stream(), session_ptr->get_buffer(), parser, asio::redirect_error(asio::use_awaitable, ec));
+	if (ec) {
+		logging::error("{}: Error reading request body: {}", __func__, ec.message());
+		co_return;
+	}
+
+	// Reconnect to the iRODS server as the target user.
+	// The rodsadmin account from the config file will act as the proxy for the user.
+	auto conn = co_await irods::http::offload([&] { return irods::get_connection(*irods_username); });
+
 	// read and parse the body
 	std::string& request_body = parser.get().body();
 
@@ -97,14 +115,14 @@ void irods::s3::actions::handle_deleteobjects(
 		response.result(boost::beast::http::status::bad_request);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 	catch (...) {
 		logging::debug("{}: Unknown error parsing XML body.", __func__);
 		response.result(boost::beast::http::status::bad_request);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
 	bool quiet_flag = true;
@@ -131,99 +149,104 @@ void irods::s3::actions::handle_deleteobjects(
 		response.result(boost::beast::http::status::bad_request);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
 	logging::debug("{}: quiet_flag=[{}]", __func__, quiet_flag);
-	for (const auto& [key, value] : key_map) {
-		logging::debug("{}: key=[{}]", __func__, key);
-		try {
-			// Delete collections after all objects have been deleted.
-			if (key.back() == '/') {
-				logging::debug("{}: Skipping collection [{}]", __func__, key);
-				continue;
-			}
 
-			if (!fs::client::exists(conn, key)) {
-				logging::debug("{}: Could not find [{}]", __func__, key);
-				key_map[key] = "NoSuchKey";
-				continue;
-			}
+	// Removing the objects and collections requires many round trips to the iRODS server.
+	co_await irods::http::offload([&, func = __func__] {
+		for (const auto& [key, value] : key_map) {
+			logging::debug("{}: key=[{}]", func, key);
+			try {
+				// Delete collections after all objects have been deleted.
+				if (key.back() == '/') {
+					logging::debug("{}: Skipping collection [{}]", func, key);
+					continue;
+				}
 
-			if (fs::client::remove(conn, key, experimental::filesystem::remove_options::no_trash)) {
-				logging::debug("{}: Remove [{}] (object) successful", __func__, key);
-				key_map[key] = "Success";
-			}
-			else {
-				logging::debug("{}: Deletion of key [{}] (object) failed", __func__, key);
-				key_map[key] = "InternalError";
-			}
-		}
-		catch (const irods::exception& e) {
-			beast::http::response<beast::http::empty_body> response;
-			logging::debug("{}: Exception encountered", __func__);
+				if (!fs::client::exists(conn, key)) {
+					logging::debug("{}: Could not find [{}]", func, key);
+					key_map[key] = "NoSuchKey";
+					continue;
+				}
 
-			switch (e.code()) {
-				case USER_ACCESS_DENIED:
-				case CAT_NO_ACCESS_PERMISSION:
-					logging::debug("{}: No access to delete key [{}]", __func__, key);
-					key_map[key] = "AccessDenied";
-					break;
-				default:
-					logging::debug("{}: Unknown exception when deleting key [{}]", __func__, key);
+				if (fs::client::remove(conn, key, experimental::filesystem::remove_options::no_trash)) {
+					logging::debug("{}: Remove [{}] (object) successful", func, key);
+					key_map[key] = "Success";
+				}
+				else {
+					logging::debug("{}: Deletion of key [{}] (object) failed", func, key);
 					key_map[key] = "InternalError";
-					break;
+				}
 			}
-		}
-	}
-
-	logging::debug("{}: Deleting empty collections now.", __func__);
-	for (const auto& [key, value] : key_map) {
-		logging::debug("{}: key=[{}]", __func__, key);
+			catch (const irods::exception& e) {
+				beast::http::response<beast::http::empty_body> response;
+				logging::debug("{}: Exception encountered", func);
 
-		// Any keys with a non-empty value means it has already been processed. Skip it to ensure that we are only
-		// dealing with prefixes.
-		if (!value.empty()) {
-			logging::debug("{}: skipping key [{}] because it was already processed.", __func__, key);
-			continue;
+				switch (e.code()) {
+					case USER_ACCESS_DENIED:
+					case CAT_NO_ACCESS_PERMISSION:
+						logging::debug("{}: No access to delete key [{}]", func, key);
+						key_map[key] = "AccessDenied";
+						break;
+					default:
+						logging::debug("{}: Unknown exception when deleting key [{}]", func, key);
+						key_map[key] = "InternalError";
+						break;
+				}
+			}
 		}
 
-		try {
-			if (!fs::client::exists(conn, key)) {
-				logging::debug("{}: Could not find [{}]", __func__, key);
-				key_map[key] = "NoSuchKey";
+		logging::debug("{}: Deleting empty collections now.", func);
+		for (const auto& [key, value] : key_map) {
+			logging::debug("{}: key=[{}]", func, key);
+
+			// Any keys with a non-empty value means it has already been processed. Skip it to ensure that we are only
+			// dealing with prefixes.
+			if (!value.empty()) {
+				logging::debug("{}: skipping key [{}] because it was already processed.", func, key);
 				continue;
 			}
 
-			// Remove trailing slash - it confuses remove_all. Use remove_all here because some S3 clients only include
-			// the base prefix in the request instead of all common prefixes.
-			const auto key_without_trailing_slash = key.substr(0, key.size() - 1);
-			if (fs::client::remove_all(conn, key_without_trailing_slash, fs::remove_options::no_trash) >= 0) {
-				logging::debug("{}: Remove [{}] (collection) successful", __func__, key);
-				key_map[key] = "Success";
-			}
-			else {
-				logging::debug("{}: Deletion of key [{}] (collection) failed", __func__, key);
-				key_map[key] = "InternalError";
-			}
-		}
-		catch (const irods::exception& e) {
-			beast::http::response<beast::http::empty_body> response;
-			logging::debug("{}: Exception encountered", __func__);
+			try {
+				if (!fs::client::exists(conn, key)) {
+					logging::debug("{}: Could not find [{}]", func, key);
+					key_map[key] = "NoSuchKey";
+					continue;
+				}
 
-			switch (e.code()) {
-				case USER_ACCESS_DENIED:
-				case CAT_NO_ACCESS_PERMISSION:
-					logging::debug("{}: No access to delete key [{}]", __func__, key);
-					key_map[key] = "AccessDenied";
-					break;
-				default:
-					logging::debug("{}: Unknown exception when deleting key [{}]", __func__, key);
+				// Remove trailing slash - it confuses remove_all. Use remove_all here because some S3 clients only include
+				// the base prefix in the request instead of all common prefixes.
+				const auto key_without_trailing_slash = key.substr(0, key.size() - 1);
+				if (fs::client::remove_all(conn, key_without_trailing_slash, fs::remove_options::no_trash) >= 0) {
+					logging::debug("{}: Remove [{}] (collection) successful", func, key);
+					irods::http::globals::collection_cache().erase(irods::s3::get_zone(), key_without_trailing_slash);
+					key_map[key] = "Success";
+				}
+				else {
+					logging::debug("{}: Deletion of key [{}] (collection) failed", func, key);
 					key_map[key] = "InternalError";
-					break;
+				}
+			}
+			catch (const irods::exception& e) {
+				beast::http::response<beast::http::empty_body> response;
+				logging::debug("{}: Exception encountered", func);
+
+				switch (e.code()) {
+					case USER_ACCESS_DENIED:
+					case CAT_NO_ACCESS_PERMISSION:
+						logging::debug("{}: No access to delete key [{}]", func, key);
+						key_map[key] = "AccessDenied";
+						break;
+					default:
+						logging::debug("{}: Unknown exception when deleting key [{}]", func, key);
+						key_map[key] = "InternalError";
+						break;
+				}
 			}
 		}
-	}
+	});
 
 	// Now send the response
 	// Example response:
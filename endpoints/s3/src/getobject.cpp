@@ -6,6 +6,7 @@
 #include "irods/private/s3_api/log.hpp"
 #include "irods/private/s3_api/common.hpp"
 #include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/offload.hpp"
 #include "irods/private/s3_api/configuration.hpp"
 #include "irods/private/s3_api/globals.hpp"
 
@@ -33,17 +34,19 @@
 #include <irods/irods_query.hpp>
 #include <irods/query_builder.hpp>
 #include <irods/rodsErrorTable.h>
-
-#ifdef IRODS_DEV_PACKAGE_IS_AT_LEAST_IRODS_5
-#  include <irods/authenticate.h>
-#  include <irods/irods_auth_constants.hpp> // For AUTH_PASSWORD_KEY.
-#endif // IRODS_DEV_PACKAGE_IS_AT_LEAST_IRODS_5
+#include <irods/irods_at_scope_exit.hpp>
 
 #include <boost/stacktrace.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/experimental/channel.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <algorithm>
+#include <exception>
 #include <ios>
+#include <memory>
+#include <vector>
 
 namespace asio = boost::asio;
 namespace beast = boost::beast;
@@ -74,25 +77,264 @@ namespace
 		irods_default_transport xtrans;
 		irods::experimental::io::idstream d;
 	};
-} //namespace
 
-void read_from_irods_send_to_client(
-	irods::http::session_pointer_type session_ptr,
-	std::shared_ptr<persistent_data> vars,
-	std::size_t range_start,
-	std::size_t range_end,
-	std::size_t offset,
-	uint64_t write_buffer_size,
-	const std::string func);
+	// An additional connection and input stream used to read the data object in parallel
+	// with the stream held by persistent_data.
+	struct read_lane
+	{
+		read_lane(std::shared_ptr<irods::experimental::client_connection> conn, const fs::path& path)
+			: conn_ptr{std::move(conn)}
+			, xtrans{*conn_ptr}
+			, d{xtrans, path, irods::experimental::io::root_resource_name{irods::s3::get_resource()}, std::ios_base::in}
+		{
+		}
+
+		std::shared_ptr<irods::experimental::client_connection> conn_ptr;
+		irods_default_transport xtrans;
+		irods::experimental::io::idstream d;
+	};
+
+	// Carries a filled buffer from a reader to the writer. The values are the index of the
+	// buffer and the number of bytes in it.
+	using filled_buffer_channel =
+		asio::experimental::channel<void(boost::system::error_code, std::size_t, std::size_t)>;
+
+	// Returns an empty buffer from the writer to a reader. The value is the index of the buffer.
+	using free_buffer_channel = asio::experimental::channel<void(boost::system::error_code, std::size_t)>;
+
+	// Signals that a reader has finished.
+	using reader_done_channel = asio::experimental::channel<void(boost::system::error_code)>;
+
+	// The stream, buffers, and channels of a single reader.
+	//
+	// Each reader owns its buffers. If the readers shared them, the readers which are ahead of
+	// the writer could take every buffer and starve the reader the writer is waiting on.
+	struct reader_state
+	{
+		reader_state(
+			const asio::any_io_executor& _executor,
+			irods::experimental::io::idstream& _d,
+			std::size_t _depth,
+			std::size_t _buffer_size)
+			: d{_d}
+			, free_buffers{_executor, _depth}
+			, filled_buffers{_executor, _depth}
+		{
+			auto& pool = irods::http::globals::buffer_pool();
+
+			buffers.reserve(_depth);
+			for (std::size_t i = 0; i < _depth; ++i) {
+				buffers.push_back(pool.acquire(_buffer_size));
+				free_buffers.try_send(boost::system::error_code{}, i);
+			}
+		}
+
+		auto close() -> void
+		{
+			free_buffers.close();
+			filled_buffers.close();
+		}
+
+		irods::experimental::io::idstream& d;
+		std::vector<irods::http::buffer_pool::buffer> buffers;
+		free_buffer_channel free_buffers;
+		filled_buffer_channel filled_buffers;
+	};
+
+	// Reads every _stride'th block of the range [_range_start, _range_end], beginning with
+	// block _first_block, into the buffers of _reader. Blocks are _block_size bytes long, except
+	// for the last one. Each seek and read runs on the background thread pool.
+	auto read_blocks(
+		reader_state& _reader,
+		std::size_t _first_block,
+		std::size_t _stride,
+		std::size_t _range_start,
+		std::size_t _range_end,
+		std::size_t _block_size) -> asio::awaitable<void>
+	{
+		boost::system::error_code ec;
+
+		// The position of the stream. Streams are opened at the beginning of the data object.
+		std::size_t position = 0;
+
+		for (auto offset = _range_start + _first_block * _block_size; offset <= _range_end;
+		     offset += _stride * _block_size)
+		{
+			const auto index =
+				co_await _reader.free_buffers.async_receive(asio::redirect_error(asio::use_awaitable, ec));
+			if (ec) {
+				// The writer has stopped.
+				co_return;
+			}
+
+			auto& buffer = _reader.buffers[index];
+
+			// Ranges are inclusive which is why the +1 exists.
+			const auto read_length = std::min<std::size_t>(_block_size, _range_end + 1 - offset);
+
+			const auto bytes_read = co_await irods::http::offload([&] {
+				// Consecutive blocks of a single reader are only contiguous when there is one reader.
+				if (offset != position) {
+					_reader.d.seekg(static_cast<std::streamoff>(offset));
+				}
+
+				_reader.d.read(buffer.data(), static_cast<std::streamsize>(read_length));
+				return _reader.d ? static_cast<std::size_t>(_reader.d.gcount()) : std::size_t{0};
+			});
+
+			// A short read would shift every block after it, so anything less than a full
+			// block is an error.
+			if (bytes_read != read_length) {
+				logging::error("{}: Failed to read {} bytes at offset {} from iRODS.", __func__, read_length, offset);
+				co_await _reader.filled_buffers.async_send(
+					boost::system::errc::make_error_code(boost::system::errc::io_error),
+					index,
+					0,
+					asio::redirect_error(asio::use_awaitable, ec));
+				co_return;
+			}
+
+			position = offset + bytes_read;
+
+			co_await _reader.filled_buffers.async_send(
+				boost::system::error_code{}, index, bytes_read, asio::redirect_error(asio::use_awaitable, ec));
+			if (ec) {
+				co_return;
+			}
+		}
+
+		// Signal the end of the blocks of this reader. A writer expecting more blocks from it
+		// sees the end of the stream instead of waiting forever. The send fails once the writer
+		// has stopped.
+		co_await _reader.filled_buffers.async_send(
+			asio::error::eof, 0, 0, asio::redirect_error(asio::use_awaitable, ec));
+	} // read_blocks
+
+	// Sends the blocks received from _readers to the client, in order, until _content_length
+	// bytes have been sent. Block N is received from reader N % _readers.size(), which is the
+	// reader that read it. Returns the number of bytes sent.
+	auto write_blocks(
+		irods::http::session_pointer_type _session_ptr,
+		persistent_data& _data,
+		std::vector<std::unique_ptr<reader_state>>& _readers,
+		std::size_t _content_length,
+		beast::error_code& _ec) -> asio::awaitable<std::size_t>
+	{
+		auto& body = _data.response.body();
+		std::size_t bytes_sent = 0;
+
+		for (std::size_t block = 0; bytes_sent < _content_length; ++block) {
+			auto& reader = *_readers[block % _readers.size()];
+
+			const auto [index, size] =
+				co_await reader.filled_buffers.async_receive(asio::redirect_error(asio::use_awaitable, _ec));
+			if (_ec) {
+				break;
+			}
+
+			body.data = reader.buffers[index].data();
+			body.size = size;
+			body.more = true;
+
+			_session_ptr->refresh_timeout();
+			co_await beast::http::async_write(
+				_session_ptr->stream(), _data.serializer, asio::redirect_error(asio::use_awaitable, _ec));
+			if (_ec == beast::http::error::need_buffer) {
+				_ec = {};
+			}
+			else if (_ec) {
+				break;
+			}
+
+			bytes_sent += size;
+			logging::trace("{}: Wrote {} bytes total.", __func__, bytes_sent);
+
+			// Hand the buffer back to its reader. The channel has room for every buffer, so this
+			// never fails while the channel is open.
+			reader.free_buffers.try_send(boost::system::error_code{}, index);
+		}
+
+		// Wake the readers if the transfer stopped early.
+		for (auto& reader : _readers) {
+			reader->close();
+		}
+
+		co_return bytes_sent;
+	} // write_blocks
+
+	// Sends the bytes in [_range_start, _range_end] of the data object to the client.
+	//
+	// The range is split into blocks of _buffer_size bytes which are distributed round-robin
+	// across _streams, each of which must be open on the data object. Every stream has its own
+	// reader which fills up to _depth buffers from iRODS while the writer sends the blocks
+	// filled before them, so reads from iRODS overlap with each other and with writes to the
+	// socket. Returns the number of bytes sent. On failure, _ec is set.
+	auto send_range(
+		irods::http::session_pointer_type _session_ptr,
+		persistent_data& _data,
+		const std::vector<irods::experimental::io::idstream*>& _streams,
+		std::size_t _range_start,
+		std::size_t _range_end,
+		std::size_t _buffer_size,
+		std::size_t _depth,
+		beast::error_code& _ec) -> asio::awaitable<std::size_t>
+	{
+		auto executor = co_await asio::this_coro::executor;
+
+		std::vector<std::unique_ptr<reader_state>> readers;
+		readers.reserve(_streams.size());
+		for (auto* d : _streams) {
+			readers.push_back(std::make_unique<reader_state>(executor, *d, _depth, _buffer_size));
+		}
+
+		reader_done_channel readers_done{executor, readers.size()};
+
+		for (std::size_t i = 0; i < readers.size(); ++i) {
+			asio::co_spawn(
+				executor,
+				read_blocks(*readers[i], i, readers.size(), _range_start, _range_end, _buffer_size),
+				[&reader = *readers[i], &readers_done](std::exception_ptr _eptr) {
+					if (_eptr) {
+						try {
+							std::rethrow_exception(_eptr);
+						}
+						catch (const std::exception& e) {
+							logging::error("read_blocks: Exception {}", e.what());
+						}
+						catch (...) {
+							logging::error("read_blocks: Unknown exception encountered");
+						}
+
+						// Wake the writer if it is waiting on this reader.
+						reader.close();
+					}
+
+					readers_done.try_send(boost::system::error_code{});
+				});
+		}
+
+		// Ranges are inclusive which is why the +1 exists.
+		const auto content_length = _range_end - _range_start + 1;
+		const auto bytes_sent = co_await write_blocks(_session_ptr, _data, readers, content_length, _ec);
+
+		// The readers refer to the buffers and streams, so wait for all of them to finish.
+		boost::system::error_code ignored;
+		for (std::size_t i = 0; i < readers.size(); ++i) {
+			co_await readers_done.async_receive(asio::redirect_error(asio::use_awaitable, ignored));
+		}
+
+		co_return bytes_sent;
+	} // send_range
+} //namespace
 
 const static std::string_view date_format{"{:%a, %d %b %Y %H:%M:%S GMT}"};
 
-void irods::s3::actions::handle_getobject(
+asio::awaitable<void> irods::s3::actions::handle_getobject(
 	irods::http::session_pointer_type session_ptr,
-	beast::http::request_parser<boost::beast::http::empty_body>& parser,
-	const boost::urls::url_view& url)
+	irods::http::request_context_pointer request_ctx)
 {
-	using json_pointer = nlohmann::json::json_pointer;
+	auto& parser = request_ctx->parser();
+	const auto& url = request_ctx->url();
 
 	beast::http::response<beast::http::empty_body> response;
 
@@ -104,20 +346,21 @@ void irods::s3::actions::handle_getobject(
 		response.result(beast::http::status::not_implemented);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
-	auto irods_username = irods::s3::authentication::authenticates(parser, url);
+	auto irods_username =
+		co_await irods::http::offload([&] { return irods::s3::authentication::authenticates(parser, url); });
 	if (!irods_username) {
 		logging::error("{}: Failed to authenticate.", __func__);
 		response.result(beast::http::status::forbidden);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
 	fs::path path;
-	if (auto bucket = irods::s3::resolve_bucket(url.segments()); bucket.has_value()) {
+	if (const auto& bucket = request_ctx->bucket(); bucket.has_value()) {
 		path = bucket.value();
 		path = irods::s3::finish_path(path, url.segments());
 	}
@@ -126,46 +369,70 @@ void irods::s3::actions::handle_getobject(
 		response.result(beast::http::status::not_found);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
-	const auto& config = irods::http::globals::configuration();
-	const auto& irods_client_config = config.at("irods_client");
-	const auto& zone = irods_client_config.at("zone").get_ref<const std::string&>();
-
-	const auto& rodsadmin_username =
-		irods_client_config.at(json_pointer{"/proxy_admin_account/username"}).get_ref<const std::string&>();
-	auto rodsadmin_password =
-		irods_client_config.at(json_pointer{"/proxy_admin_account/password"}).get_ref<const std::string&>();
-
-	auto conn = std::make_shared<irods::experimental::client_connection>(
-		irods::experimental::defer_authentication,
-		irods_client_config.at("host").get_ref<const std::string&>(),
-		irods_client_config.at("port").get<int>(),
-		irods::experimental::fully_qualified_username{rodsadmin_username, zone},
-		irods::experimental::fully_qualified_username{*irods_username, zone});
-
-	auto* conn_ptr = static_cast<RcComm*>(*conn);
-
-#ifdef IRODS_DEV_PACKAGE_IS_AT_LEAST_IRODS_5
-	const auto json_input = nlohmann::json{{"scheme", "native"}, {irods::AUTH_PASSWORD_KEY, rodsadmin_password}};
-	if (const auto ec = rc_authenticate_client(conn_ptr, json_input.dump().c_str()); ec < 0)
-#else
-	if (const auto ec = clientLoginWithPassword(conn_ptr, rodsadmin_password.data()); ec < 0)
-#endif // IRODS_DEV_PACKAGE_IS_AT_LEAST_IRODS_5
-	{
-		logging::error("{}: iRODS authentication error: {}", __func__, ec);
+	// Getting a connection may require connecting to and authenticating with the iRODS server,
+	// which are blocking operations. The connection is returned to the streaming connection pool
+	// once the transfer completes.
+	auto& conn_pool = irods::http::globals::streaming_connection_pool();
+	std::shared_ptr<irods::experimental::client_connection> conn;
+	try {
+		conn = co_await irods::http::offload([&] { return conn_pool.get_connection(*irods_username); });
+	}
+	catch (const std::exception& e) {
+		logging::error("{}: Could not get iRODS connection: {}", __func__, e.what());
 		response.result(beast::http::status::internal_server_error);
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
-	std::shared_ptr<persistent_data> persistent_data_ptr = std::make_shared<persistent_data>(conn, path);
+	std::shared_ptr<persistent_data> persistent_data_ptr;
+
+	// Large objects are read through several streams, each on its own connection, so that
+	// multiple reads from iRODS are in flight at once.
+	std::vector<std::unique_ptr<read_lane>> read_lanes;
+
+	// Closing the data object and disconnecting from iRODS are blocking operations. They must not
+	// run on the strand of the session, whichever way this handler returns.
+	irods::at_scope_exit release_streams{[&] {
+		auto lanes = std::make_shared<std::vector<std::unique_ptr<read_lane>>>(std::move(read_lanes));
+		irods::http::globals::background_task(
+			[lanes, data = std::move(persistent_data_ptr), c = std::move(conn)]() mutable {
+				using irods::http::streaming_connection_pool;
+
+				// A connection whose stream does not close cleanly has its open replicas closed
+				// by the pool.
+				for (auto& lane : *lanes) {
+					lane->d.close();
+					if (!lane->d.fail()) {
+						streaming_connection_pool::mark_streams_closed(lane->conn_ptr);
+					}
+				}
+				lanes->clear();
+
+				if (data) {
+					data->d.close();
+					if (!data->d.fail()) {
+						streaming_connection_pool::mark_streams_closed(data->conn_ptr);
+					}
+				}
+				else if (c) {
+					// No stream was opened.
+					streaming_connection_pool::mark_streams_closed(c);
+				}
+
+				data.reset();
+				c.reset();
+			});
+	}};
 
 	// read the range header if it exists
 	// Note:  We are only implementing range headers in the format range: bytes=<start>-[end]
 	std::size_t range_start = 0;
 	std::size_t range_end = 0;
+	bool range_requested = false;
+	bool range_end_requested = false;
 	auto range_header = parser.get().find("range");
 	if (range_header != parser.get().end()) {
 		if (range_header->value().starts_with("bytes=")) {
@@ -179,21 +446,23 @@ void irods::s3::actions::handle_getobject(
 				response.result(beast::http::status::not_implemented);
 				logging::debug("{}: returned [{}]", __func__, response.reason());
 				session_ptr->send(std::move(response));
-				return;
+				co_return;
 			}
 
 			try {
 				range_start = boost::lexical_cast<std::size_t>(range_parts[0]);
 				if (!range_parts[1].empty()) {
 					range_end = boost::lexical_cast<std::size_t>(range_parts[1]);
+					range_end_requested = true;
 				}
+				range_requested = true;
 			}
 			catch (const boost::bad_lexical_cast&) {
 				logging::error("{}: Could not cast the start or end range to a size_t.", __func__);
 				response.result(beast::http::status::not_implemented);
 				logging::debug("{}: returned [{}]", __func__, response.reason());
 				session_ptr->send(std::move(response));
-				return;
+				co_return;
 			}
 		}
 		else {
@@ -202,74 +471,79 @@ void irods::s3::actions::handle_getobject(
 			response.result(beast::http::status::not_implemented);
 			logging::debug("{}: returned [{}]", __func__, response.reason());
 			session_ptr->send(std::move(response));
-			return;
+			co_return;
 		}
 	}
 
+	if (range_end_requested && range_end < range_start) {
+		logging::error("{}: The range [{}-{}] ends before it starts.", __func__, range_start, range_end);
+		irods::s3::api::common_routines::send_error_response(
+			session_ptr,
+			beast::http::status::range_not_satisfiable,
+			"InvalidRange",
+			"The requested range is not satisfiable",
+			url.path(),
+			__func__);
+		co_return;
+	}
+
+	uint64_t write_buffer_size = irods::s3::get_get_object_buffer_size_in_bytes();
+	bool object_exists = false;
+	bool range_satisfiable = true;
+
+	// The number of bytes sent to the client. Zero for an empty object.
+	std::uint64_t content_length = 0;
+
 	try {
-		if (fs::client::exists(*(persistent_data_ptr->conn_ptr), path)) {
-			uint64_t write_buffer_size = irods::s3::get_get_object_buffer_size_in_bytes();
+		// Gather the information needed for the response header and open the data object. These
+		// are blocking operations.
+		object_exists = co_await irods::http::offload([&, func = __func__] {
+			if (!fs::client::exists(*conn, path)) {
+				return false;
+			}
 
-			auto file_size =
-				irods::experimental::filesystem::client::data_object_size(*(persistent_data_ptr->conn_ptr), path);
-			if (range_end == 0 || range_end > file_size - 1) {
+			const auto file_size = irods::experimental::filesystem::client::data_object_size(*conn, path);
+
+			// A range must start within the object. Its end is clamped to the end of the object.
+			// An empty object has no satisfiable range, but can be read in full.
+			if (range_requested) {
+				if (range_start >= file_size) {
+					range_satisfiable = false;
+					return true;
+				}
+
+				if (!range_end_requested || range_end >= file_size) {
+					range_end = file_size - 1;
+				}
+
+				content_length = range_end - range_start + 1; // ranges are inclusive
+			}
+			else if (file_size > 0) {
 				range_end = file_size - 1;
+				content_length = file_size;
 			}
-			auto content_length = range_end - range_start + 1; // ranges are inclusive
+
+			persistent_data_ptr = std::make_shared<persistent_data>(conn, path);
 
 			// Set the Content-Length header
 			std::string length_field = std::to_string(content_length);
 			persistent_data_ptr->response.insert(beast::http::field::content_length, length_field);
 
 			// Get the file MD5 and set the Content-MD5 header
-			auto md5 =
-				irods::experimental::filesystem::client::data_object_checksum(*(persistent_data_ptr->conn_ptr), path);
+			auto md5 = irods::experimental::filesystem::client::data_object_checksum(*conn, path);
 			persistent_data_ptr->response.insert("Content-MD5", md5);
 
 			// Get the last write time and set the Last-Mofified header
-			auto last_write_time__time_point =
-				irods::experimental::filesystem::client::last_write_time(*(persistent_data_ptr->conn_ptr), path);
+			auto last_write_time__time_point = irods::experimental::filesystem::client::last_write_time(*conn, path);
 			std::time_t last_write_time__time_t = std::chrono::system_clock::to_time_t(last_write_time__time_point);
 			std::string last_write_time__str =
 				irods::s3::api::common_routines::convert_time_t_to_str(last_write_time__time_t, date_format);
 			persistent_data_ptr->response.insert(beast::http::field::last_modified, last_write_time__str);
 
-			// seek to the start range
-			persistent_data_ptr->d.seekg(range_start);
-			size_t offset = range_start;
-
-			if (persistent_data_ptr->d.fail() || persistent_data_ptr->d.bad()) {
-				logging::error("{}: Fail/badbit set", __func__);
-				persistent_data_ptr->response.result(beast::http::status::forbidden);
-				persistent_data_ptr->response.body().more = false;
-				logging::debug("{}: returned [{}]", __func__, persistent_data_ptr->response.reason());
-				session_ptr->send(std::move(persistent_data_ptr->response));
-				return;
-			}
-			beast::error_code ec;
-			beast::http::write_header(session_ptr->stream().socket(), persistent_data_ptr->serializer, ec);
-			if (ec) {
-				persistent_data_ptr->response.result(beast::http::status::internal_server_error);
-				logging::debug("{}: returned [{}]", __func__, persistent_data_ptr->response.reason());
-				session_ptr->send(std::move(persistent_data_ptr->response));
-				return;
-			}
-
-			// set the response to ok
-			persistent_data_ptr->response.result(beast::http::status::ok);
+			logging::trace("{}: Opened [{}] for reading.", func, path.c_str());
 
-			read_from_irods_send_to_client(
-				session_ptr, persistent_data_ptr, range_start, range_end, offset, write_buffer_size, __func__);
-		}
-		else {
-			return irods::s3::api::common_routines::send_error_response(
-				session_ptr,
-				boost::beast::http::status::not_found,
-				"NoSuchKey",
-				"Object does not exist",
-				url.path(),
-				__func__);
-		}
+			return true;
+		});
 	}
 	catch (irods::exception& e) {
 		logging::error("{}: Exception {}", __func__, e.what());
@@ -286,82 +560,129 @@ void irods::s3::actions::handle_getobject(
 
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
+		co_return;
 	}
 	catch (std::exception& e) {
 		logging::error("{}: Exception {}", __func__, e.what());
 		response.result(beast::http::status::internal_server_error);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
+		co_return;
 	}
 	catch (...) {
 		logging::error("{}: Unknown exception encountered", __func__);
 		response.result(beast::http::status::internal_server_error);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
+		co_return;
 	}
 
-	// all paths should have a return here
-}
+	if (!object_exists) {
+		irods::s3::api::common_routines::send_error_response(
+			session_ptr, boost::beast::http::status::not_found, "NoSuchKey", "Object does not exist", url.path(), __func__);
+		co_return;
+	}
 
-void read_from_irods_send_to_client(
-	irods::http::session_pointer_type session_ptr,
-	std::shared_ptr<persistent_data> persistent_data_ptr,
-	std::size_t range_start,
-	std::size_t range_end,
-	std::size_t offset,
-	uint64_t write_buffer_size,
-	const std::string func)
-{
-	irods::http::globals::background_task(
-		[session_ptr, persistent_data_ptr, range_start, range_end, offset, write_buffer_size, func]() mutable {
-			std::vector<char> buf_vector(write_buffer_size);
-
-			std::streampos current, size;
-
-			// Determine the length we need to read which is the smaller
-		    // of the write_buffer_size or the bytes to the end of the range.
-		    // Note that ranges are inclusive which is why the +1's exist.
-			std::size_t read_length =
-				write_buffer_size < range_end + 1 - offset ? write_buffer_size : range_end + 1 - offset;
-
-			// read from iRODS
-			persistent_data_ptr->d.read(buf_vector.data(), read_length);
-			current = persistent_data_ptr->d.gcount();
-			offset += current;
-			size += current;
-			persistent_data_ptr->response.body().data = buf_vector.data();
-			persistent_data_ptr->response.body().size = current;
-			if (persistent_data_ptr->d.bad()) {
-				// An error occurred on reading from iRODS. We have already sent
-			    // the response in the header. All we can do is bail.
-				logging::error("{}: Badbit set on read from iRODS. Bailing...", func);
-				return;
-			}
+	if (!range_satisfiable) {
+		logging::error("{}: The range starting at [{}] is not within the object.", __func__, range_start);
+		irods::s3::api::common_routines::send_error_response(
+			session_ptr,
+			beast::http::status::range_not_satisfiable,
+			"InvalidRange",
+			"The requested range is not satisfiable",
+			url.path(),
+			__func__);
+		co_return;
+	}
+
+	if (persistent_data_ptr->d.fail() || persistent_data_ptr->d.bad()) {
+		logging::error("{}: Fail/badbit set", __func__);
+		persistent_data_ptr->response.result(beast::http::status::forbidden);
+		persistent_data_ptr->response.body().more = false;
+		logging::debug("{}: returned [{}]", __func__, persistent_data_ptr->response.reason());
+		session_ptr->send(std::move(persistent_data_ptr->response));
+		co_return;
+	}
 
-			// write to socket
-			boost::beast::error_code ec;
-			beast::http::write(session_ptr->stream().socket(), persistent_data_ptr->serializer, ec);
-			if (ec == beast::http::error::need_buffer) {
-				ec = {};
+	// Failing to open an additional stream is not an error. The object is read using the streams
+	// which were opened.
+	std::vector<irods::experimental::io::idstream*> streams{&persistent_data_ptr->d};
+
+	const auto block_count = (content_length + write_buffer_size - 1) / write_buffer_size;
+	const auto stream_count =
+		std::min<std::uint64_t>(irods::s3::get_get_object_parallel_read_streams(), block_count);
+
+	if (stream_count > 1 && content_length >= irods::s3::get_get_object_parallel_read_threshold_in_bytes()) {
+		co_await irods::http::offload([&, func = __func__] {
+			try {
+				while (streams.size() < stream_count) {
+					auto lane = std::make_unique<read_lane>(conn_pool.get_connection(*irods_username), path);
+					if (!lane->d) {
+						logging::warn("{}: Could not open additional stream for [{}].", func, path.c_str());
+						break;
+					}
+
+					streams.push_back(&lane->d);
+					read_lanes.push_back(std::move(lane));
+				}
 			}
-			else if (ec) {
-				// An error occurred writing the body data. We have already sent
-			    // the response in the header. All we can do is bail.
-				logging::error("{}: Error {} occurred while sending socket data. Bailing...", func, ec.message());
-				return;
+			catch (const std::exception& e) {
+				logging::warn("{}: Could not open additional stream for [{}]: {}", func, path.c_str(), e.what());
 			}
+		});
 
-			logging::trace("{}: Wrote {} bytes total.  offset={}", func, static_cast<std::streamoff>(size), offset);
+		logging::trace("{}: Reading [{}] using {} streams.", __func__, path.c_str(), streams.size());
+	}
 
-			// If we have now read beyond the range_end then we are done. Return.
-			if (offset > range_end) {
-				persistent_data_ptr->response.body().more = false;
-				logging::debug(
-					"{} returned [{}] error={}", __func__, persistent_data_ptr->response.reason(), ec.message());
-				return;
-			}
+	auto& stream = session_ptr->stream();
+	auto& serializer = persistent_data_ptr->serializer;
+	auto& body = persistent_data_ptr->response.body();
+	beast::error_code ec;
+
+	session_ptr->mark_response_started();
+	session_ptr->refresh_timeout();
+	co_await beast::http::async_write_header(stream, serializer, asio::redirect_error(asio::use_awaitable, ec));
+	if (ec) {
+		persistent_data_ptr->response.result(beast::http::status::internal_server_error);
+		logging::debug("{}: returned [{}]", __func__, persistent_data_ptr->response.reason());
+		session_ptr->send(std::move(persistent_data_ptr->response));
+		co_return;
+	}
 
-			read_from_irods_send_to_client(
-				session_ptr, persistent_data_ptr, range_start, range_end, offset, write_buffer_size, func);
-		});
-}
+	// Stream the requested range to the client. Reads from iRODS run on the background thread
+	// pool. Writes to the socket run on the session's strand, so a slow client does not occupy
+	// a background thread. An empty object has no range to send.
+	std::size_t size = 0;
+	if (content_length > 0) {
+		size = co_await send_range(
+			session_ptr,
+			*persistent_data_ptr,
+			streams,
+			range_start,
+			range_end,
+			write_buffer_size,
+			irods::s3::get_get_object_pipeline_depth(),
+			ec);
+	}
+
+	if (ec) {
+		// An error occurred reading from iRODS or writing to the socket. We have already
+		// sent the response header. All we can do is bail.
+		logging::error("{}: Error {} occurred while sending the object. Bailing...", __func__, ec.message());
+		session_ptr->do_close();
+		co_return;
+	}
+
+	// Signal the end of the body to the serializer.
+	body.data = nullptr;
+	body.size = 0;
+	body.more = false;
+
+	session_ptr->refresh_timeout();
+	co_await beast::http::async_write(stream, serializer, asio::redirect_error(asio::use_awaitable, ec));
+	logging::debug("{}: returned [{}] error={}", __func__, persistent_data_ptr->response.reason(), ec.message());
+
+	// The response is complete. Let the session read the next request.
+	const auto close = persistent_data_ptr->response.need_eof();
+	session_ptr->on_write(close, ec, size);
+} // handle_getobject
@@ -6,6 +6,7 @@
 #include "irods/private/s3_api/log.hpp"
 #include "irods/private/s3_api/common.hpp"
 #include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/offload.hpp"
 
 #include <irods/irods_exception.hpp>
 
@@ -16,11 +17,13 @@ namespace beast = boost::beast;
 namespace fs = irods::experimental::filesystem;
 namespace logging = irods::http::logging;
 
-void irods::s3::actions::handle_headbucket(
+static void handle_headbucket_impl(
 	irods::http::session_pointer_type session_ptr,
-	boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-	const boost::urls::url_view& url)
+	irods::http::request_context_pointer request_ctx)
 {
+	auto& parser = request_ctx->parser();
+	const auto& url = request_ctx->url();
+
 	beast::http::response<beast::http::empty_body> response;
 	response.result(beast::http::status::forbidden);
 	try {
@@ -35,7 +38,7 @@ void irods::s3::actions::handle_headbucket(
 		auto conn = irods::get_connection(*irods_username);
 
 		fs::path path;
-		if (auto bucket = irods::s3::resolve_bucket(url.segments()); bucket.has_value()) {
+		if (const auto& bucket = request_ctx->bucket(); bucket.has_value()) {
 			logging::debug("{}: bucket = [{}]", __func__, bucket.value().c_str());
 			path = irods::s3::finish_path(bucket.value(), url.segments());
 		}
@@ -79,4 +82,11 @@ void irods::s3::actions::handle_headbucket(
 
 	logging::debug("{}: returned [{}]", __func__, response.reason());
 	session_ptr->send(std::move(response));
-}
+} // handle_headbucket_impl
+
+asio::awaitable<void> irods::s3::actions::handle_headbucket(
+	irods::http::session_pointer_type session_ptr,
+	irods::http::request_context_pointer request_ctx)
+{
+	co_await irods::http::offload([&] { handle_headbucket_impl(session_ptr, request_ctx); });
+} // handle_headbucket
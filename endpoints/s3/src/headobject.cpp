@@ -6,6 +6,7 @@
 #include "irods/private/s3_api/log.hpp"
 #include "irods/private/s3_api/common.hpp"
 #include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/offload.hpp"
 
 #include <irods/irods_exception.hpp>
 
@@ -18,11 +19,13 @@ namespace logging = irods::http::logging;
 
 const static std::string_view date_format{"{:%a, %d %b %Y %H:%M:%S GMT}"};
 
-void irods::s3::actions::handle_headobject(
+static void handle_headobject_impl(
 	irods::http::session_pointer_type session_ptr,
-	boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-	const boost::urls::url_view& url)
+	irods::http::request_context_pointer request_ctx)
 {
+	auto& parser = request_ctx->parser();
+	const auto& url = request_ctx->url();
+
 	beast::http::response<beast::http::empty_body> response;
 	response.result(beast::http::status::forbidden);
 
@@ -39,7 +42,7 @@ void irods::s3::actions::handle_headobject(
 		auto conn = irods::get_connection(*irods_username);
 
 		fs::path path;
-		if (auto bucket = irods::s3::resolve_bucket(url.segments()); bucket.has_value()) {
+		if (const auto& bucket = request_ctx->bucket(); bucket.has_value()) {
 			path = bucket.value();
 			path = irods::s3::finish_path(path, url.segments());
 		}
@@ -114,4 +117,11 @@ void irods::s3::actions::handle_headobject(
 	logging::debug("{}: returned [{}]", __func__, response.reason());
 	session_ptr->send(std::move(response));
 	return;
-}
+} // handle_headobject_impl
+
+asio::awaitable<void> irods::s3::actions::handle_headobject(
+	irods::http::session_pointer_type session_ptr,
+	irods::http::request_context_pointer request_ctx)
+{
+	co_await irods::http::offload([&] { handle_headobject_impl(session_ptr, request_ctx); });
+} // handle_headobject
@@ -7,6 +7,7 @@
 #include "irods/private/s3_api/log.hpp"
 #include "irods/private/s3_api/s3_api.hpp"
 #include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/offload.hpp"
 #include "irods/s3_api/plugins/bucket_mapping/bucket_mapping.h"
 
 #include <boost/asio/awaitable.hpp>
@@ -36,11 +37,13 @@ namespace logging = irods::http::logging;
 
 static const std::string date_format{"{:%Y-%m-%dT%H:%M:%S+00:00}"};
 
-void irods::s3::actions::handle_listbuckets(
+static void handle_listbuckets_impl(
 	irods::http::session_pointer_type session_ptr,
-	boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-	const boost::urls::url_view& url)
+	irods::http::request_context_pointer request_ctx)
 {
+	auto& parser = request_ctx->parser();
+	const auto& url = request_ctx->url();
+
 	using namespace boost::property_tree;
 
 	beast::http::response<beast::http::empty_body> response;
@@ -128,4 +131,11 @@ void irods::s3::actions::handle_listbuckets(
 	logging::debug("{}: returned [{}]", __func__, string_body_response.reason());
 	session_ptr->send(std::move(string_body_response));
 	return;
-}
+} // handle_listbuckets_impl
+
+asio::awaitable<void> irods::s3::actions::handle_listbuckets(
+	irods::http::session_pointer_type session_ptr,
+	irods::http::request_context_pointer request_ctx)
+{
+	co_await irods::http::offload([&] { handle_listbuckets_impl(session_ptr, request_ctx); });
+} // handle_listbuckets
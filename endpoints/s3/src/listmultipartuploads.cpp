@@ -0,0 +1,189 @@
+#include "irods/private/s3_api/s3_api.hpp"
+#include "irods/private/s3_api/authentication.hpp"
+#include "irods/private/s3_api/common_routines.hpp"
+#include "irods/private/s3_api/log.hpp"
+#include "irods/private/s3_api/common.hpp"
+#include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/offload.hpp"
+#include "irods/private/s3_api/globals.hpp"
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <boost/url.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+namespace asio = boost::asio;
+namespace beast = boost::beast;
+namespace logging = irods::http::logging;
+
+const static std::string_view date_format{"{:%Y-%m-%dT%H:%M:%S.000Z}"};
+
+namespace
+{
+	// ListMultipartUploads returns at most this many uploads and common prefixes per page.
+	constexpr std::size_t max_uploads_per_page = 1000;
+
+	auto parse_count(std::string_view _value) -> std::optional<std::size_t>
+	{
+		std::size_t count = 0;
+		const auto [ptr, ec] = std::from_chars(_value.data(), _value.data() + _value.size(), count);
+
+		if (ec != std::errc{} || ptr != _value.data() + _value.size()) {
+			return std::nullopt;
+		}
+
+		return count;
+	} // parse_count
+
+	auto make_user(const std::string& _name) -> boost::property_tree::ptree
+	{
+		boost::property_tree::ptree user;
+		user.put("ID", _name);
+		user.put("DisplayName", _name);
+		return user;
+	} // make_user
+} //namespace
+
+static void handle_listmultipartuploads_impl(
+	irods::http::session_pointer_type session_ptr,
+	irods::http::request_context_pointer request_ctx)
+{
+	auto& parser = request_ctx->parser();
+	const auto& url = request_ctx->url();
+
+	beast::http::response<beast::http::empty_body> response;
+
+	// Authenticate
+	auto irods_username = irods::s3::authentication::authenticates(parser, url);
+	if (!irods_username) {
+		logging::error("{}: Failed to authenticate.", __func__);
+		response.result(beast::http::status::forbidden);
+		logging::debug("{}: returned [{}]", __func__, response.reason());
+		session_ptr->send(std::move(response));
+		return;
+	}
+
+	if (!request_ctx->bucket().has_value() || url.segments().empty()) {
+		logging::error("{}: Failed to resolve bucket", __func__);
+		response.result(beast::http::status::not_found);
+		logging::debug("{}: returned [{}]", __func__, response.reason());
+		session_ptr->send(std::move(response));
+		return;
+	}
+
+	const std::string s3_bucket = *url.segments().begin();
+
+	// Returns the decoded value of a query parameter, or an empty string if it is missing.
+	const auto find_param = [&url](std::string_view _name) -> std::string {
+		if (const auto param = url.params().find(_name); param != url.params().end()) {
+			return (*param).value;
+		}
+		return {};
+	};
+
+	const auto prefix = find_param("prefix");
+	const auto delimiter = find_param("delimiter");
+	const auto key_marker = find_param("key-marker");
+	const auto upload_id_marker = find_param("upload-id-marker");
+	const auto encoding_type = find_param("encoding-type");
+	const auto max_uploads_param = find_param("max-uploads");
+
+	std::size_t max_uploads = max_uploads_per_page;
+	if (!max_uploads_param.empty()) {
+		const auto count = parse_count(max_uploads_param);
+		if (!count) {
+			irods::s3::api::common_routines::send_error_response(
+				session_ptr,
+				beast::http::status::bad_request,
+				"InvalidArgument",
+				fmt::format("Invalid max-uploads [{}]", max_uploads_param),
+				url.path(),
+				__func__);
+			return;
+		}
+
+		max_uploads = std::min(*count, max_uploads_per_page);
+	}
+
+	// Only the page returned is copied out of the index.
+	const auto listing = irods::http::globals::multipart_upload_index().list(
+		{.bucket = s3_bucket,
+	     .prefix = prefix,
+	     .delimiter = delimiter,
+	     .key_marker = key_marker,
+	     .upload_id_marker = upload_id_marker,
+	     .max_uploads = max_uploads});
+
+	const bool url_encode_keys = encoding_type == "url";
+	const auto encode_key = [url_encode_keys](const std::string& _key) -> std::string {
+		return url_encode_keys ? boost::urls::encode(_key, boost::urls::unreserved_chars) : _key;
+	};
+
+	boost::property_tree::ptree document;
+	document.add("ListMultipartUploadsResult", "");
+	document.add("ListMultipartUploadsResult.Bucket", s3_bucket);
+	document.add("ListMultipartUploadsResult.KeyMarker", encode_key(key_marker));
+	document.add("ListMultipartUploadsResult.UploadIdMarker", upload_id_marker);
+	document.add("ListMultipartUploadsResult.NextKeyMarker", encode_key(listing.next_key_marker));
+	document.add("ListMultipartUploadsResult.NextUploadIdMarker", listing.next_upload_id_marker);
+	document.add("ListMultipartUploadsResult.Prefix", encode_key(prefix));
+	if (!delimiter.empty()) {
+		document.add("ListMultipartUploadsResult.Delimiter", encode_key(delimiter));
+	}
+	document.add("ListMultipartUploadsResult.MaxUploads", max_uploads);
+	document.add("ListMultipartUploadsResult.IsTruncated", listing.is_truncated ? "true" : "false");
+	if (!encoding_type.empty()) {
+		document.add("ListMultipartUploadsResult.EncodingType", encoding_type);
+	}
+
+	for (const auto& upload : listing.uploads) {
+		boost::property_tree::ptree object;
+		object.put("Key", encode_key(upload.key));
+		object.put("UploadId", upload.upload_id);
+		object.add_child("Initiator", make_user(upload.owner));
+		object.add_child("Owner", make_user(upload.owner));
+		object.put("StorageClass", "STANDARD");
+		object.put(
+			"Initiated",
+			irods::s3::api::common_routines::convert_time_t_to_str(
+				std::chrono::system_clock::to_time_t(upload.initiated), date_format));
+		document.add_child("ListMultipartUploadsResult.Upload", object);
+	}
+
+	for (const auto& common_prefix : listing.common_prefixes) {
+		boost::property_tree::ptree object;
+		object.put("Prefix", encode_key(common_prefix));
+		document.add_child("ListMultipartUploadsResult.CommonPrefixes", object);
+	}
+
+	beast::http::response<beast::http::string_body> string_body_response(std::move(response));
+	std::stringstream s;
+	boost::property_tree::xml_parser::xml_writer_settings<std::string> settings;
+	settings.indent_char = ' ';
+	settings.indent_count = 4;
+	boost::property_tree::write_xml(s, document, settings);
+	string_body_response.body() = s.str();
+	string_body_response.result(beast::http::status::ok);
+	string_body_response.prepare_payload();
+
+	logging::debug("{}: response body {}", __func__, s.str());
+	logging::debug("{}: returned [{}]", __func__, string_body_response.reason());
+	session_ptr->send(std::move(string_body_response));
+} // handle_listmultipartuploads_impl
+
+asio::awaitable<void> irods::s3::actions::handle_listmultipartuploads(
+	irods::http::session_pointer_type session_ptr,
+	irods::http::request_context_pointer request_ctx)
+{
+	co_await irods::http::offload([&] { handle_listmultipartuploads_impl(session_ptr, request_ctx); });
+} // handle_listmultipartuploads
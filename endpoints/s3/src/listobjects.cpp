@@ -6,6 +6,7 @@
 #include "irods/private/s3_api/log.hpp"
 #include "irods/private/s3_api/common.hpp"
 #include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/offload.hpp"
 
 #include <boost/asio/awaitable.hpp>
 #include <boost/asio/this_coro.hpp>
@@ -63,11 +64,13 @@ namespace
 	} // make_ListBucketResult_object
 } //namespace
 
-void irods::s3::actions::handle_listobjects_v2(
+static void handle_listobjects_v2_impl(
 	irods::http::session_pointer_type session_ptr,
-	boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-	const boost::urls::url_view& url)
+	irods::http::request_context_pointer request_ctx)
 {
+	auto& parser = request_ctx->parser();
+	const auto& url = request_ctx->url();
+
 	using namespace boost::property_tree;
 
 	beast::http::response<beast::http::empty_body> response;
@@ -84,7 +87,7 @@ void irods::s3::actions::handle_listobjects_v2(
 	auto rcComm_t_ptr = static_cast<RcComm*>(conn);
 
 	irods::experimental::filesystem::path bucket_base;
-	if (auto bucket = irods::s3::resolve_bucket(url.segments()); bucket.has_value()) {
+	if (const auto& bucket = request_ctx->bucket(); bucket.has_value()) {
 		logging::debug("{}: bucket = [{}]", __func__, bucket.value().c_str());
 		bucket_base = bucket.value();
 	}
@@ -135,6 +138,10 @@ void irods::s3::actions::handle_listobjects_v2(
 				full_path.parent_path().c_str());
 			logging::debug("{}: query=[{}]", __func__, query);
 			for (auto&& row : irods::query<RcComm>(rcComm_t_ptr, query)) {
+				// The staging collection holds data objects which are not keys of the bucket yet.
+				if (irods::s3::is_in_staging_collection(bucket_base, row[0])) {
+					continue;
+				}
 				ptree object;
 				std::string key = (row[0].size() > base_length ? row[0].substr(base_length) : "");
 				if (key.starts_with("/")) {
@@ -151,6 +158,9 @@ void irods::s3::actions::handle_listobjects_v2(
 				full_path.parent_path().c_str());
 			logging::debug("{}: query=[{}]", __func__, query);
 			for (auto&& row : irods::query<RcComm>(rcComm_t_ptr, query)) {
+				if (irods::s3::is_in_staging_collection(bucket_base, row[0])) {
+					continue;
+				}
 				std::string key = (row[0].size() > base_length ? row[0].substr(base_length) : "") + "/" + row[1];
 				if (key.starts_with("/")) {
 					key = key.substr(1);
@@ -172,6 +182,9 @@ void irods::s3::actions::handle_listobjects_v2(
 				full_path.c_str());
 			logging::debug("{}: query=[{}]", __func__, query);
 			for (auto&& row : irods::query<RcComm>(rcComm_t_ptr, query)) {
+				if (irods::s3::is_in_staging_collection(bucket_base, row[0])) {
+					continue;
+				}
 				ptree object;
 				std::string key = (row[0].size() > base_length ? row[0].substr(base_length) : "");
 				if (key.starts_with("/")) {
@@ -190,6 +203,9 @@ void irods::s3::actions::handle_listobjects_v2(
 				full_path.object_name().c_str());
 			logging::debug("{}: query=[{}]", __func__, query);
 			for (auto&& row : irods::query<RcComm>(rcComm_t_ptr, query)) {
+				if (irods::s3::is_in_staging_collection(bucket_base, row[0])) {
+					continue;
+				}
 				std::string key = (row[0].size() > base_length ? row[0].substr(base_length) : "") + "/" + row[1];
 				if (key.starts_with("/")) {
 					key = key.substr(1);
@@ -217,6 +233,9 @@ void irods::s3::actions::handle_listobjects_v2(
 			full_path.parent_path().c_str());
 		logging::debug("{}: query=[{}]", __func__, query);
 		for (auto&& row : irods::query<RcComm>(rcComm_t_ptr, query)) {
+			if (irods::s3::is_in_staging_collection(bucket_base, row[0])) {
+				continue;
+			}
 			// Skip over the bucket base collection.
 			if (row[0] == bucket_base.c_str()) {
 				logging::debug("{}: Skipping bucket base coll.", __func__);
@@ -238,6 +257,9 @@ void irods::s3::actions::handle_listobjects_v2(
 			full_path.c_str());
 		logging::debug("{}: query=[{}]", __func__, query);
 		for (auto&& row : irods::query<RcComm>(rcComm_t_ptr, query)) {
+			if (irods::s3::is_in_staging_collection(bucket_base, row[0])) {
+				continue;
+			}
 			std::string key = (row[0].size() > base_length ? row[0].substr(base_length) : "") + "/" + row[1];
 			if (key.starts_with("/")) {
 				key = key.substr(1);
@@ -256,6 +278,9 @@ void irods::s3::actions::handle_listobjects_v2(
 			full_path.object_name().c_str());
 		logging::debug("{}: query=[{}]", __func__, query);
 		for (auto&& row : irods::query<RcComm>(rcComm_t_ptr, query)) {
+			if (irods::s3::is_in_staging_collection(bucket_base, row[0])) {
+				continue;
+			}
 			std::string key = (row[0].size() > base_length ? row[0].substr(base_length) : "") + "/" + row[1];
 			if (key.starts_with("/")) {
 				key = key.substr(1);
@@ -278,4 +303,11 @@ void irods::s3::actions::handle_listobjects_v2(
 	logging::debug("{}: response body {}", __func__, s.str());
 	logging::debug("{}: returned [{}]", __func__, string_body_response.reason());
 	session_ptr->send(std::move(string_body_response));
-}
+} // handle_listobjects_v2_impl
+
+asio::awaitable<void> irods::s3::actions::handle_listobjects_v2(
+	irods::http::session_pointer_type session_ptr,
+	irods::http::request_context_pointer request_ctx)
+{
+	co_await irods::http::offload([&] { handle_listobjects_v2_impl(session_ptr, request_ctx); });
+} // handle_listobjects_v2
@@ -0,0 +1,244 @@
+#include "irods/private/s3_api/s3_api.hpp"
+#include "irods/private/s3_api/authentication.hpp"
+#include "irods/private/s3_api/common_routines.hpp"
+#include "irods/private/s3_api/log.hpp"
+#include "irods/private/s3_api/multipart_state.hpp"
+#include "irods/private/s3_api/common.hpp"
+#include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/offload.hpp"
+#include "irods/private/s3_api/globals.hpp"
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace asio = boost::asio;
+namespace beast = boost::beast;
+namespace logging = irods::http::logging;
+
+const static std::string_view date_format{"{:%Y-%m-%dT%H:%M:%S.000Z}"};
+
+namespace
+{
+	// ListParts returns at most this many parts per page.
+	constexpr std::size_t max_parts_per_page = 1000;
+
+	auto parse_count(std::string_view _value) -> std::optional<std::size_t>
+	{
+		std::size_t count = 0;
+		const auto [ptr, ec] = std::from_chars(_value.data(), _value.data() + _value.size(), count);
+
+		if (ec != std::errc{} || ptr != _value.data() + _value.size()) {
+			return std::nullopt;
+		}
+
+		return count;
+	} // parse_count
+
+	auto make_user(const std::string& _name) -> boost::property_tree::ptree
+	{
+		boost::property_tree::ptree user;
+		user.put("ID", _name);
+		user.put("DisplayName", _name);
+		return user;
+	} // make_user
+} //namespace
+
+static void handle_listparts_impl(
+	irods::http::session_pointer_type session_ptr,
+	irods::http::request_context_pointer request_ctx)
+{
+	auto& parser = request_ctx->parser();
+	const auto& url = request_ctx->url();
+
+	namespace part_shmem = irods::s3::api::multipart_global_state;
+
+	beast::http::response<beast::http::empty_body> response;
+
+	// Authenticate
+	auto irods_username = irods::s3::authentication::authenticates(parser, url);
+	if (!irods_username) {
+		logging::error("{}: Failed to authenticate.", __func__);
+		response.result(beast::http::status::forbidden);
+		logging::debug("{}: returned [{}]", __func__, response.reason());
+		session_ptr->send(std::move(response));
+		return;
+	}
+
+	if (!request_ctx->bucket().has_value()) {
+		logging::error("{}: Failed to resolve bucket", __func__);
+		response.result(beast::http::status::not_found);
+		logging::debug("{}: returned [{}]", __func__, response.reason());
+		session_ptr->send(std::move(response));
+		return;
+	}
+
+	std::filesystem::path s3_bucket;
+	std::filesystem::path s3_key;
+
+	bool on_bucket = true;
+	for (auto seg : url.encoded_segments()) {
+		if (on_bucket) {
+			on_bucket = false;
+			s3_bucket = seg.decode();
+		}
+		else {
+			s3_key = s3_key / seg.decode();
+		}
+	}
+
+	// Returns the decoded value of a query parameter, or an empty string if it is missing.
+	const auto find_param = [&url](std::string_view _name) -> std::string {
+		if (const auto param = url.params().find(_name); param != url.params().end()) {
+			return (*param).value;
+		}
+		return {};
+	};
+
+	const auto upload_id = find_param("uploadId");
+	const auto max_parts_param = find_param("max-parts");
+	const auto part_number_marker_param = find_param("part-number-marker");
+
+	if (upload_id.empty()) {
+		logging::error("{}: Did not receive an uploadId", __func__);
+		response.result(beast::http::status::bad_request);
+		logging::debug("{}: returned [{}]", __func__, response.reason());
+		session_ptr->send(std::move(response));
+		return;
+	}
+
+	std::size_t max_parts = max_parts_per_page;
+	if (!max_parts_param.empty()) {
+		const auto count = parse_count(max_parts_param);
+		if (!count) {
+			irods::s3::api::common_routines::send_error_response(
+				session_ptr,
+				beast::http::status::bad_request,
+				"InvalidArgument",
+				fmt::format("Invalid max-parts [{}]", max_parts_param),
+				url.path(),
+				__func__);
+			return;
+		}
+
+		max_parts = std::min(*count, max_parts_per_page);
+	}
+
+	std::size_t part_number_marker = 0;
+	if (!part_number_marker_param.empty()) {
+		const auto marker = parse_count(part_number_marker_param);
+		if (!marker) {
+			irods::s3::api::common_routines::send_error_response(
+				session_ptr,
+				beast::http::status::bad_request,
+				"InvalidArgument",
+				fmt::format("Invalid part-number-marker [{}]", part_number_marker_param),
+				url.path(),
+				__func__);
+			return;
+		}
+
+		part_number_marker = *marker;
+	}
+
+	// The upload must be in progress, and must have been created for this object. Uploads restored
+	// from a journal written before uploads were indexed are only known by their state.
+	const auto entry = irods::http::globals::multipart_upload_index().find(upload_id);
+	const auto upload = part_shmem::find_upload(upload_id);
+
+	if ((!entry && !upload) || (entry && (entry->bucket != s3_bucket.string() || entry->key != s3_key.string()))) {
+		irods::s3::api::common_routines::send_error_response(
+			session_ptr,
+			beast::http::status::not_found,
+			"NoSuchUpload",
+			fmt::format("Upload [{}] does not exist", upload_id),
+			url.path(),
+			__func__);
+		return;
+	}
+
+	// Only the page returned is copied while the state of the upload is locked.
+	std::vector<std::pair<unsigned int, irods::s3::multipart_upload_part>> parts;
+	bool is_truncated = false;
+
+	if (upload) {
+		std::lock_guard<std::mutex> guard(upload->mtx);
+
+		const auto& uploaded_parts = upload->uploaded_parts;
+		auto iter = part_number_marker < std::numeric_limits<unsigned int>::max()
+		                ? uploaded_parts.upper_bound(static_cast<unsigned int>(part_number_marker))
+		                : uploaded_parts.end();
+
+		for (; iter != uploaded_parts.end(); ++iter) {
+			if (parts.size() == max_parts) {
+				is_truncated = true;
+				break;
+			}
+
+			parts.emplace_back(iter->first, iter->second);
+		}
+	}
+
+	const auto owner = entry ? entry->owner : *irods_username;
+
+	boost::property_tree::ptree document;
+	document.add("ListPartsResult", "");
+	document.add("ListPartsResult.Bucket", s3_bucket.string());
+	document.add("ListPartsResult.Key", s3_key.string());
+	document.add("ListPartsResult.UploadId", upload_id);
+	document.add("ListPartsResult.PartNumberMarker", part_number_marker);
+	document.add("ListPartsResult.NextPartNumberMarker", parts.empty() ? part_number_marker : parts.back().first);
+	document.add("ListPartsResult.MaxParts", max_parts);
+	document.add("ListPartsResult.IsTruncated", is_truncated ? "true" : "false");
+	document.add_child("ListPartsResult.Initiator", make_user(owner));
+	document.add_child("ListPartsResult.Owner", make_user(owner));
+	document.add("ListPartsResult.StorageClass", "STANDARD");
+
+	for (const auto& [part_number, part] : parts) {
+		boost::property_tree::ptree object;
+		object.put("PartNumber", part_number);
+		object.put(
+			"LastModified",
+			irods::s3::api::common_routines::convert_time_t_to_str(
+				std::chrono::system_clock::to_time_t(part.last_modified), date_format));
+		object.put("ETag", part.etag);
+		object.put("Size", part.size);
+		document.add_child("ListPartsResult.Part", object);
+	}
+
+	beast::http::response<beast::http::string_body> string_body_response(std::move(response));
+	std::stringstream s;
+	boost::property_tree::xml_parser::xml_writer_settings<std::string> settings;
+	settings.indent_char = ' ';
+	settings.indent_count = 4;
+	boost::property_tree::write_xml(s, document, settings);
+	string_body_response.body() = s.str();
+	string_body_response.result(beast::http::status::ok);
+	string_body_response.prepare_payload();
+
+	logging::debug("{}: response body {}", __func__, s.str());
+	logging::debug("{}: returned [{}]", __func__, string_body_response.reason());
+	session_ptr->send(std::move(string_body_response));
+} // handle_listparts_impl
+
+asio::awaitable<void> irods::s3::actions::handle_listparts(
+	irods::http::session_pointer_type session_ptr,
+	irods::http::request_context_pointer request_ctx)
+{
+	co_await irods::http::offload([&] { handle_listparts_impl(session_ptr, request_ctx); });
+} // handle_listparts
@@ -1,11 +1,17 @@
 #include "irods/private/s3_api/s3_api.hpp"
 #include "irods/private/s3_api/authentication.hpp"
+#include "irods/private/s3_api/aws_chunked_decoder.hpp"
+#include "irods/private/s3_api/buffer_pool.hpp"
+#include "irods/private/s3_api/checksum.hpp"
 #include "irods/private/s3_api/bucket.hpp"
 #include "irods/private/s3_api/common_routines.hpp"
 #include "irods/private/s3_api/connection.hpp"
+#include "irods/private/s3_api/identity.hpp"
 #include "irods/private/s3_api/log.hpp"
+#include "irods/private/s3_api/multipart_state.hpp"
 #include "irods/private/s3_api/common.hpp"
 #include "irods/private/s3_api/session.hpp"
+#include "irods/private/s3_api/offload.hpp"
 #include "irods/private/s3_api/configuration.hpp"
 #include "irods/private/s3_api/globals.hpp"
 
@@ -14,22 +20,31 @@
 #include <irods/fully_qualified_username.hpp>
 #include <irods/transport/default_transport.hpp>
 
-#ifdef IRODS_DEV_PACKAGE_IS_AT_LEAST_IRODS_5
-#  include <irods/authenticate.h>
-#  include <irods/irods_auth_constants.hpp> // For AUTH_PASSWORD_KEY.
-#endif // IRODS_DEV_PACKAGE_IS_AT_LEAST_IRODS_5
-
 #include <boost/beast/core/error.hpp>
 
 #include <boost/beast/http/empty_body.hpp>
 #include <boost/beast/http/read.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/experimental/channel.hpp>
 #include <boost/lexical_cast.hpp>
-
+#include <boost/uuid/uuid.hpp>
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <functional>
 #include <iostream>
 #include <vector>
 #include <fstream>
 #include <regex>
 #include <memory>
+#include <optional>
+#include <system_error>
 #include <unordered_map>
 
 namespace asio = boost::asio;
@@ -39,60 +54,324 @@ namespace logging = irods::http::logging;
 
 namespace irods::s3::api::multipart_global_state
 {
-	// This is a part size map which is shared between threads. Whenever part sizes are known
-	// they are added to this map. When complete or cancel multipart is executed, the part sizes
-	// for that upload_id are removed.
-	// The map looks like the following with the key of the first map being the upload_id and the
-	// key of the second map being the part number:
-	//    {
-	//      "1234abcd-1234-1234-123456789abc":
-	//        { 0: 4096000,
-	//          1: 4096000,
-	//          4: 4096000 },
-	//      "01234abc-0123-0123-0123456789ab":
-	//        { 0: 5192000,
-	//          3: 5192000 }
-	//    }
-	std::unordered_map<std::string, std::unordered_map<unsigned int, uint64_t>> part_size_map;
-
-	// This map holds persistent data needed for each upload_id. This includes the replica_token and
-	// replica_number.  In addition it holds shared pointers for the connection, transport, and odstream
-	// for the first stream that is opened. These shared pointers are saved to this map so that the first
-	// open() to an iRODS data object can remain open throughout the lifecycle of the request.  This
-	// stream will be closed in either CompleteMultipartUpload or AbortMultipartUpload.
-	std::unordered_map<
-		std::string,
-		std::tuple<
-			irods::experimental::io::replica_token,
-			irods::experimental::io::replica_number,
-			std::shared_ptr<irods::experimental::client_connection>,
-			std::shared_ptr<irods::experimental::io::client::native_transport>,
-			std::shared_ptr<irods::experimental::io::odstream>>>
-		replica_token_number_and_odstream_map;
-
-	// mutex to protect part_size_map
-	std::mutex multipart_global_state_mutex;
+	namespace
+	{
+		// Requests for the same upload always land in the same shard. The mutex of a shard is
+		// only held while an upload is looked up, added, or removed.
+		struct shard_type
+		{
+			std::mutex mtx;
+			std::unordered_map<std::string, upload_state_pointer> uploads;
+		}; // struct shard_type
+
+		constexpr std::size_t shard_count = 64;
+
+		// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+		std::array<shard_type, shard_count> shards;
+
+		auto shard_of(const std::string& _upload_id) -> shard_type&
+		{
+			return shards[std::hash<std::string>{}(_upload_id) % shard_count];
+		} // shard_of
+	} // anonymous namespace
+
+	auto find_upload(const std::string& _upload_id) -> upload_state_pointer
+	{
+		auto& shard = shard_of(_upload_id);
+		std::lock_guard<std::mutex> guard(shard.mtx);
+
+		if (const auto iter = shard.uploads.find(_upload_id); iter != shard.uploads.end()) {
+			return iter->second;
+		}
+
+		return nullptr;
+	} // find_upload
+
+	auto find_or_create_upload(const std::string& _upload_id) -> upload_state_pointer
+	{
+		auto& shard = shard_of(_upload_id);
+		std::lock_guard<std::mutex> guard(shard.mtx);
+
+		auto& upload = shard.uploads[_upload_id];
+		if (!upload) {
+			upload = std::make_shared<upload_state>();
+		}
+
+		return upload;
+	} // find_or_create_upload
+
+	auto erase_upload(const std::string& _upload_id) -> upload_state_pointer
+	{
+		auto& shard = shard_of(_upload_id);
+		std::lock_guard<std::mutex> guard(shard.mtx);
+
+		const auto iter = shard.uploads.find(_upload_id);
+		if (iter == shard.uploads.end()) {
+			return nullptr;
+		}
+
+		auto upload = std::move(iter->second);
+		shard.uploads.erase(iter);
+
+		return upload;
+	} // erase_upload
+
+	auto record_uploaded_part(
+		const std::string& _upload_id,
+		unsigned int _part_number,
+		std::uint64_t _size,
+		const std::string& _etag) -> void
+	{
+		const auto upload = find_upload(_upload_id);
+		if (!upload) {
+			return;
+		}
+
+		const irods::s3::multipart_upload_part part{
+			.size = _size, .etag = _etag, .last_modified = std::chrono::system_clock::now()};
+
+		{
+			std::lock_guard<std::mutex> guard(upload->mtx);
+			upload->uploaded_parts.insert_or_assign(_part_number, part);
+		}
+
+		irods::http::globals::multipart_journal().record_part_uploaded(_upload_id, _part_number, part);
+	} // record_uploaded_part
+
+	auto restore(std::unordered_map<std::string, irods::s3::multipart_journal::upload_state> _uploads) -> void
+	{
+		for (auto& [upload_id, restored] : _uploads) {
+			if (restored.entry) {
+				irods::http::globals::multipart_upload_index().insert(std::move(*restored.entry));
+			}
+
+			auto upload = find_or_create_upload(upload_id);
+			std::lock_guard<std::mutex> guard(upload->mtx);
+
+			for (const auto& [part_number, size] : restored.part_sizes) {
+				upload->part_sizes.set(part_number, size);
+			}
+
+			upload->uploaded_parts = std::move(restored.uploaded_parts);
+
+			if (restored.part_size) {
+				auto& layout = upload->layout.emplace(*restored.part_size);
+				for (const auto& [part_number, size] : restored.part_sizes) {
+					layout.record_part_size(part_number, size);
+				}
+			}
+
+			upload->resumed = true;
+		}
+	} // restore
+
+	auto open_data_object(
+		upload_state& _upload,
+		RcComm& _comm,
+		irods::experimental::io::odstream& _d,
+		irods::experimental::io::client::native_transport& _tp,
+		const std::string& _path) -> void
+	{
+		if (_upload.resumed) {
+			// Keep the parts written before the server restarted.
+			_d.open(
+				_tp,
+				_path,
+				irods::experimental::io::root_resource_name{irods::s3::get_resource()},
+				std::ios::out | std::ios::in);
+
+			if (_d.is_open()) {
+				_upload.resumed = false;
+				return;
+			}
+
+			// The reopen may fail for reasons other than a missing data object (e.g. the data
+			// object is locked). Truncating it would lose the parts written before the restart.
+			try {
+				if (fs::client::exists(_comm, _path)) {
+					logging::error(
+						"{}: Failed to reopen data object [{}] of a resumed multipart upload.", __func__, _path);
+					return;
+				}
+			}
+			catch (const std::exception& e) {
+				logging::error(
+					"{}: Could not determine whether data object [{}] of a resumed multipart upload exists: {}",
+					__func__,
+					_path,
+					e.what());
+				return;
+			}
+
+			// The data object was never created.
+		}
+
+		_d.open(
+			_tp,
+			_path,
+			irods::experimental::io::root_resource_name{irods::s3::get_resource()},
+			std::ios::out | std::ios::trunc);
+	} // open_data_object
 } // end namespace irods::s3::api::multipart_global_state
 
 namespace
 {
 	const std::regex upload_id_pattern("[0-9a-f]{8}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{4}-[0-9a-f]{12}");
 
-	enum class parsing_state
+	// Writes the staged parts of an upload whose offsets within the data object are known to
+	// iRODS. The remaining parts stay in the staging area until the sizes of the parts preceding
+	// them are known, or until CompleteMultipartUpload. This is a blocking operation.
+	auto flush_staged_parts(
+		const std::string& _upload_id,
+		const std::string& _irods_path,
+		const std::string& _irods_username) -> void
 	{
-		header_begin,
-		header_continue,
-		body,
-		end_of_chunk,
-		parsing_done,
-		parsing_error
-	};
+		namespace part_shmem = irods::s3::api::multipart_global_state;
+
+		auto& staging_area = irods::http::globals::part_staging_area();
+
+		const auto upload = part_shmem::find_upload(_upload_id);
+		if (!upload) {
+			return;
+		}
+
+		for (const auto part_number : staging_area.part_numbers(_upload_id)) {
+			std::optional<irods::experimental::io::replica_token> replica_token;
+			std::optional<irods::experimental::io::replica_number> replica_number;
+			std::uint64_t part_offset = 0;
+
+			{
+				std::lock_guard<std::mutex> guard(upload->mtx);
+
+				// The data object is opened by the first part written to iRODS. Until then, no
+				// part can be flushed.
+				if (!upload->replica) {
+					return;
+				}
+
+				// The offsets of this part and of the parts following it may not be known yet.
+				const auto offset = upload->part_sizes.offset_of(part_number);
+				if (!offset) {
+					return;
+				}
+
+				part_offset = *offset;
+				replica_token = std::get<0>(*upload->replica);
+				replica_number = std::get<1>(*upload->replica);
+			}
+
+			auto part = staging_area.take(_upload_id, part_number);
+			if (!part) {
+				// The part has been written by another request.
+				continue;
+			}
+
+			bool written = false;
+			try {
+				auto conn = irods::http::globals::streaming_connection_pool().get_connection(_irods_username);
+				irods::experimental::io::client::default_transport xtrans{*conn};
+				irods::experimental::io::odstream ds;
+				ds.open(xtrans, *replica_token, _irods_path, *replica_number, std::ios::out | std::ios::in);
+
+				if (ds.is_open()) {
+					ds.seekp(static_cast<std::streamoff>(part_offset));
+					ds.write(part->data(), static_cast<std::streamsize>(part->size()));
+					ds.close();
+					written = !ds.fail();
+				}
+
+				// A replica which could not be closed is closed when the connection is returned to
+				// the pool.
+				if (written) {
+					irods::http::streaming_connection_pool::mark_streams_closed(conn);
+				}
+			}
+			catch (const std::exception& e) {
+				logging::error("{}: {}", __func__, e.what());
+			}
+
+			if (!written) {
+				// Leave the part to CompleteMultipartUpload.
+				logging::warn(
+					"{}: Could not write staged part [{}] of upload [{}] to [{}].",
+					__func__,
+					part_number,
+					_upload_id,
+					_irods_path);
+				staging_area.restore(_upload_id, part_number, std::move(part));
+				return;
+			}
+
+			logging::debug(
+				"{}: Wrote staged part [{}] of upload [{}] at offset [{}] of [{}].",
+				__func__,
+				part_number,
+				_upload_id,
+				part_offset,
+				_irods_path);
+			irods::http::globals::multipart_journal().record_part(_upload_id, part_number, part->size());
+			staging_area.release(_upload_id);
+		}
+	} // flush_staged_parts
+
+	// Replaces the data object at _path with the data object at _temporary_path, which is removed
+	// if it cannot take its place. A data object which already exists at _path is moved next to
+	// the temporary data object first, and is only removed once the new one has taken its place.
+	// If that fails, it is moved back. This is a blocking operation.
+	auto replace_data_object(RcComm& _comm, const std::string& _temporary_path, const std::string& _path) -> bool
+	{
+		const auto replaced_path = _temporary_path + ".replaced";
+		bool moved_aside = false;
+
+		try {
+			// The rename does not overwrite an existing data object.
+			if (fs::client::is_data_object(fs::client::status(_comm, _path))) {
+				fs::client::rename(_comm, _path, replaced_path);
+				moved_aside = true;
+			}
+
+			fs::client::rename(_comm, _temporary_path, _path);
+		}
+		catch (const std::exception& e) {
+			logging::error("{}: Could not replace [{}] with [{}]: {}", __func__, _path, _temporary_path, e.what());
+
+			if (moved_aside) {
+				try {
+					fs::client::rename(_comm, replaced_path, _path);
+				}
+				catch (const std::exception& e) {
+					logging::error("{}: Could not move [{}] back to [{}]: {}", __func__, replaced_path, _path, e.what());
+				}
+			}
+
+			try {
+				fs::client::remove(_comm, _temporary_path, fs::remove_options::no_trash);
+			}
+			catch (const std::exception& e) {
+				logging::error("{}: Could not remove [{}]: {}", __func__, _temporary_path, e.what());
+			}
+
+			return false;
+		}
+
+		if (moved_aside) {
+			// The new data object is in place. The old one is left in the staging collection if it
+			// cannot be removed.
+			try {
+				fs::client::remove(_comm, replaced_path, fs::remove_options::no_trash);
+			}
+			catch (const std::exception& e) {
+				logging::error("{}: Could not remove [{}]: {}", __func__, replaced_path, e.what());
+			}
+		}
 
+		return true;
+	} // replace_data_object
 } //namespace
 
-void manually_parse_chunked_body_write_to_irods_in_background(
+asio::awaitable<void> manually_parse_chunked_body_write_to_irods(
 	irods::http::session_pointer_type session_ptr,
-	beast::http::response<beast::http::empty_body>& response_,
+	beast::http::response<beast::http::empty_body> response,
 	std::shared_ptr<beast::http::request_parser<boost::beast::http::buffer_body>> parser,
 	uint64_t read_buffer_size,
 	std::shared_ptr<std::ofstream> ofs,
@@ -100,15 +379,54 @@ void manually_parse_chunked_body_write_to_irods_in_background(
 	std::shared_ptr<irods::experimental::io::client::native_transport> tp,
 	std::shared_ptr<irods::experimental::io::odstream> d,
 	bool upload_part,
-	parsing_state current_state,
-	size_t chunk_size,
-	const std::string& parsing_buffer_string,
+	std::string upload_id,
+	unsigned int part_number,
 	bool know_part_offset,
 	bool keep_dstream_open_flag,
+	std::string upload_part_filename,
+	std::unique_ptr<irods::s3::staged_part> staged_part,
+	std::string irods_username,
+	std::string object_path,
+	std::string temporary_object_path,
+	std::optional<irods::s3::chunk_signing_context> signing_context,
+	std::optional<irods::s3::checksum_algorithm> trailer_checksum,
 	const std::string func);
 
-class incremental_async_read : public std::enable_shared_from_this<incremental_async_read>
+// An additional stream used to write a large object in parallel. The stream is opened on the
+// replica which is being written by the primary stream, using its replica token.
+struct write_lane
+{
+	explicit write_lane(std::shared_ptr<irods::experimental::client_connection> _conn)
+		: conn_ptr{std::move(_conn)}
+		, xtrans{*conn_ptr}
+	{
+	}
+
+	std::shared_ptr<irods::experimental::client_connection> conn_ptr;
+	irods::experimental::io::client::default_transport xtrans;
+	irods::experimental::io::odstream d;
+}; // struct write_lane
+
+class incremental_async_read
 {
+	// Carries a filled buffer from the socket reader to the hasher. The values are the index of
+	// the buffer and the number of bytes in it. The reader sends asio::error::eof once the body has
+	// been read.
+	using filled_buffer_channel =
+		asio::experimental::channel<void(boost::system::error_code, std::size_t, std::size_t)>;
+
+	// Carries a hashed buffer from the hasher to the writer of a lane. The values are the index of
+	// the buffer, the offset of its bytes within the body, and the number of bytes in it. The
+	// hasher sends asio::error::eof once every buffer has been handed out.
+	using write_request_channel =
+		asio::experimental::channel<void(boost::system::error_code, std::size_t, std::size_t, std::size_t)>;
+
+	// Returns an empty buffer from a writer to the reader. The value is the index of the buffer.
+	using free_buffer_channel = asio::experimental::channel<void(boost::system::error_code, std::size_t)>;
+
+	// Carries the result of the hasher and each writer (i.e. whether they succeeded) to the reader.
+	using stage_done_channel = asio::experimental::channel<void(boost::system::error_code, bool)>;
+
 	irods::http::session_pointer_type session_ptr_;
 	beast::http::response<beast::http::empty_body> resp_;
 	std::shared_ptr<beast::http::request_parser<boost::beast::http::buffer_body>> parser_;
@@ -117,14 +435,19 @@ class incremental_async_read : public std::enable_shared_from_this<incremental_a
 	bool part_offset_is_known_;
 	std::size_t part_offset_;
 	std::string upload_id_;
+	unsigned int part_number_;
 	std::string part_filename_;
 	std::ofstream part_file_;
-	std::vector<char> buffer_;
+	std::unique_ptr<irods::s3::staged_part> staged_part_;
+	std::string irods_username_;
+	std::vector<irods::http::buffer_pool::buffer> buffers_;
 	std::size_t total_bytes_read_{};
 	bool keep_dstream_open_flag;
 	std::shared_ptr<irods::experimental::client_connection> conn_;
 	std::shared_ptr<irods::experimental::io::client::default_transport> tp_;
 	std::shared_ptr<irods::experimental::io::odstream> odstream_;
+	std::vector<std::unique_ptr<write_lane>> write_lanes_;
+	irods::s3::md5_calculator md5_;
 
   public:
 	incremental_async_read(
@@ -136,8 +459,10 @@ class incremental_async_read : public std::enable_shared_from_this<incremental_a
 		bool _know_part_offset_flag,
 		size_t _part_offset,
 		std::string _upload_id,
+		unsigned int _part_number,
 		std::string _part_filename,
-		std::shared_ptr<irods::experimental::client_connection> _conn)
+		std::shared_ptr<irods::experimental::client_connection> _conn,
+		const std::string& _irods_username)
 		: session_ptr_{_session_ptr->shared_from_this()}
 		, resp_{std::move(_response)}
 		, parser_{_parser}
@@ -146,58 +471,72 @@ class incremental_async_read : public std::enable_shared_from_this<incremental_a
 		, part_offset_is_known_{_know_part_offset_flag}
 		, part_offset_{_part_offset}
 		, upload_id_{_upload_id}
+		, part_number_{_part_number}
 		, part_filename_{_part_filename}
-		, buffer_(irods::s3::get_put_object_buffer_size_in_bytes())
+		, irods_username_{_irods_username}
 		, keep_dstream_open_flag{false}
 		, conn_{_conn}
 	{
 		namespace part_shmem = irods::s3::api::multipart_global_state;
 
 		resp_.version(parser_->get().version());
-		resp_.set("ETag", _irods_path);
 		resp_.keep_alive(parser_->get().keep_alive());
 
 		tp_ = std::make_shared<irods::experimental::io::client::default_transport>(*conn_);
 		odstream_ = std::make_shared<irods::experimental::io::odstream>();
 
+		const auto content_length = parser_->content_length();
+		auto& staging_area = irods::http::globals::part_staging_area();
+
+		if (upload_part_flag_) {
+			// A copy of this part staged by an earlier attempt must not overwrite this one.
+			if (auto stale_part = staging_area.take(upload_id_, part_number_); stale_part) {
+				staging_area.release(upload_id_);
+			}
+		}
+
 		if (upload_part_flag_ && part_offset_is_known_) {
 			// we know the offset so seek and stream directly to iRODS
-			std::lock_guard<std::mutex> guard(part_shmem::multipart_global_state_mutex);
+			const auto upload = part_shmem::find_or_create_upload(upload_id_);
+			std::optional<part_shmem::open_replica_type> replica;
 
-			// if there is no replica token then just open the object without replica token and save the token
-			if (part_shmem::replica_token_number_and_odstream_map.find(upload_id_) ==
-			    part_shmem::replica_token_number_and_odstream_map.end())
 			{
-				logging::trace(
-					"{}: Open new iRODS data object [{}] for writing and seeking to {}.",
-					__func__,
-					irods_path_,
-					part_offset_);
-				odstream_->open(
-					*tp_,
-					irods_path_,
-					irods::experimental::io::root_resource_name{irods::s3::get_resource()},
-					std::ios::out | std::ios::trunc);
-				if (odstream_->is_open()) {
-					// the first stream that opens will stay open until CompleteMultipartTransfer is called
-					keep_dstream_open_flag = true;
-					part_shmem::replica_token_number_and_odstream_map[upload_id_] = {
-						odstream_->replica_token(), odstream_->replica_number(), conn_, tp_, odstream_};
+				std::lock_guard<std::mutex> guard(upload->mtx);
+
+				// if there is no replica token then just open the object without replica token and save the token
+				if (!upload->replica) {
+					logging::trace(
+						"{}: Open new iRODS data object [{}] for writing and seeking to {}.",
+						__func__,
+						irods_path_,
+						part_offset_);
+					part_shmem::open_data_object(
+						*upload, static_cast<RcComm&>(*conn_), *odstream_, *tp_, irods_path_);
+					if (odstream_->is_open()) {
+						// the first stream that opens will stay open until CompleteMultipartTransfer is called
+						keep_dstream_open_flag = true;
+						upload->replica.emplace(
+							odstream_->replica_token(), odstream_->replica_number(), conn_, tp_, odstream_);
+					}
+				}
+				else {
+					replica = upload->replica;
 				}
 			}
-			else {
+
+			if (replica) {
 				// get the replica token and pass it to open
 				logging::trace(
 					"{}: Open iRODS data object[{}] for writing and seeking to {}.  Replica token={}",
 					__func__,
 					irods_path_,
 					part_offset_,
-					std::get<0>(part_shmem::replica_token_number_and_odstream_map[upload_id_]).value);
+					std::get<0>(*replica).value);
 				odstream_->open(
 					*tp_,
-					std::get<0>(part_shmem::replica_token_number_and_odstream_map[upload_id_]), // replica token
+					std::get<0>(*replica), // replica token
 					irods_path_,
-					std::get<1>(part_shmem::replica_token_number_and_odstream_map[upload_id_]), // replica number
+					std::get<1>(*replica), // replica number
 					std::ios::out | std::ios::in);
 			}
 
@@ -214,12 +553,23 @@ class incremental_async_read : public std::enable_shared_from_this<incremental_a
 			odstream_->seekp(part_offset_);
 		}
 		else if (upload_part_flag_) {
-			logging::trace("{}: Open part file [{}] for writing.", __func__, part_filename_);
-			part_file_.open(part_filename_);
-			if (!part_file_) {
-				auto msg = fmt::format("{}: Failed to open part file for writing [{}].", __func__, _part_filename);
-				logging::error(msg);
-				THROW(SYS_INTERNAL_ERR, std::move(msg));
+			// Hold the part in memory until its offset is known. If the staging area does not have
+			// room for it, write it to a part file instead.
+			if (content_length) {
+				staged_part_ = staging_area.allocate(static_cast<std::size_t>(*content_length));
+			}
+
+			if (staged_part_) {
+				logging::trace("{}: Staging part [{}] of upload [{}] in memory.", __func__, part_number_, upload_id_);
+			}
+			else {
+				logging::trace("{}: Open part file [{}] for writing.", __func__, part_filename_);
+				part_file_.open(part_filename_);
+				if (!part_file_) {
+					auto msg = fmt::format("{}: Failed to open part file for writing [{}].", __func__, _part_filename);
+					logging::error(msg);
+					THROW(SYS_INTERNAL_ERR, std::move(msg));
+				}
 			}
 		}
 		else { // just a single part upload, stream directly to iRODS
@@ -233,132 +583,433 @@ class incremental_async_read : public std::enable_shared_from_this<incremental_a
 			}
 		}
 
-		parser_->get().body().data = buffer_.data();
-		parser_->get().body().size = buffer_.size();
+		const auto buffer_size = irods::s3::get_put_object_buffer_size_in_bytes();
+
+		// Large single part uploads are written through several streams, each on its own
+		// connection, so that multiple writes to iRODS are in flight at once.
+		if (!upload_part_flag_ && content_length &&
+		    *content_length >= irods::s3::get_put_object_parallel_write_threshold_in_bytes())
+		{
+			const auto block_count = (*content_length + buffer_size - 1) / buffer_size;
+			const auto stream_count =
+				std::min<std::uint64_t>(irods::s3::get_put_object_parallel_write_streams(), block_count);
+
+			if (stream_count > 1) {
+				open_write_lanes(_irods_username, stream_count - 1);
+			}
+		}
+
+		// Every lane gets its own share of buffers so that a slow lane does not keep the others idle.
+		const auto depth = std::max<std::uint64_t>(1, irods::s3::get_put_object_pipeline_depth()) * lane_count();
+		auto& pool = irods::http::globals::buffer_pool();
+
+		buffers_.reserve(depth);
+		for (std::uint64_t i = 0; i < depth; ++i) {
+			buffers_.push_back(pool.acquire(buffer_size));
+		}
 	} // constructor
 
-	auto start() -> void
+	// Reads the request body from the socket and writes it to iRODS (or the part file).
+	//
+	// The body is read into a ring of buffers which flow through three stages:
+	//
+	//   1. The reader fills a buffer from the socket on the session's strand.
+	//   2. The hasher adds the buffer to the MD5 digest of the body. Buffers are hashed in order.
+	//   3. The writer of a lane writes the buffer to iRODS at its offset within the object. There
+	//      is one lane per stream. Buffers are distributed round-robin across the lanes.
+	//
+	// The hasher and the writers run on the background thread pool, so network reads overlap
+	// with iRODS writes, and writes through different streams overlap with each other. The
+	// reader waits for a free buffer once all of them are in use, which bounds the memory used
+	// by a request.
+	auto run() -> asio::awaitable<void>
 	{
-		read_from_socket();
-	} // start
+		auto executor = co_await asio::this_coro::executor;
 
-  private:
-	auto read_from_socket() -> void
-	{
-		beast::http::async_read(
-			session_ptr_->stream(),
-			session_ptr_->get_buffer(),
-			*parser_,
-			beast::bind_front_handler(&incremental_async_read::on_incremental_async_read, shared_from_this()));
-	} // read_from_socket
-
-	auto on_incremental_async_read(beast::error_code _ec, std::size_t _bytes_transferred) -> void
-	{
-		logging::trace("{}: multipart upload: Number of bytes read from socket = [{}]", __func__, _bytes_transferred);
+		// Each channel has room for every buffer plus asio::error::eof, so sends never wait.
+		const auto capacity = buffers_.size() + 1;
+
+		free_buffer_channel free_buffers{executor, capacity};
+		filled_buffer_channel filled_buffers{executor, capacity};
+		std::vector<std::unique_ptr<write_request_channel>> write_requests;
+		stage_done_channel stages_done{executor, lane_count() + 1};
+
+		for (std::size_t i = 0; i < buffers_.size(); ++i) {
+			free_buffers.try_send(boost::system::error_code{}, i);
+		}
+
+		for (std::size_t i = 0; i < lane_count(); ++i) {
+			write_requests.push_back(std::make_unique<write_request_channel>(executor, capacity));
+		}
+
+		const auto on_stage_done = [&free_buffers, &stages_done](
+									   const char* _stage, std::exception_ptr _eptr, bool _succeeded) {
+			if (_eptr) {
+				try {
+					std::rethrow_exception(_eptr);
+				}
+				catch (const std::exception& e) {
+					logging::error("{}: Exception {}", _stage, e.what());
+				}
+				catch (...) {
+					logging::error("{}: Unknown exception encountered", _stage);
+				}
+
+				_succeeded = false;
+			}
+
+			// Wake the reader if it is waiting for a free buffer.
+			if (!_succeeded) {
+				free_buffers.close();
+			}
+
+			stages_done.try_send(boost::system::error_code{}, _succeeded);
+		};
+
+		asio::co_spawn(
+			executor, hash_buffers(filled_buffers, write_requests), [&on_stage_done](std::exception_ptr _eptr, bool _ok) {
+				on_stage_done("hash_buffers", _eptr, _ok);
+			});
+
+		for (std::size_t i = 0; i < lane_count(); ++i) {
+			asio::co_spawn(
+				executor,
+				write_buffers(i, free_buffers, *write_requests[i]),
+				[&on_stage_done](std::exception_ptr _eptr, bool _ok) { on_stage_done("write_buffers", _eptr, _ok); });
+		}
+
+		beast::error_code ec;
+
+		// True if any stage failed before the whole body was written.
+		bool aborted = false;
+
+		while (true) {
+			const auto index = co_await free_buffers.async_receive(asio::redirect_error(asio::use_awaitable, ec));
+			if (ec) {
+				// A writer or the hasher has stopped.
+				aborted = true;
+				break;
+			}
+
+			auto& buffer = buffers_[index];
+			parser_->get().body().data = buffer.data();
+			parser_->get().body().size = buffer.size();
 
-		if (_ec && _ec != beast::http::error::need_buffer) {
-			logging::error("{}: multipart upload: Error reading from socket: {}", __func__, _ec.message());
+			session_ptr_->refresh_timeout();
+			const auto bytes_transferred = co_await beast::http::async_read(
+				session_ptr_->stream(),
+				session_ptr_->get_buffer(),
+				*parser_,
+				asio::redirect_error(asio::use_awaitable, ec));
+			logging::trace(
+				"{}: multipart upload: Number of bytes read from socket = [{}]", __func__, bytes_transferred);
+
+			if (ec && ec != beast::http::error::need_buffer) {
+				logging::error("{}: multipart upload: Error reading from socket: {}", __func__, ec.message());
+				aborted = true;
+				break;
+			}
+
+			filled_buffers.try_send(boost::system::error_code{}, index, buffer.size() - parser_->get().body().size);
+
+			if (parser_->is_done()) {
+				logging::trace("{}: Request message has been processed [parser is done]", __func__);
+				break;
+			}
+		}
+
+		// Let the stages drain the buffers queued so far, or stop them if the transfer failed.
+		if (aborted) {
+			filled_buffers.close();
+			for (auto& channel : write_requests) {
+				channel->close();
+			}
+		}
+		else {
+			filled_buffers.try_send(asio::error::eof, 0, 0);
+		}
+
+		// The stages refer to the channels and buffers, so wait for all of them before returning.
+		bool write_succeeded = true;
+		boost::system::error_code ignored;
+		for (std::size_t i = 0; i < lane_count() + 1; ++i) {
+			if (!co_await stages_done.async_receive(asio::redirect_error(asio::use_awaitable, ignored))) {
+				write_succeeded = false;
+			}
+		}
+
+		co_await irods::http::offload([this] { close(); });
+
+		if (aborted || !write_succeeded) {
 			resp_.result(beast::http::status::internal_server_error);
 			session_ptr_->send(std::move(resp_)); // Schedules an async write op.
-			return;
+			co_return;
 		}
 
-		// The parser's buffer has been filled.
-		//
-		// This work is scheduled on the background thread pool so other threads get a
-		// chance to perform socket IO. Socket IO occurs on foreground threads only.
-		irods::http::globals::background_task([self = shared_from_this()] {
-			const auto byte_count = self->buffer_.size() - self->parser_->get().body().size;
-			logging::trace(
-				"{}: multipart upload: [{}] bytes in buffer_body for part file [{}].",
-				__func__,
-				byte_count,
-				self->part_filename_);
+		if (staged_part_) {
+			irods::http::globals::part_staging_area().insert(upload_id_, part_number_, std::move(staged_part_));
+			irods::http::globals::multipart_journal().record_staged_part(upload_id_, part_number_);
+		}
 
-			self->total_bytes_read_ += byte_count;
-			logging::trace(
-				"{}: multipart upload: Total bytes [{}] read for part file [{}].",
-				__func__,
-				self->total_bytes_read_,
-				self->part_filename_);
+		const auto etag = irods::s3::make_etag(md5_.finalize());
+		if (upload_part_flag_) {
+			irods::s3::api::multipart_global_state::record_uploaded_part(
+				upload_id_, part_number_, total_bytes_read_, etag);
+		}
 
-			if (self->upload_part_flag_ && !self->part_offset_is_known_) {
-				if (!self->part_file_.write(self->buffer_.data(), byte_count)) {
-					logging::error(
-						"{}: multipart upload: Error writing [{}] bytes to part file [{}].",
-						__func__,
-						byte_count,
-						self->part_filename_);
-					self->resp_.result(beast::http::status::internal_server_error);
-					self->session_ptr_->send(std::move(self->resp_)); // Schedules an async write op.
-					return;
+		resp_.set(beast::http::field::etag, etag);
+		resp_.result(beast::http::status::ok);
+		session_ptr_->send(std::move(resp_)); // Schedules an async write op.
+
+		// The size of this part may complete the offsets of staged parts, and the data object may
+		// have been opened by this part. Write the staged parts which can be written now instead
+		// of waiting for CompleteMultipartUpload.
+		if (upload_part_flag_) {
+			irods::http::globals::background_task(
+				[upload_id = upload_id_, irods_path = irods_path_, irods_username = irods_username_] {
+					flush_staged_parts(upload_id, irods_path, irods_username);
+				});
+		}
+	} // run
+
+  private:
+	// Returns the number of streams the body is written through.
+	auto lane_count() const noexcept -> std::size_t
+	{
+		return write_lanes_.size() + 1;
+	} // lane_count
+
+	// Opens up to _count additional streams to the replica being written by odstream_. Failing to
+	// open a stream is not an error. The object is written using the streams which were opened.
+	auto open_write_lanes(const std::string& _irods_username, std::uint64_t _count) -> void
+	{
+		auto& conn_pool = irods::http::globals::streaming_connection_pool();
+		const auto replica_token = odstream_->replica_token();
+		const auto replica_number = odstream_->replica_number();
+
+		try {
+			while (write_lanes_.size() < _count) {
+				auto lane = std::make_unique<write_lane>(conn_pool.get_connection(_irods_username));
+				lane->d.open(lane->xtrans, replica_token, irods_path_, replica_number, std::ios::out | std::ios::in);
+
+				if (!lane->d.is_open()) {
+					logging::warn("{}: Could not open additional stream for [{}].", __func__, irods_path_);
+					break;
+				}
+
+				write_lanes_.push_back(std::move(lane));
+			}
+		}
+		catch (const std::exception& e) {
+			logging::warn("{}: Could not open additional stream for [{}]: {}", __func__, irods_path_, e.what());
+		}
+
+		logging::trace("{}: Writing [{}] using {} streams.", __func__, irods_path_, lane_count());
+	} // open_write_lanes
+
+	// Adds the buffers received through _filled_buffers to the MD5 digest of the body, in order,
+	// and hands them round-robin to the writers of the lanes. Returns false if the reader stopped
+	// before the end of the body.
+	auto hash_buffers(
+		filled_buffer_channel& _filled_buffers,
+		std::vector<std::unique_ptr<write_request_channel>>& _write_requests) -> asio::awaitable<bool>
+	{
+		boost::system::error_code ec;
+		std::size_t offset = 0;
+
+		for (std::size_t block = 0;; ++block) {
+			const auto [index, byte_count] =
+				co_await _filled_buffers.async_receive(asio::redirect_error(asio::use_awaitable, ec));
+			if (ec == asio::error::eof) {
+				for (auto& channel : _write_requests) {
+					channel->try_send(asio::error::eof, 0, 0, 0);
 				}
+				co_return true;
+			}
+
+			if (ec) {
+				// The reader has stopped.
+				co_return false;
+			}
+
+			const std::string_view bytes{buffers_[index].data(), byte_count};
+			co_await irods::http::offload([this, bytes, func = __func__] {
+				md5_.update(bytes);
+				total_bytes_read_ += bytes.size();
 				logging::trace(
-					"{}: multipart upload: Wrote [{}] bytes to part file [{}].",
+					"{}: multipart upload: Total bytes [{}] read for part file [{}].",
+					func,
+					total_bytes_read_,
+					part_filename_);
+			});
+
+			if (!_write_requests[block % _write_requests.size()]->try_send(
+					boost::system::error_code{}, index, offset, byte_count))
+			{
+				// The channel was closed because the transfer failed.
+				co_return false;
+			}
+
+			offset += byte_count;
+		}
+	} // hash_buffers
+
+	// Writes the buffers received through _write_requests to the stream of lane _lane and hands
+	// each one back through _free_buffers once it has been written. Each write runs on the
+	// background thread pool. Returns false if a write failed.
+	auto write_buffers(std::size_t _lane, free_buffer_channel& _free_buffers, write_request_channel& _write_requests)
+		-> asio::awaitable<bool>
+	{
+		boost::system::error_code ec;
+
+		// The offset within the body at which the stream is positioned. Every stream starts at
+		// the beginning of the body.
+		std::size_t position = 0;
+
+		while (true) {
+			const auto [index, offset, byte_count] =
+				co_await _write_requests.async_receive(asio::redirect_error(asio::use_awaitable, ec));
+			if (ec == asio::error::eof) {
+				co_return true;
+			}
+
+			if (ec) {
+				// The transfer has been stopped.
+				co_return false;
+			}
+
+			const std::string_view bytes{buffers_[index].data(), byte_count};
+			const auto seek = (offset != position);
+			if (!co_await irods::http::offload(
+					[this, _lane, bytes, offset, seek] { return write_buffer(_lane, bytes, offset, seek); }))
+			{
+				co_return false;
+			}
+
+			position = offset + byte_count;
+			_free_buffers.try_send(boost::system::error_code{}, index);
+		}
+	} // write_buffers
+
+	// Writes _bytes to the part file or to the stream of lane _lane. If _seek is true, the stream
+	// is first positioned at _offset within the body. Returns false on failure.
+	auto write_buffer(std::size_t _lane, std::string_view _bytes, std::size_t _offset, bool _seek) -> bool
+	{
+		const auto byte_count = _bytes.size();
+		logging::trace(
+			"{}: multipart upload: [{}] bytes in buffer_body for part file [{}].", __func__, byte_count, part_filename_);
+
+		if (staged_part_) {
+			if (_offset + byte_count > staged_part_->size()) {
+				logging::error(
+					"{}: multipart upload: Part [{}] of upload [{}] is larger than its Content-Length.",
+					__func__,
+					part_number_,
+					upload_id_);
+				return false;
+			}
+			if (byte_count > 0) {
+				std::memcpy(staged_part_->data() + _offset, _bytes.data(), byte_count);
+			}
+		}
+		else if (upload_part_flag_ && !part_offset_is_known_) {
+			if (!part_file_.write(_bytes.data(), static_cast<std::streamsize>(byte_count))) {
+				logging::error(
+					"{}: multipart upload: Error writing [{}] bytes to part file [{}].",
 					__func__,
 					byte_count,
-					self->part_filename_);
+					part_filename_);
+				return false;
 			}
-			else {
-				if (!self->odstream_->write(self->buffer_.data(), byte_count)) {
-					logging::error(
-						"{}: multipart upload: Error writing [{}] bytes to iRODS data object [{}].",
-						__func__,
-						byte_count,
-						self->irods_path_);
-					self->resp_.result(beast::http::status::internal_server_error);
-					self->session_ptr_->send(std::move(self->resp_)); // Schedules an async write op.
-					return;
-				}
-				logging::trace(
-					"{}: multipart upload: Wrote [{}] bytes to iRODS data object [{}].",
+			logging::trace(
+				"{}: multipart upload: Wrote [{}] bytes to part file [{}].", __func__, byte_count, part_filename_);
+		}
+		else {
+			auto& stream = (_lane == 0) ? *odstream_ : write_lanes_[_lane - 1]->d;
+
+			if (_seek) {
+				stream.seekp(static_cast<std::streamoff>(part_offset_ + _offset));
+			}
+
+			if (!stream.write(_bytes.data(), static_cast<std::streamsize>(byte_count))) {
+				logging::error(
+					"{}: multipart upload: Error writing [{}] bytes at offset [{}] to iRODS data object [{}].",
 					__func__,
 					byte_count,
-					self->irods_path_);
+					_offset,
+					irods_path_);
+				return false;
 			}
+			logging::trace(
+				"{}: multipart upload: Wrote [{}] bytes to iRODS data object [{}].", __func__, byte_count, irods_path_);
+		}
 
-			if (self->parser_->is_done()) {
-				if (self->part_file_.is_open()) {
-					self->part_file_.close();
-				}
-				if (self->odstream_->is_open() && !self->keep_dstream_open_flag) {
-					logging::trace("{}:{} Closing iRODS data object [{}].", __func__, __LINE__, self->irods_path_);
-					self->odstream_->close();
-				}
+		return true;
+	} // write_buffer
 
-				logging::trace("{}: Request message has been processed [parser is done]", __func__);
-				self->resp_.result(beast::http::status::ok);
-				self->session_ptr_->send(std::move(self->resp_)); // Schedules an async write op.
-				return;
+	// Closes the part file and the streams. The additional streams are closed before the primary
+	// stream, which finalizes the replica. This is a blocking operation.
+	auto close() -> void
+	{
+		if (part_file_.is_open()) {
+			part_file_.close();
+		}
+
+		// A stream which fails to close may leave its replica open on the connection. Such a
+		// connection is not marked, so the pool closes the replica when the connection is returned.
+		for (auto& lane : write_lanes_) {
+			if (lane->d.is_open()) {
+				lane->d.close();
+				if (!lane->d.fail()) {
+					irods::http::streaming_connection_pool::mark_streams_closed(lane->conn_ptr);
+				}
 			}
+		}
+		write_lanes_.clear();
 
-			// Reset the parser's buffer_body state and schedule the next asynchronous read operation.
-			self->parser_->get().body().data = self->buffer_.data();
-			self->parser_->get().body().size = self->buffer_.size();
-			self->read_from_socket();
-		});
-	} // on_incremental_async_read
+		// A stream kept open for the rest of the multipart upload is closed by
+		// CompleteMultipartUpload or AbortMultipartUpload, which mark the connection.
+		if (keep_dstream_open_flag) {
+			return;
+		}
+
+		if (odstream_->is_open()) {
+			logging::trace("{}:{} Closing iRODS data object [{}].", __func__, __LINE__, irods_path_);
+			odstream_->close();
+			if (!odstream_->fail()) {
+				irods::http::streaming_connection_pool::mark_streams_closed(conn_);
+			}
+		}
+		else if (!odstream_->fail()) {
+			// The part was written to a part file or staged in memory.
+			irods::http::streaming_connection_pool::mark_streams_closed(conn_);
+		}
+	} // close
 }; // class incremental_async_read
 
-void irods::s3::actions::handle_putobject(
+asio::awaitable<void> irods::s3::actions::handle_putobject(
 	irods::http::session_pointer_type session_ptr,
-	beast::http::request_parser<boost::beast::http::empty_body>& empty_body_parser,
-	const boost::urls::url_view& url)
+	irods::http::request_context_pointer request_ctx)
 {
+	auto& empty_body_parser = request_ctx->parser();
+	const auto& url = request_ctx->url();
+
 	using json_pointer = nlohmann::json::json_pointer;
 	namespace part_shmem = irods::s3::api::multipart_global_state;
 
 	beast::http::response<beast::http::empty_body> response;
 
-	// Authenticate
-	auto irods_username = irods::s3::authentication::authenticates(empty_body_parser, url);
+	// Authenticate. The signing context is used to verify the chunk signatures of aws-chunked bodies.
+	irods::s3::chunk_signing_context signing_context;
+	auto irods_username = co_await irods::http::offload(
+		[&] { return irods::s3::authentication::authenticates(empty_body_parser, url, &signing_context); });
 
 	if (!irods_username) {
 		logging::error("{}: Failed to authenticate.", __func__);
 		response.result(beast::http::status::forbidden);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
 	// change the parser to a buffer_body parser and wrap in a shared_ptr
@@ -366,14 +1017,38 @@ void irods::s3::actions::handle_putobject(
 		std::make_shared<beast::http::request_parser<boost::beast::http::buffer_body>>(std::move(empty_body_parser));
 	auto& parser_message = parser->get();
 
-	// Look for the header that MinIO sends for chunked data.  If it exists we
-	// have to parse chunks ourselves.
+	// Look for the header that MinIO and the AWS SDKs send for chunked data.  If it exists we
+	// have to parse chunks ourselves. The unsigned variant does not sign its chunks.
 	bool special_chunked_header = false;
+	bool signed_chunks = false;
 	auto header = parser_message.find("x-Amz-Content-Sha256");
-	if (header != parser_message.end() && header->value() == "STREAMING-AWS4-HMAC-SHA256-PAYLOAD") {
-		special_chunked_header = true;
+	if (header != parser_message.end()) {
+		const auto content_sha256 = header->value();
+		if (content_sha256 == "STREAMING-AWS4-HMAC-SHA256-PAYLOAD" ||
+		    content_sha256 == "STREAMING-AWS4-HMAC-SHA256-PAYLOAD-TRAILER")
+		{
+			special_chunked_header = true;
+			signed_chunks = true;
+		}
+		else if (content_sha256 == "STREAMING-UNSIGNED-PAYLOAD-TRAILER") {
+			special_chunked_header = true;
+		}
+	}
+	logging::debug("{} special_chunk_header: {}", __func__, special_chunked_header);
+
+	// The checksum announced for the trailing headers of a chunked body.
+	std::optional<irods::s3::checksum_algorithm> trailer_checksum;
+	if (header = parser_message.find("x-amz-trailer"); special_chunked_header && header != parser_message.end()) {
+		const std::string_view trailer_name{header->value().data(), header->value().size()};
+		trailer_checksum = irods::s3::checksum_algorithm_from_header_name(trailer_name);
+		if (!trailer_checksum) {
+			logging::error("{}: Unsupported trailing header [{}].", __func__, trailer_name);
+			response.result(beast::http::status::bad_request);
+			logging::debug("{}: returned [{}]", __func__, response.reason());
+			session_ptr->send(std::move(response));
+			co_return;
+		}
 	}
-	logging::debug("{} special_chunk_header: {}", __func__, special_chunked_header);
 
 	// See if we have chunked set.  If so turn off special chunked header flag as the
 	// parser will handle it.
@@ -394,30 +1069,13 @@ void irods::s3::actions::handle_putobject(
 			response.result(boost::beast::http::status::bad_request);
 			logging::debug("{}: returned [{}]", __func__, response.reason());
 			session_ptr->send(std::move(response));
-			return;
-		}
-	}
-
-	if (parser_message[beast::http::field::expect] == "100-continue") {
-		response.version(11);
-		response.result(beast::http::status::continue_);
-		response.set(beast::http::field::server, parser_message["Host"]);
-
-		beast::error_code ec;
-		beast::http::write(session_ptr->stream(), response, ec);
-		if (ec) {
-			logging::error("{}: multipart upload: Error sending [100-continue] response: {}", __func__, ec.message());
-			response.result(beast::http::status::internal_server_error);
-			session_ptr->send(std::move(response));
-			return;
+			co_return;
 		}
-
-		logging::debug("{}: Sent 100-continue", __func__);
 	}
 
 	fs::path path;
-	if (auto bucket = irods::s3::resolve_bucket(url.segments()); bucket.has_value()) {
-		path = std::move(bucket.value());
+	if (const auto& bucket = request_ctx->bucket(); bucket.has_value()) {
+		path = bucket.value();
 		path = irods::s3::finish_path(path, url.segments());
 	}
 	else {
@@ -425,25 +1083,31 @@ void irods::s3::actions::handle_putobject(
 		response.result(beast::http::status::not_found);
 		logging::debug("{}: returned [{}]", __func__, response.reason());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 	logging::debug("{}: Path [{}]", __func__, path.string());
 
 	// This might be a "create folder" request. The only way to detect this is if the target path has a trailing slash.
 	if (path.string().back() == '/') {
-		auto conn = irods::get_connection(*irods_username);
-		fs::client::create_collections(conn, path);
+		co_await irods::http::offload([&] {
+			auto conn = irods::get_connection(*irods_username);
+			fs::client::create_collections(conn, path);
+		});
+		irods::http::globals::collection_cache().insert(irods::s3::get_zone(), path.string());
 		response.result(beast::http::status::ok);
 		logging::debug("{}: Created folder: [{}]", __func__, path.c_str());
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
 	// check to see if this is a part upload
 	bool upload_part = false;
 	bool know_part_offset = false;
 	uint64_t part_offset = 0;
+	uint64_t part_size = 0;
+	bool part_size_known = false;
 	std::string part_number;
+	unsigned int part_number_int = 0;
 	std::string upload_id;
 	std::string upload_part_filename;
 	if (const auto part_number_param = url.params().find("partNumber"); part_number_param != url.params().end()) {
@@ -461,47 +1125,52 @@ void irods::s3::actions::handle_putobject(
 			response.result(beast::http::status::bad_request);
 			logging::debug("{}: returned [{}]", __func__, response.reason());
 			session_ptr->send(std::move(response));
-			return;
+			co_return;
 		}
 		else if (upload_id.empty()) {
 			logging::error("{}: UploadPart detected but upload_id was not provided.", __func__);
 			response.result(beast::http::status::bad_request);
 			logging::debug("{}: returned [{}]", __func__, response.reason());
 			session_ptr->send(std::move(response));
-			return;
+			co_return;
 		}
 		else if (!std::regex_match(upload_id, upload_id_pattern)) {
 			logging::error("{}: Upload ID [{}] was not in expected format.", __func__, upload_id);
 			response.result(beast::http::status::bad_request);
 			logging::debug("{}: returned [{}]", __func__, response.reason());
 			session_ptr->send(std::move(response));
-			return;
+			co_return;
 		}
 
-		// parse the part_number
-		unsigned int part_number_int = 0;
-		try {
-			part_number_int = boost::lexical_cast<int>(part_number.c_str());
+		// parse the part_number before it is used to index the state of the upload
+		if (const auto parsed_part_number = irods::s3::parse_part_number(part_number); parsed_part_number) {
+			part_number_int = *parsed_part_number;
 		}
-		catch (const boost::bad_lexical_cast&) {
-			logging::error("{}: Upload ID [{}] Could not parse part_number [{}]", __func__, upload_id, part_number);
-			response.result(beast::http::status::bad_request);
-			logging::debug("{}: returned [{}]", __func__, response.reason());
-			session_ptr->send(std::move(response));
-			return;
+		else {
+			logging::error("{}: Upload ID [{}] Invalid part_number [{}]", __func__, upload_id, part_number);
+			irods::s3::api::common_routines::send_error_response(
+				session_ptr,
+				beast::http::status::bad_request,
+				"InvalidArgument",
+				fmt::format(
+					"Part number must be an integer between 1 and {}, inclusive", irods::s3::max_part_number),
+				url.path(),
+				__func__);
+			co_return;
 		}
 
 		// see if we have enough information to stream this part directly to iRODS
-		uint64_t part_size = 0;
 		{
-			std::lock_guard<std::mutex> guard(part_shmem::multipart_global_state_mutex);
-
 			// if an entry for upload id does not exist go ahead and create it
-			if (part_shmem::part_size_map.find(upload_id) == part_shmem::part_size_map.end()) {
-				part_shmem::part_size_map[upload_id] = std::unordered_map<unsigned int, uint64_t>();
-			}
+			const auto upload = part_shmem::find_or_create_upload(upload_id);
+			std::lock_guard<std::mutex> guard(upload->mtx);
+
+			// A part uploaded again is not listed until it has been received in full, so that an
+			// upload whose part was rejected halfway cannot be completed.
+			upload->uploaded_parts.erase(part_number_int);
+
 			try {
-				// add this part size to part_size_map
+				// record the size of this part
 				if (chunked_flag || special_chunked_header) {
 					// chunked - get part size from x-amz-decoded-content-length
 					// if this isn't provided then just continue without storing the part size
@@ -511,70 +1180,100 @@ void irods::s3::actions::handle_putobject(
 
 						// Make sure someone hasn't previously uploaded this part with a different part size.
 						// If so we can't handle that and have to reject the call.
-						if (part_shmem::part_size_map[upload_id].find(part_number_int) !=
-						    part_shmem::part_size_map[upload_id].end()) {
-							auto old_part_size = part_shmem::part_size_map[upload_id][part_number_int];
-							if (old_part_size != part_size) {
-								// reject this
-								logging::error(
-									"{}: Upload ID [{}] - part_number [{}] was uploaded a second time with a different "
-									"part size. Old part size = [{}]. New part size = [{}]. "
-									"Rejecting this request.",
-									__func__,
-									upload_id,
-									part_number_int,
-									old_part_size,
-									part_size);
-								response.result(beast::http::status::bad_request);
-								logging::debug("{}: returned [{}]", __func__, response.reason());
-								session_ptr->send(std::move(response));
-								return;
-							}
-						}
-
-						part_shmem::part_size_map[upload_id][part_number_int] = part_size;
-					}
-				}
-				else {
-					// not chunked, get part size from content_length
-					part_size = boost::lexical_cast<uint64_t>(parser_message[beast::http::field::content_length]);
-
-					// Make sure someone hasn't previously uploaded this part with a different part size.
-					// If so we can't handle that and have to reject the call.
-					if (part_shmem::part_size_map[upload_id].find(part_number_int) !=
-					    part_shmem::part_size_map[upload_id].end()) {
-						auto old_part_size = part_shmem::part_size_map[upload_id][part_number_int];
-						if (old_part_size != part_size) {
+						if (const auto old_part_size = upload->part_sizes.get(part_number_int);
+						    old_part_size && *old_part_size != part_size)
+						{
 							// reject this
 							logging::error(
 								"{}: Upload ID [{}] - part_number [{}] was uploaded a second time with a different "
-							    "part "
-								"size. Old part size = [{}]. New part size = [{}]. "
-								"Rejecting this request",
+								"part size. Old part size = [{}]. New part size = [{}]. "
+								"Rejecting this request.",
 								__func__,
 								upload_id,
 								part_number_int,
-								old_part_size,
+								*old_part_size,
 								part_size);
 							response.result(beast::http::status::bad_request);
 							logging::debug("{}: returned [{}]", __func__, response.reason());
 							session_ptr->send(std::move(response));
-							return;
+							co_return;
 						}
+
+						upload->part_sizes.set(part_number_int, part_size);
+						irods::http::globals::multipart_journal().record_part(upload_id, part_number_int, part_size);
+						part_size_known = true;
+					}
+				}
+				else {
+					// not chunked, get part size from content_length
+					part_size = boost::lexical_cast<uint64_t>(parser_message[beast::http::field::content_length]);
+
+					// Make sure someone hasn't previously uploaded this part with a different part size.
+					// If so we can't handle that and have to reject the call.
+					if (const auto old_part_size = upload->part_sizes.get(part_number_int);
+					    old_part_size && *old_part_size != part_size)
+					{
+						// reject this
+						logging::error(
+							"{}: Upload ID [{}] - part_number [{}] was uploaded a second time with a different "
+							"part size. Old part size = [{}]. New part size = [{}]. "
+							"Rejecting this request",
+							__func__,
+							upload_id,
+							part_number_int,
+							*old_part_size,
+							part_size);
+						response.result(beast::http::status::bad_request);
+						logging::debug("{}: returned [{}]", __func__, response.reason());
+						session_ptr->send(std::move(response));
+						co_return;
 					}
 
-					part_shmem::part_size_map[upload_id][part_number_int] = part_size;
+					upload->part_sizes.set(part_number_int, part_size);
+					irods::http::globals::multipart_journal().record_part(upload_id, part_number_int, part_size);
+					part_size_known = true;
 				}
 
 				// see if we know all of the previous part_sizes
-				know_part_offset = true;
-				for (unsigned int i = 1; i <= part_number_int - 1; ++i) {
-					if (part_shmem::part_size_map[upload_id].find(i) != part_shmem::part_size_map[upload_id].end()) {
-						part_offset += part_shmem::part_size_map[upload_id][i];
+				if (const auto offset = upload->part_sizes.offset_of(part_number_int); offset) {
+					know_part_offset = true;
+					part_offset = *offset;
+				}
+
+				// Most clients upload parts of equal size. If enabled, assume the size of the first
+				// part is shared by all parts.
+				if (part_number_int == 1 && part_size_known && irods::s3::get_multipart_upload_infer_part_size()) {
+					if (!upload->layout) {
+						upload->layout.emplace(part_size);
+						irods::http::globals::multipart_journal().record_part_size(upload_id, part_size);
 					}
-					else {
-						know_part_offset = false;
-						break;
+				}
+
+				// If the part size of the upload is known, the part can be placed without knowing
+				// the sizes of the parts preceding it.
+				if (upload->layout) {
+					auto& layout = *upload->layout;
+
+					if (part_size_known && !layout.record_part_size(part_number_int, part_size)) {
+						logging::error(
+							"{}: Upload ID [{}] - part_number [{}] has size [{}], but parts following it were "
+							"placed assuming the part size [{}]. Rejecting this request.",
+							__func__,
+							upload_id,
+							part_number_int,
+							part_size,
+							layout.part_size());
+						response.result(beast::http::status::bad_request);
+						logging::debug("{}: returned [{}]", __func__, response.reason());
+						session_ptr->send(std::move(response));
+						co_return;
+					}
+
+					if (!know_part_offset) {
+						if (const auto predicted_offset = layout.predict_offset(part_number_int); predicted_offset) {
+							know_part_offset = true;
+							part_offset = *predicted_offset;
+						}
 					}
 				}
 			}
@@ -615,49 +1314,44 @@ void irods::s3::actions::handle_putobject(
 		logging::debug("{}: UploadPart detected.  partNumber={} uploadId={}", __func__, part_number, upload_id);
 	}
 
-	// Make sure the parent collection exists.
-	{
-		auto conn = irods::get_connection(*irods_username);
-		fs::client::create_collections(conn, path.parent_path());
+	// Make sure the parent collection exists. Collections which are known to exist are skipped,
+	// which saves a round trip to the catalog for most objects.
+	const auto zone = irods::s3::get_zone();
+	auto& collection_cache = irods::http::globals::collection_cache();
+	if (!collection_cache.contains(zone, path.parent_path().string())) {
+		co_await irods::http::offload([&] {
+			auto conn = irods::get_connection(*irods_username);
+			fs::client::create_collections(conn, path.parent_path());
+		});
+		collection_cache.insert(zone, path.parent_path().string());
 	}
 
 	uint64_t read_buffer_size = irods::s3::get_put_object_buffer_size_in_bytes();
 	logging::debug("{}: read_buffer_size={}", __func__, read_buffer_size);
 
-	response.set("ETag", path.c_str());
 	response.set("Connection", "close");
 	response.keep_alive(parser_message.keep_alive());
 
-	// Create a dedicated iRODS connection for the upload.
-	const auto& config = irods::http::globals::configuration();
-	const auto& irods_client_config = config.at("irods_client");
-	const auto& zone = irods_client_config.at("zone").get_ref<const std::string&>();
-
-	const auto& rodsadmin_username =
-		irods_client_config.at(json_pointer{"/proxy_admin_account/username"}).get_ref<const std::string&>();
-	auto rodsadmin_password =
-		irods_client_config.at(json_pointer{"/proxy_admin_account/password"}).get_ref<const std::string&>();
-
-	auto conn = std::make_shared<irods::experimental::client_connection>(
-		irods::experimental::defer_authentication,
-		irods_client_config.at("host").get_ref<const std::string&>(),
-		irods_client_config.at("port").get<int>(),
-		irods::experimental::fully_qualified_username{rodsadmin_username, zone},
-		irods::experimental::fully_qualified_username{*irods_username, zone});
-
-	auto* conn_ptr = static_cast<RcComm*>(*conn);
-
-#ifdef IRODS_DEV_PACKAGE_IS_AT_LEAST_IRODS_5
-	const auto json_input = nlohmann::json{{"scheme", "native"}, {irods::AUTH_PASSWORD_KEY, rodsadmin_password}};
-	if (const auto ec = rc_authenticate_client(conn_ptr, json_input.dump().c_str()); ec < 0)
-#else
-	if (const auto ec = clientLoginWithPassword(conn_ptr, rodsadmin_password.data()); ec < 0)
-#endif // IRODS_DEV_PACKAGE_IS_AT_LEAST_IRODS_5
-	{
-		logging::error("{}: iRODS authentication error: {}", __func__, ec);
+	// Get an iRODS connection for the upload. The connection is returned to the streaming
+	// connection pool once the upload no longer needs it.
+	std::shared_ptr<irods::experimental::client_connection> conn;
+	try {
+		conn = co_await irods::http::offload(
+			[&] { return irods::http::globals::streaming_connection_pool().get_connection(*irods_username); });
+	}
+	catch (const std::exception& e) {
+		logging::error("{}: Could not get iRODS connection: {}", __func__, e.what());
+		response.result(beast::http::status::internal_server_error);
+		session_ptr->send(std::move(response));
+		co_return;
+	}
+
+	// The request has been accepted. Ask the client for the body if it is waiting for permission
+	// to send it.
+	if (const auto ec = co_await session_ptr->async_send_continue(); ec) {
 		response.result(beast::http::status::internal_server_error);
 		session_ptr->send(std::move(response));
-		return;
+		co_return;
 	}
 
 	if (special_chunked_header) {
@@ -673,74 +1367,127 @@ void irods::s3::actions::handle_putobject(
 		// since this will persist longer than the current routine
 		std::shared_ptr<std::ofstream> ofs = std::make_shared<std::ofstream>();
 
-		if (upload_part && know_part_offset) {
-			{
-				std::lock_guard<std::mutex> guard(part_shmem::multipart_global_state_mutex);
+		// The signatures of the chunks and the trailing checksum are only verified once the payload
+		// has been written. A single PutObject is therefore written to a temporary data object in
+		// the staging collection of the bucket, which only replaces the object once the payload is
+		// verified.
+		std::string temporary_path;
+		if (!upload_part) {
+			const auto suffix = boost::lexical_cast<std::string>(boost::uuids::random_generator()());
+			temporary_path = (irods::s3::staging_collection(*request_ctx->bucket()) / ("put_" + suffix)).string();
+		}
+
+		// A part whose offset is not known is held in memory if its decoded size is announced and
+		// the part staging area has room for it. Otherwise, it is written to a part file.
+		std::unique_ptr<irods::s3::staged_part> staged_part;
+
+		// Opening the data object is a blocking operation.
+		const auto opened = co_await irods::http::offload([&, func = __func__] {
+			if (upload_part) {
+				// A copy of this part staged by an earlier attempt must not overwrite this one.
+				auto& staging_area = irods::http::globals::part_staging_area();
+				if (auto stale_part = staging_area.take(upload_id, part_number_int); stale_part) {
+					staging_area.release(upload_id);
+				}
+			}
+
+			if (upload_part && know_part_offset) {
+				const auto upload = part_shmem::find_or_create_upload(upload_id);
+				std::optional<part_shmem::open_replica_type> replica;
 
-				// if there is no replica token then just open the object without replica token and save the token
-				if (part_shmem::replica_token_number_and_odstream_map.find(upload_id) ==
-				    part_shmem::replica_token_number_and_odstream_map.end())
 				{
-					logging::trace(
-						"{}: Open new iRODS data object [{}] for writing and seeking to {}.",
-						__func__,
-						path.string(),
-						part_offset);
-					d->open(
-						*tp,
-						path,
-						irods::experimental::io::root_resource_name{irods::s3::get_resource()},
-						std::ios::out | std::ios::trunc);
-					if (d->is_open()) {
-						keep_dstream_open_flag = true;
-						part_shmem::replica_token_number_and_odstream_map[upload_id] = {
-							d->replica_token(), d->replica_number(), conn, tp, d};
+					std::lock_guard<std::mutex> guard(upload->mtx);
+
+					// if there is no replica token then just open the object without replica token and save the token
+					if (!upload->replica) {
+						logging::trace(
+							"{}: Open new iRODS data object [{}] for writing and seeking to {}.",
+							func,
+							path.string(),
+							part_offset);
+						part_shmem::open_data_object(
+							*upload, static_cast<RcComm&>(*conn), *d, *tp, path.string());
+						if (d->is_open()) {
+							keep_dstream_open_flag = true;
+							upload->replica.emplace(d->replica_token(), d->replica_number(), conn, tp, d);
+						}
+					}
+					else {
+						replica = upload->replica;
 					}
 				}
-				else {
+
+				if (replica) {
 					// get the replica token and pass it to open
 					logging::trace(
 						"{}: Open iRODS data object [{}] for writing and seeking to {}.",
-						__func__,
+						func,
 						path.string(),
 						part_offset);
 					d->open(
 						*tp,
-						std::get<0>(part_shmem::replica_token_number_and_odstream_map[upload_id]), // replica token
+						std::get<0>(*replica), // replica token
 						path,
-						std::get<1>(part_shmem::replica_token_number_and_odstream_map[upload_id]), // replica number
+						std::get<1>(*replica), // replica number
 						std::ios::out | std::ios::in);
 				}
+				if (!d->is_open()) {
+					logging::error("{}: Failed to open dstream to iRODS", func);
+					return false;
+				}
+				d->seekp(part_offset);
 			}
-			if (!d->is_open()) {
-				logging::error("{}: Failed to open dstream to iRODS", __func__);
-				response.result(beast::http::status::internal_server_error);
-				logging::debug("{}: returned [{}]", __func__, response.reason());
-				session_ptr->send(std::move(response));
-				return;
+			else if (upload_part) {
+				if (part_size_known) {
+					staged_part =
+						irods::http::globals::part_staging_area().allocate(static_cast<std::size_t>(part_size));
+				}
+
+				if (staged_part) {
+					logging::trace("{}: Staging part [{}] of upload [{}] in memory.", func, part_number_int, upload_id);
+					return true;
+				}
+
+				logging::debug("{}: Open part file [{}] for writing.", func, upload_part_filename);
+				ofs->open(upload_part_filename, std::ofstream::out);
+				if (!ofs->is_open()) {
+					logging::error("{}: Failed to open stream for writing part", func);
+					return false;
+				}
 			}
-			d->seekp(part_offset);
-		}
-		else if (upload_part) {
-			logging::debug("{}: Open part file [{}] for writing.", __func__, upload_part_filename);
-			ofs->open(upload_part_filename, std::ofstream::out);
-			if (!ofs->is_open()) {
-				logging::error("{}: Failed to open stream for writing part", __func__);
-				response.result(beast::http::status::internal_server_error);
-				logging::debug("{}: returned [{}]", __func__, response.reason());
-				session_ptr->send(std::move(response));
-				return;
+			else {
+				const auto staging_collection = fs::path{temporary_path}.parent_path();
+				if (!collection_cache.contains(zone, staging_collection.string())) {
+					try {
+						fs::client::create_collections(static_cast<RcComm&>(*conn), staging_collection);
+					}
+					catch (const std::exception& e) {
+						logging::error("{}: Could not create [{}]: {}", func, staging_collection.string(), e.what());
+						return false;
+					}
+					collection_cache.insert(zone, staging_collection.string());
+				}
+
+				d->open(*tp, temporary_path, irods::experimental::io::root_resource_name{irods::s3::get_resource()});
+				if (!d->is_open()) {
+					logging::error("{}: Failed to open dstream to iRODS", func);
+					return false;
+				}
 			}
-		}
-		else {
-			d->open(*tp, path, irods::experimental::io::root_resource_name{irods::s3::get_resource()});
-			if (!d->is_open()) {
-				logging::error("{}: Failed to open dstream to iRODS", __func__);
-				response.result(beast::http::status::internal_server_error);
-				logging::debug("{}: returned [{}]", __func__, response.reason());
-				session_ptr->send(std::move(response));
-				return;
+
+			return true;
+		});
+
+		if (!opened) {
+			// The parent collection may have been removed by another client after it was cached.
+			collection_cache.erase(zone, path.parent_path().string());
+			if (!temporary_path.empty()) {
+				collection_cache.erase(zone, fs::path{temporary_path}.parent_path().string());
 			}
+			response.result(beast::http::status::internal_server_error);
+			logging::debug("{}: returned [{}]", __func__, response.reason());
+			session_ptr->send(std::move(response));
+			co_return;
 		}
 
 		// The eager option instructs the parser to continue reading the buffer once it has completed a
@@ -748,18 +1495,9 @@ void irods::s3::actions::handle_putobject(
 		// we want the parser to give us as much as is available.
 		parser->eager(true);
 
-		parsing_state current_state = parsing_state::header_begin;
-
-		// This is a string that holds input bytes temporarily as they are being read
-		// from the stream.  This chunk parser will only read more bytes into this
-		// when necessary to continue parsing.  Once bytes are no longer needed they are
-		// discarded from this variable.
-		std::string parsing_buffer_string;
-		size_t chunk_size = -1;
-
-		manually_parse_chunked_body_write_to_irods_in_background(
+		co_await manually_parse_chunked_body_write_to_irods(
 			session_ptr,
-			response,
+			std::move(response),
 			parser,
 			read_buffer_size,
 			ofs,
@@ -767,33 +1505,58 @@ void irods::s3::actions::handle_putobject(
 			tp,
 			d,
 			upload_part,
-			current_state,
-			chunk_size,
-			parsing_buffer_string,
+			upload_id,
+			part_number_int,
 			know_part_offset,
 			keep_dstream_open_flag,
+			upload_part_filename,
+			std::move(staged_part),
+			*irods_username,
+			path.string(),
+			temporary_path,
+			signed_chunks ? std::make_optional(std::move(signing_context)) : std::nullopt,
+			trailer_checksum,
 			__func__);
 	}
 	else {
 		logging::debug("{}: upload_part={}", __func__, upload_part);
-		std::make_shared<incremental_async_read>(
-			parser,
-			session_ptr,
-			response,
-			path,
-			upload_part,
-			know_part_offset,
-			part_offset,
-			upload_id,
-			upload_part_filename,
-			conn)
-			->start();
+
+		// The constructor opens the destination of the bytes, which is a blocking operation.
+		std::unique_ptr<incremental_async_read> reader;
+		try {
+			reader = co_await irods::http::offload([&] {
+				return std::make_unique<incremental_async_read>(
+					parser,
+					session_ptr,
+					response,
+					path,
+					upload_part,
+					know_part_offset,
+					part_offset,
+					upload_id,
+					part_number_int,
+					upload_part_filename,
+					conn,
+					*irods_username);
+			});
+		}
+		catch (const std::exception& e) {
+			logging::error("{}: {}", __func__, e.what());
+			// The parent collection may have been removed by another client after it was cached.
+			collection_cache.erase(zone, path.parent_path().string());
+			response.result(beast::http::status::internal_server_error);
+			logging::debug("{}: returned [{}]", __func__, response.reason());
+			session_ptr->send(std::move(response));
+			co_return;
+		}
+
+		co_await reader->run();
 	}
 } // handle_putobject
 
-void manually_parse_chunked_body_write_to_irods_in_background(
+asio::awaitable<void> manually_parse_chunked_body_write_to_irods(
 	irods::http::session_pointer_type session_ptr,
-	beast::http::response<beast::http::empty_body>& response_,
+	beast::http::response<beast::http::empty_body> response,
 	std::shared_ptr<beast::http::request_parser<boost::beast::http::buffer_body>> parser,
 	uint64_t read_buffer_size,
 	std::shared_ptr<std::ofstream> ofs,
@@ -801,40 +1564,105 @@ void manually_parse_chunked_body_write_to_irods_in_background(
 	std::shared_ptr<irods::experimental::io::client::native_transport> tp,
 	std::shared_ptr<irods::experimental::io::odstream> d,
 	bool upload_part,
-	parsing_state current_state,
-	size_t chunk_size,
-	const std::string& parsing_buffer_string_,
+	std::string upload_id,
+	unsigned int part_number,
 	bool know_part_offset,
 	bool keep_dstream_open_flag,
+	std::string upload_part_filename,
+	std::unique_ptr<irods::s3::staged_part> staged_part,
+	std::string irods_username,
+	std::string object_path,
+	std::string temporary_object_path,
+	std::optional<irods::s3::chunk_signing_context> signing_context,
+	std::optional<irods::s3::checksum_algorithm> trailer_checksum,
 	const std::string func)
 {
-	irods::http::globals::background_task([session_ptr,
-	                                       response = std::move(response_),
-	                                       parser,
-	                                       read_buffer_size,
-	                                       ofs,
-	                                       conn,
-	                                       tp,
-	                                       d,
-	                                       upload_part,
-	                                       current_state,
-	                                       chunk_size,
-	                                       parsing_buffer_string = std::move(parsing_buffer_string_),
-	                                       know_part_offset,
-	                                       keep_dstream_open_flag,
-	                                       func]() mutable {
-		boost::beast::error_code ec;
-		auto& parser_message = parser->get();
-
-		std::vector<char> buf_vector(read_buffer_size);
-		parser_message.body().data = buf_vector.data();
+	boost::beast::error_code ec;
+	auto& parser_message = parser->get();
+
+	// The decoder hands out the payload as views into the read buffer, so the payload is written to
+	// its destination straight from the buffer it was read into.
+	std::optional<irods::s3::aws_chunked_decoder> decoder_storage;
+	if (signing_context) {
+		decoder_storage.emplace(std::move(*signing_context));
+	}
+	else {
+		decoder_storage.emplace();
+	}
+	auto& decoder = *decoder_storage;
+
+	// The checksum is computed as the payload is written, and compared with the trailing header
+	// once the body is complete.
+	std::optional<irods::s3::checksum_calculator> checksum;
+	if (trailer_checksum) {
+		checksum.emplace(*trailer_checksum);
+	}
+
+	// The MD5 digest of the payload is the ETag of the object.
+	irods::s3::md5_calculator md5;
+	std::uint64_t payload_size = 0;
+
+	// Set if the payload does not have the decoded size announced by the client.
+	bool size_mismatch = false;
+
+	auto buffer = irods::http::globals::buffer_pool().acquire(read_buffer_size);
+
+	// Closes the destination of the payload. This is a blocking operation.
+	const auto close_streams = [&](bool _keep_dstream_open) {
+		if (ofs->is_open()) {
+			ofs->close();
+		}
+		if (_keep_dstream_open) {
+			return;
+		}
+		if (d->is_open()) {
+			logging::trace("{}:{} Closing iRODS data object.", func, __LINE__);
+			d->close();
+		}
+		// A replica which could not be closed is closed when the connection is returned to the pool.
+		if (!d->fail() && conn) {
+			irods::http::streaming_connection_pool::mark_streams_closed(conn);
+		}
+	};
+
+	// Discards the payload of a rejected request. The replica shared by the parts of an upload is
+	// left open. The bytes written to it are overwritten when the part is uploaded again, and the
+	// upload cannot be completed until then, as the part is not listed as uploaded. This is a
+	// blocking operation.
+	const auto discard_payload = [&] {
+		close_streams(keep_dstream_open_flag);
+
+		if (staged_part) {
+			staged_part.reset();
+		}
+		else if (upload_part && !know_part_offset) {
+			std::error_code remove_ec;
+			std::filesystem::remove(upload_part_filename, remove_ec);
+		}
+		else if (!temporary_object_path.empty()) {
+			try {
+				fs::client::remove(static_cast<RcComm&>(*conn), temporary_object_path, fs::remove_options::no_trash);
+			}
+			catch (const std::exception& e) {
+				logging::error("{}: Could not remove [{}]: {}", func, temporary_object_path, e.what());
+			}
+		}
+	};
+
+	while (true) {
+		parser_message.body().data = buffer.data();
 		parser_message.body().size = read_buffer_size;
 
 		// read in a loop and fill up buffer
 		// once we have filled the currently buffer, continue parsing
 		bool ready_to_continue_parsing = false;
 		while (!ready_to_continue_parsing && !parser->is_done()) {
-			beast::http::read_some(session_ptr->stream(), session_ptr->get_buffer(), *parser, ec);
+			session_ptr->refresh_timeout();
+			co_await beast::http::async_read_some(
+				session_ptr->stream(),
+				session_ptr->get_buffer(),
+				*parser,
+				asio::redirect_error(asio::use_awaitable, ec));
 
 			// need buffer means we have filled the current parser, write it to iRODS
 			if (ec == beast::http::error::need_buffer) {
@@ -844,252 +1672,175 @@ void manually_parse_chunked_body_write_to_irods_in_background(
 
 			if (ec) {
 				logging::error("{}: Error when parsing file - {}", func, ec.what());
+				co_await irods::http::offload(discard_payload);
 				response.result(beast::http::status::internal_server_error);
 				logging::debug("{}: returned [{}]", func, response.reason());
 				session_ptr->send(std::move(response));
-				return;
+				co_return;
 			}
 		}
 
-		bool need_more = false;
-
-		// add the current buffer into the parsing_buffer_string
-		size_t bytes_read = read_buffer_size - parser_message.body().size;
-		parsing_buffer_string.append(buf_vector.data(), bytes_read);
-
-		// continue parsing until we need more bytes in parsing_buffer_string
-		while (!parser->is_done() || !parsing_buffer_string.empty()) {
-			// break out if at a terminal state
-			if (current_state == parsing_state::parsing_done || current_state == parsing_state::parsing_error) {
-				break;
-			}
+		// Decode the bytes that were read and write the payload on the background thread pool.
+		const std::string_view bytes_read{buffer.data(), read_buffer_size - parser_message.body().size};
+		const auto write_succeeded = co_await irods::http::offload([&]() -> bool {
+			try {
+				bool stream_ok = true;
 
-			// if we have read all from the parser but need more bytes enter error state
-			if (parser->is_done() && need_more) {
-				logging::error("{}: Ran out of bytes before finished parsing", func);
-				current_state = parsing_state::parsing_error;
-				break;
-			}
+				decoder.decode(bytes_read, [&](std::string_view _payload) {
+					if (!stream_ok) {
+						return;
+					}
 
-			// if we need more, break out and continue in a new background thread
-			if (need_more) {
-				break;
-			}
+					md5.update(_payload);
+					payload_size += _payload.size();
 
-			switch (current_state) {
-				case parsing_state::header_begin: {
-					// Chunk headers can be of the following forms:
-					// 1. With extensions: <hex>;extension1=extension1value;extension2=extension2value\r\n
-					// 2. Without extensions: <hex>\r\n
-
-					// See if it is of form 1.
-					size_t semicolon_location = parsing_buffer_string.find(";");
-					if (semicolon_location == std::string::npos) {
-						// Not form 1.  See if it is form 2.
-						size_t newline_location = parsing_buffer_string.find("\r\n");
-						if (newline_location != std::string::npos) {
-							std::string chunk_size_str = parsing_buffer_string.substr(0, newline_location);
-							size_t hex_digits_parsed = 0;
-							try {
-								chunk_size = stoull(chunk_size_str, &hex_digits_parsed, 16);
-							}
-							catch (std::invalid_argument& e) {
-								hex_digits_parsed = 0;
-							}
-
-							if (hex_digits_parsed == chunk_size_str.length()) {
-								// eat the bytes up to and including \r\n
-								parsing_buffer_string = parsing_buffer_string.substr(newline_location + 2);
-								if (chunk_size == 0) {
-									current_state = parsing_state::end_of_chunk;
-								}
-								else {
-									current_state = parsing_state::body;
-								}
-							}
-							else {
-								logging::error("{}: bad chunk size: {}", func, chunk_size_str);
-								current_state = parsing_state::parsing_error;
-							}
-						}
-						else if (!parser->is_done()) {
-							need_more = true;
-						}
-						else {
-							// we have received all of the bytes but do not have "<hex>\r\n" sequence
-							logging::error("{}: Malformed chunk header", func);
-							current_state = parsing_state::parsing_error;
-						}
-					}
-					else {
-						// semicolon found
-						std::string chunk_size_str = parsing_buffer_string.substr(0, semicolon_location);
-						size_t hex_digits_parsed = 0;
-						try {
-							chunk_size = stoull(chunk_size_str, &hex_digits_parsed, 16);
-						}
-						catch (std::invalid_argument& e) {
-							hex_digits_parsed = 0;
-						}
-						if (hex_digits_parsed == chunk_size_str.length()) {
-							// eat the bytes up to and including semicolon
-							parsing_buffer_string = parsing_buffer_string.substr(semicolon_location + 1);
-							current_state = parsing_state::header_continue;
-						}
-						else {
-							logging::error("{}: bad chunk size: {}", func, chunk_size_str);
-							current_state = parsing_state::parsing_error;
-						}
+					if (checksum) {
+						checksum->update(_payload);
 					}
-					break;
-				}
-				case parsing_state::header_continue: {
-					// move beyond the newline
-					size_t newline_location = parsing_buffer_string.find("\r\n");
-
-					// set string to after the \r\n
-					if (newline_location != std::string::npos) {
-						parsing_buffer_string = parsing_buffer_string.substr(newline_location + 2);
-						if (chunk_size == 0) {
-							current_state = parsing_state::end_of_chunk;
-						}
-						else {
-							current_state = parsing_state::body;
+
+					if (staged_part) {
+						// The payload must not exceed the decoded size announced by the client.
+						const auto offset = payload_size - _payload.size();
+						if (payload_size > staged_part->size()) {
+							size_mismatch = true;
+							stream_ok = false;
+							return;
 						}
+						std::memcpy(staged_part->data() + offset, _payload.data(), _payload.size());
 					}
-					else if (!parser->is_done()) {
-						need_more = true;
+					else if (upload_part && !know_part_offset) {
+						stream_ok = static_cast<bool>(ofs->write(_payload.data(), _payload.size()));
 					}
 					else {
-						// we have read all the bytes but do not have a \r\n at the end
-						// of the header line
-						logging::error("{}: Malformed chunk header", func);
-						current_state = parsing_state::parsing_error;
+						stream_ok = static_cast<bool>(d->write(_payload.data(), _payload.size()));
 					}
-					break;
-				}
-				case parsing_state::body: {
-					// if we have the full chunk, handle it otherwise continue
-					// until we do
-					if (parsing_buffer_string.length() >= chunk_size) {
-						std::string body = parsing_buffer_string.substr(0, chunk_size);
-
-						try {
-							if (upload_part && !know_part_offset) {
-								ofs->write(body.c_str(), body.length());
-							}
-							else {
-								d->write(body.c_str(), body.length());
-							}
-						}
-						catch (std::exception& e) {
-							logging::error("{}: Exception when writing to file - {}", func, e.what());
-							response.result(beast::http::status::internal_server_error);
-							logging::debug("{}: returned [{}]", func, response.reason());
-							session_ptr->send(std::move(response));
-							return;
-						}
+				});
 
-						// reset string stream and set it to after the \r\n
-						parsing_buffer_string = parsing_buffer_string.substr(chunk_size);
-						current_state = parsing_state::end_of_chunk;
-					}
-					else {
-						// Note to save memory we could stream the bytes we have, decrease
-						// chunk size, and discard these bytes.
-						need_more = true;
-					}
-					break;
+				if (!stream_ok) {
+					logging::error("{}: Error writing [{}] bytes of payload.", func, bytes_read.size());
 				}
-				case parsing_state::end_of_chunk: {
-					// If the size of parsing_buffer_string is just one and consists of "\r"
-					// then we need to get more bytes.
-					if (!parser->is_done() && parsing_buffer_string.size() == 1 && parsing_buffer_string[0] == '\r') {
-						// we don't have enough bytes to read the expected "\r\n"
-						// but there are more bytes to be read
-						need_more = true;
-						break;
-					}
-
-					// If the size is 0 then we need to get more bytes.
-					if (!parser->is_done() && parsing_buffer_string.size() == 0) {
-						// we don't have enough bytes to read the expected "\r\n"
-						// but there are more bytes to be read
-						need_more = true;
-						break;
-					}
 
-					size_t newline_location = parsing_buffer_string.find("\r\n");
-					if (newline_location != 0) {
-						logging::error("{}: Invalid chunk end sequence", func);
-						current_state = parsing_state::parsing_error;
-					}
-					else {
-						// remove \r\n and go to next chunk
-						parsing_buffer_string = parsing_buffer_string.substr(2);
-						if (chunk_size == 0) {
-							current_state = parsing_state::parsing_done;
-						}
-						else {
-							current_state = parsing_state::header_begin;
-						}
-					}
-					break;
-				}
-				default:
-					break;
+				return stream_ok;
+			}
+			catch (std::exception& e) {
+				logging::error("{}: Exception when writing to file - {}", func, e.what());
+				return false;
 			}
+		});
 
-			// if we are done return ok
-			if (current_state == parsing_state::parsing_done) {
-				// this is to force that these are destructed in the correct order
-				auto conn_ptr = conn;
-				auto transport_ptr = tp;
-				auto dstream_ptr = d;
+		if (!write_succeeded) {
+			co_await irods::http::offload(discard_payload);
+			response.result(
+				size_mismatch ? beast::http::status::bad_request : beast::http::status::internal_server_error);
+			logging::debug("{}: returned [{}]", func, response.reason());
+			session_ptr->send(std::move(response));
+			co_return;
+		}
 
-				if (ofs->is_open()) {
-					ofs->close();
-				}
-				if (!keep_dstream_open_flag && d->is_open()) {
-					logging::trace("{}:{} Closing iRODS data object.", __func__, __LINE__);
-					d->close();
-				}
-				response.result(beast::http::status::ok);
-				logging::debug("{}: returned [{}]:{}", func, response.reason(), __LINE__);
+		if (decoder.done() && checksum) {
+			const auto name = irods::s3::checksum_header_name(checksum->algorithm());
+			const auto expected = decoder.trailer(name);
+			const auto computed = checksum->finalize();
+
+			if (!expected || *expected != computed) {
+				co_await irods::http::offload(discard_payload);
+				logging::error(
+					"{}: BadDigest: [{}] announced as [{}] but computed as [{}].",
+					func,
+					name,
+					expected.value_or("<missing>"),
+					computed);
+				response.result(beast::http::status::bad_request);
+				logging::debug("{}: returned [{}]", func, response.reason());
 				session_ptr->send(std::move(response));
-				return;
+				co_return;
 			}
-			else if (current_state == parsing_state::parsing_error) {
-				if (ofs->is_open()) {
-					ofs->close();
+
+			response.set(beast::string_view{name.data(), name.size()}, computed);
+		}
+
+		if (decoder.done() && staged_part && payload_size != staged_part->size()) {
+			co_await irods::http::offload(discard_payload);
+			logging::error(
+				"{}: Received [{}] bytes of payload, but [{}] were announced.", func, payload_size, staged_part->size());
+			response.result(beast::http::status::bad_request);
+			logging::debug("{}: returned [{}]", func, response.reason());
+			session_ptr->send(std::move(response));
+			co_return;
+		}
+
+		if (decoder.done()) {
+			const auto stored = co_await irods::http::offload([&] {
+				close_streams(keep_dstream_open_flag);
+
+				if (temporary_object_path.empty()) {
+					return true;
 				}
-				if (d->is_open()) {
-					d->close();
+
+				if (d->fail()) {
+					discard_payload();
+					return false;
 				}
-				logging::error("{}: Error parsing chunked body", func);
-				response.result(boost::beast::http::status::bad_request);
+
+				return replace_data_object(static_cast<RcComm&>(*conn), temporary_object_path, object_path);
+			});
+
+			if (!stored) {
+				response.result(beast::http::status::internal_server_error);
 				logging::debug("{}: returned [{}]", func, response.reason());
 				session_ptr->send(std::move(response));
-				return;
+				co_return;
+			}
+
+			if (staged_part) {
+				irods::http::globals::part_staging_area().insert(upload_id, part_number, std::move(staged_part));
+				irods::http::globals::multipart_journal().record_staged_part(upload_id, part_number);
 			}
+
+			const auto etag = irods::s3::make_etag(md5.finalize());
+			if (upload_part) {
+				irods::s3::api::multipart_global_state::record_uploaded_part(
+					upload_id, part_number, payload_size, etag);
+			}
+
+			response.set(beast::http::field::etag, etag);
+			response.result(beast::http::status::ok);
+			logging::debug("{}: returned [{}]:{}", func, response.reason(), __LINE__);
+			session_ptr->send(std::move(response));
+
+			// The size of this part may complete the offsets of staged parts, and the data object
+			// may have been opened by this part. Write the staged parts which can be written now
+			// instead of waiting for CompleteMultipartUpload.
+			if (upload_part) {
+				irods::http::globals::background_task([upload_id, object_path, irods_username] {
+					flush_staged_parts(upload_id, object_path, irods_username);
+				});
+			}
+
+			co_return;
 		}
 
-		// schedule a new task to continue
-		manually_parse_chunked_body_write_to_irods_in_background(
-			session_ptr,
-			response,
-			parser,
-			read_buffer_size,
-			ofs,
-			conn,
-			tp,
-			d,
-			upload_part,
-			current_state,
-			chunk_size,
-			parsing_buffer_string,
-			know_part_offset,
-			keep_dstream_open_flag,
-			func);
-	});
-} // manually_parse_chunked_body_write_to_irods_in_background
+		if (decoder.failed()) {
+			co_await irods::http::offload(discard_payload);
+			logging::error("{}: Error parsing chunked body: {}", func, irods::s3::to_string(decoder.error()));
+			// A chunk which does not match its signature was altered or not signed by the user.
+			response.result(
+				decoder.error() == irods::s3::aws_chunked_decoder::error_code::signature_mismatch
+					? beast::http::status::forbidden
+					: beast::http::status::bad_request);
+			logging::debug("{}: returned [{}]", func, response.reason());
+			session_ptr->send(std::move(response));
+			co_return;
+		}
+
+		// Every byte of the request has been consumed, but the chunked body is incomplete.
+		if (parser->is_done()) {
+			co_await irods::http::offload(discard_payload);
+			logging::error("{}: Ran out of bytes before finished parsing", func);
+			response.result(boost::beast::http::status::bad_request);
+			logging::debug("{}: returned [{}]", func, response.reason());
+			session_ptr->send(std::move(response));
+			co_return;
+		}
+	}
+} // manually_parse_chunked_body_write_to_irods
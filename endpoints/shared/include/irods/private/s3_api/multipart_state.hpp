@@ -0,0 +1,102 @@
+#ifndef IRODS_S3_API_MULTIPART_STATE_HPP
+#define IRODS_S3_API_MULTIPART_STATE_HPP
+
+#include "irods/private/s3_api/multipart_journal.hpp"
+#include "irods/private/s3_api/multipart_upload_index.hpp"
+#include "irods/private/s3_api/part_size_index.hpp"
+#include "irods/private/s3_api/uniform_part_layout.hpp"
+
+#include <irods/client_connection.hpp>
+#include <irods/dstream.hpp>
+#include <irods/transport/default_transport.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+
+// The state of the multipart uploads in progress, shared by the multipart endpoints. The
+// registry of uploads is defined in putobject.cpp.
+//
+// Uploads are kept in a map split into shards, each with its own mutex, which is only held while
+// an upload is looked up. Each upload has a mutex of its own protecting its state, so requests
+// for different uploads do not contend with each other.
+namespace irods::s3::api::multipart_global_state
+{
+	// The replica token and replica number of the data object being written by an upload, along
+	// with the stream which keeps it open until CompleteMultipartUpload or AbortMultipartUpload.
+	using open_replica_type = std::tuple<
+		irods::experimental::io::replica_token,
+		irods::experimental::io::replica_number,
+		std::shared_ptr<irods::experimental::client_connection>,
+		std::shared_ptr<irods::experimental::io::client::native_transport>,
+		std::shared_ptr<irods::experimental::io::odstream>>;
+
+	struct upload_state
+	{
+		// Protects the members below.
+		std::mutex mtx;
+
+		// The sizes of the parts received so far.
+		irods::s3::part_size_index part_sizes;
+
+		// The part size shared by the parts of the upload, if it was announced to
+		// CreateMultipartUpload or inferred from the first part.
+		std::optional<irods::s3::uniform_part_layout> layout;
+
+		// The parts received in full, as returned by ListParts.
+		std::map<unsigned int, irods::s3::multipart_upload_part> uploaded_parts;
+
+		// The data object opened by the first part written to iRODS.
+		std::optional<open_replica_type> replica;
+
+		// True if the upload was restored from the multipart journal and its data object has not
+		// been opened since the server started. The data object may already hold parts written
+		// before the restart, so it must not be truncated when it is opened again.
+		bool resumed = false;
+	}; // struct upload_state
+
+	using upload_state_pointer = std::shared_ptr<upload_state>;
+
+	// Returns the state of an upload, or nullptr if the upload has no state.
+	auto find_upload(const std::string& _upload_id) -> upload_state_pointer;
+
+	// Returns the state of an upload, creating it if necessary.
+	auto find_or_create_upload(const std::string& _upload_id) -> upload_state_pointer;
+
+	// Removes the state of an upload. Requests holding a pointer to it may keep using it.
+	//
+	// Returns the removed state, or nullptr if the upload had no state.
+	auto erase_upload(const std::string& _upload_id) -> upload_state_pointer;
+
+	// Records that a part was received in full, so that ListParts returns it. Does nothing if the
+	// upload has no state, i.e. it was completed or aborted meanwhile.
+	auto record_uploaded_part(
+		const std::string& _upload_id,
+		unsigned int _part_number,
+		std::uint64_t _size,
+		const std::string& _etag) -> void;
+
+	// Adds the uploads restored from the multipart journal to the state and to the multipart
+	// upload index. This is called once, during startup.
+	auto restore(std::unordered_map<std::string, irods::s3::multipart_journal::upload_state> _uploads) -> void;
+
+	// Opens the data object of an upload which has no open replica, i.e. on behalf of the first
+	// part written to iRODS. The data object is truncated unless the upload was restored from the
+	// multipart journal. The data object of a restored upload is only created if it does not
+	// exist. If it exists but cannot be reopened, _d is left closed and the upload is still
+	// considered restored, so that a later attempt can reopen it. The mutex of the upload must be
+	// held.
+	auto open_data_object(
+		upload_state& _upload,
+		RcComm& _comm,
+		irods::experimental::io::odstream& _d,
+		irods::experimental::io::client::native_transport& _tp,
+		const std::string& _path) -> void;
+} // namespace irods::s3::api::multipart_global_state
+
+#endif // IRODS_S3_API_MULTIPART_STATE_HPP
@@ -2,6 +2,7 @@
 #define IRODS_S3_API_S3_API_HPP
 
 #include "irods/private/s3_api/common.hpp"
+#include "irods/private/s3_api/request_context.hpp"
 
 #include <irods/filesystem.hpp>
 
@@ -11,65 +12,61 @@
 
 namespace irods::s3::actions
 {
-	void handle_listobjects_v2(
+	boost::asio::awaitable<void> handle_listobjects_v2(
 		irods::http::session_pointer_type sess_ptr,
-		boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		const boost::urls::url_view&);
+		irods::http::request_context_pointer request_ctx);
 
-	void handle_listbuckets(
+	boost::asio::awaitable<void> handle_listbuckets(
 		irods::http::session_pointer_type sess_ptr,
-		boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		const boost::urls::url_view&);
+		irods::http::request_context_pointer request_ctx);
 
-	void handle_getobject(
+	boost::asio::awaitable<void> handle_getobject(
 		irods::http::session_pointer_type sess_ptr,
-		boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		const boost::urls::url_view&);
+		irods::http::request_context_pointer request_ctx);
 
-	void handle_deleteobject(
+	boost::asio::awaitable<void> handle_deleteobject(
 		irods::http::session_pointer_type sess_ptr,
-		boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		const boost::urls::url_view&);
+		irods::http::request_context_pointer request_ctx);
 
-	void handle_deleteobjects(
+	boost::asio::awaitable<void> handle_deleteobjects(
 		irods::http::session_pointer_type sess_ptr,
-		boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		const boost::urls::url_view&);
+		irods::http::request_context_pointer request_ctx);
 
-	void handle_putobject(
+	boost::asio::awaitable<void> handle_putobject(
 		irods::http::session_pointer_type sess_ptr,
-		boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		const boost::urls::url_view&);
+		irods::http::request_context_pointer request_ctx);
 
-	void handle_headobject(
+	boost::asio::awaitable<void> handle_headobject(
 		irods::http::session_pointer_type sess_ptr,
-		boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		const boost::urls::url_view&);
+		irods::http::request_context_pointer request_ctx);
 
-	void handle_headbucket(
+	boost::asio::awaitable<void> handle_headbucket(
 		irods::http::session_pointer_type sess_ptr,
-		boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		const boost::urls::url_view&);
+		irods::http::request_context_pointer request_ctx);
 
-	void handle_copyobject(
+	boost::asio::awaitable<void> handle_copyobject(
 		irods::http::session_pointer_type sess_ptr,
-		boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		const boost::urls::url_view&);
+		irods::http::request_context_pointer request_ctx);
 
-	void handle_createmultipartupload(
+	boost::asio::awaitable<void> handle_createmultipartupload(
 		irods::http::session_pointer_type sess_ptr,
-		boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		const boost::urls::url_view&);
+		irods::http::request_context_pointer request_ctx);
 
-	void handle_completemultipartupload(
+	boost::asio::awaitable<void> handle_completemultipartupload(
 		irods::http::session_pointer_type sess_ptr,
-		boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		const boost::urls::url_view&);
+		irods::http::request_context_pointer request_ctx);
 
-	void handle_abortmultipartupload(
+	boost::asio::awaitable<void> handle_abortmultipartupload(
 		irods::http::session_pointer_type sess_ptr,
-		boost::beast::http::request_parser<boost::beast::http::empty_body>& parser,
-		const boost::urls::url_view&);
+		irods::http::request_context_pointer request_ctx);
+
+	boost::asio::awaitable<void> handle_listmultipartuploads(
+		irods::http::session_pointer_type sess_ptr,
+		irods::http::request_context_pointer request_ctx);
+
+	boost::asio::awaitable<void> handle_listparts(
+		irods::http::session_pointer_type sess_ptr,
+		irods::http::request_context_pointer request_ctx);
 
 } // namespace irods::s3::actions
 
@@ -3,6 +3,8 @@
 
 /// \file
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -48,6 +50,22 @@ int user_mapping_irods_username(const char* _s3_access_key_id, char** _irods_use
 /// \since 0.5.0
 int user_mapping_s3_secret_key(const char* _s3_access_key_id, char** _s3_secret_key);
 
+/// Get a value which identifies the current state of the mappings.
+///
+/// The value must change whenever the mappings change (e.g. the plugin reloads its
+/// configuration). The server uses it to invalidate information derived from the mappings,
+/// such as cached signing keys. This function is optional. If a plugin does not provide it,
+/// the server does not cache such information.
+///
+/// \param[out] _generation The value identifying the current state of the mappings.
+///
+/// \returns An integer indicating the status of the operation.
+/// \retval 0        On success.
+/// \retval non-zero On error.
+///
+/// \since 0.6.0
+int user_mapping_generation(uint64_t* _generation);
+
 /// Executes clean-up for the plugin.
 ///
 /// \returns An integer indicating the status of the operation.
@@ -6,6 +6,8 @@
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
+#include <atomic>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <exception>
@@ -30,6 +32,9 @@ namespace
 	// Ensures only one thread is allowed to reload the mappings.
 	std::shared_mutex g_mutex;
 
+	// Incremented every time the mappings are loaded.
+	std::atomic<std::uint64_t> g_generation{0};
+
 	//
 	// Helper Functions
 	//
@@ -102,6 +107,7 @@ namespace
 
 		g_mappings = std::move(mappings);
 		last_file_path_write = new_mtime;
+		g_generation.fetch_add(1);
 	} // load_user_mapping
 
 	auto reload_configuration_if_modified() -> void
@@ -228,6 +234,20 @@ auto user_mapping_s3_secret_key(const char* _s3_access_key_id, char** _s3_secret
 	}
 } // user_mapping_s3_secret_key
 
+auto user_mapping_generation(std::uint64_t* _generation) -> int
+{
+	if (!_generation) {
+		spdlog::error("{}: Received null pointer.", __func__);
+		return 1;
+	}
+
+	reload_configuration_if_modified();
+
+	*_generation = g_generation.load();
+
+	return 0;
+} // user_mapping_generation
+
 auto user_mapping_close() -> int
 {
 	return 0;
@@ -1,5 +1,6 @@
 from minio import Minio
 import boto3
+import botocore.exceptions
 import inspect
 import os
 import unittest
@@ -231,3 +232,38 @@ class GetObject_Test(unittest.TestCase):
             os.remove(put_filename)
             os.remove(get_filename)
             command.assert_command(f'irm -rf {self.bucket_irods_path}/{put_directory}')
+
+    def test_get_with_range_starting_past_the_end_of_the_object_fails(self):
+
+        put_filename = inspect.currentframe().f_code.co_name
+
+        try:
+            utility.make_arbitrary_file(put_filename, 50)
+            command.assert_command(f'iput {put_filename} {self.bucket_irods_path}/{put_filename}')
+
+            with self.assertRaises(botocore.exceptions.ClientError) as context:
+                self.boto3_client.get_object(Bucket=self.bucket_name, Key=put_filename, Range='bytes=100-')
+            self.assertEqual(context.exception.response['Error']['Code'], 'InvalidRange')
+
+            # The end of a range is clamped to the end of the object.
+            response = self.boto3_client.get_object(Bucket=self.bucket_name, Key=put_filename, Range='bytes=10-100')
+            self.assertEqual(len(response['Body'].read()), 40)
+
+        finally:
+            os.remove(put_filename)
+            command.assert_command(f'irm -f {self.bucket_irods_path}/{put_filename}')
+
+    def test_get_empty_object(self):
+
+        put_filename = inspect.currentframe().f_code.co_name
+
+        try:
+            utility.make_arbitrary_file(put_filename, 0)
+            command.assert_command(f'iput {put_filename} {self.bucket_irods_path}/{put_filename}')
+
+            response = self.boto3_client.get_object(Bucket=self.bucket_name, Key=put_filename)
+            self.assertEqual(response['Body'].read(), b'')
+
+        finally:
+            os.remove(put_filename)
+            command.assert_command(f'irm -f {self.bucket_irods_path}/{put_filename}')
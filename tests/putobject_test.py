@@ -1,7 +1,15 @@
+import base64
 import boto3
+import botocore.auth
+import botocore.awsrequest
+import botocore.credentials
+import botocore.exceptions
 import inspect
 import os
 import unittest
+import urllib.error
+import urllib.request
+import zlib
 
 from host_port import s3_api_host_port, irods_host
 from libs import command, utility
@@ -29,6 +37,25 @@ class PutObject_Test(unittest.TestCase):
     def tearDown(self):
         self.boto3_client.close()
 
+    def send_aws_chunked_request(self, key, body, headers, query=''):
+        """
+        Signs a PUT request with the headers given, including X-Amz-Content-SHA256, and sends the
+        aws-chunked body as is. Returns the HTTP status code of the response.
+        """
+
+        url = f'{self.s3_api_url}/{self.bucket_name}/{key}{query}'
+        request = botocore.awsrequest.AWSRequest(method='PUT', url=url, data=body, headers=headers)
+        credentials = botocore.credentials.Credentials(self.key, self.secret_key)
+        botocore.auth.SigV4Auth(credentials, 's3', 'us-east-1').add_auth(request)
+
+        prepared = request.prepare()
+        try:
+            with urllib.request.urlopen(urllib.request.Request(
+                    prepared.url, data=body, headers=dict(prepared.headers), method='PUT')) as response:
+                return response.status
+        except urllib.error.HTTPError as e:
+            return e.code
+
     def test_botocore_put_in_bucket_root_small_file(self):
 
         put_filename = inspect.currentframe().f_code.co_name 
@@ -324,3 +351,190 @@ class PutObject_Test(unittest.TestCase):
 
         finally:
             command.assert_command(f'irm -f {self.bucket_irods_path}/{put_filename}')
+
+    def test_put_with_bad_chunk_signature_keeps_existing_object(self):
+        put_filename = inspect.currentframe().f_code.co_name
+        original_contents = b'original contents'
+        payload = b'x' * 1024
+        bad_signature = '0' * 64
+
+        try:
+            self.boto3_client.put_object(Bucket=self.bucket_name, Key=put_filename, Body=original_contents)
+
+            body = (f'{len(payload):x};chunk-signature={bad_signature}\r\n'.encode() + payload + b'\r\n' +
+                    f'0;chunk-signature={bad_signature}\r\n\r\n'.encode())
+            status = self.send_aws_chunked_request(put_filename, body, {
+                'Content-Encoding': 'aws-chunked',
+                'X-Amz-Content-SHA256': 'STREAMING-AWS4-HMAC-SHA256-PAYLOAD',
+                'X-Amz-Decoded-Content-Length': str(len(payload))})
+            self.assertEqual(status, 403)
+
+            # The object written before must not have been truncated or replaced.
+            response = self.boto3_client.get_object(Bucket=self.bucket_name, Key=put_filename)
+            self.assertEqual(response['Body'].read(), original_contents)
+
+        finally:
+            command.assert_command(f'irm -f {self.bucket_irods_path}/{put_filename}')
+
+    def test_put_with_bad_trailer_checksum_keeps_existing_object(self):
+        put_filename = inspect.currentframe().f_code.co_name
+        original_contents = b'original contents'
+        payload = b'x' * 1024
+
+        try:
+            self.boto3_client.put_object(Bucket=self.bucket_name, Key=put_filename, Body=original_contents)
+
+            # The CRC-32 of the payload is not 0.
+            body = (f'{len(payload):x}\r\n'.encode() + payload + b'\r\n' +
+                    b'0\r\nx-amz-checksum-crc32:AAAAAA==\r\n\r\n')
+            status = self.send_aws_chunked_request(put_filename, body, {
+                'Content-Encoding': 'aws-chunked',
+                'X-Amz-Content-SHA256': 'STREAMING-UNSIGNED-PAYLOAD-TRAILER',
+                'X-Amz-Trailer': 'x-amz-checksum-crc32',
+                'X-Amz-Decoded-Content-Length': str(len(payload))})
+            self.assertEqual(status, 400)
+
+            # The object written before must not have been truncated or replaced.
+            response = self.boto3_client.get_object(Bucket=self.bucket_name, Key=put_filename)
+            self.assertEqual(response['Body'].read(), original_contents)
+
+        finally:
+            command.assert_command(f'irm -f {self.bucket_irods_path}/{put_filename}')
+
+    def test_chunked_put_replaces_existing_object_and_hides_staging_collection(self):
+        put_filename = inspect.currentframe().f_code.co_name
+        payload = b'x' * 1024
+        checksum = base64.b64encode(zlib.crc32(payload).to_bytes(4, 'big')).decode()
+
+        try:
+            self.boto3_client.put_object(Bucket=self.bucket_name, Key=put_filename, Body=b'original contents')
+
+            body = (f'{len(payload):x}\r\n'.encode() + payload + b'\r\n' +
+                    f'0\r\nx-amz-checksum-crc32:{checksum}\r\n\r\n'.encode())
+            status = self.send_aws_chunked_request(put_filename, body, {
+                'Content-Encoding': 'aws-chunked',
+                'X-Amz-Content-SHA256': 'STREAMING-UNSIGNED-PAYLOAD-TRAILER',
+                'X-Amz-Trailer': 'x-amz-checksum-crc32',
+                'X-Amz-Decoded-Content-Length': str(len(payload))})
+            self.assertEqual(status, 200)
+
+            response = self.boto3_client.get_object(Bucket=self.bucket_name, Key=put_filename)
+            self.assertEqual(response['Body'].read(), payload)
+
+            # The temporary data object is not written next to the key, and the staging collection
+            # is not listed.
+            for kwargs in [{}, {'Delimiter': '/'}]:
+                result = self.boto3_client.list_objects_v2(Bucket=self.bucket_name, **kwargs)
+                keys = [o['Key'] for o in result.get('Contents', [])]
+                prefixes = [p['Prefix'] for p in result.get('CommonPrefixes', [])]
+                self.assertIn(put_filename, keys)
+                for name in keys + prefixes:
+                    self.assertNotIn('.irods_s3_api_staging', name)
+
+        finally:
+            command.assert_command(f'irm -f {self.bucket_irods_path}/{put_filename}')
+
+    def test_upload_part_with_bad_chunk_signature_can_be_uploaded_again(self):
+        put_filename = inspect.currentframe().f_code.co_name
+        get_filename = f'{put_filename}.get'
+        part_1 = b'1' * 1024
+        part_2 = b'2' * 1024
+        bad_signature = '0' * 64
+        upload_id = None
+
+        try:
+            upload_id = self.boto3_client.create_multipart_upload(Bucket=self.bucket_name, Key=put_filename)['UploadId']
+
+            # The rejected part is the first one written to iRODS, i.e. the one opening the data
+            # object shared by the parts of the upload.
+            body = (f'{len(part_1):x};chunk-signature={bad_signature}\r\n'.encode() + part_1 + b'\r\n' +
+                    f'0;chunk-signature={bad_signature}\r\n\r\n'.encode())
+            status = self.send_aws_chunked_request(put_filename, body, {
+                'Content-Encoding': 'aws-chunked',
+                'X-Amz-Content-SHA256': 'STREAMING-AWS4-HMAC-SHA256-PAYLOAD',
+                'X-Amz-Decoded-Content-Length': str(len(part_1))},
+                query=f'?partNumber=1&uploadId={upload_id}')
+            self.assertEqual(status, 403)
+
+            parts = []
+            for part_number, contents in [(1, part_1), (2, part_2)]:
+                response = self.boto3_client.upload_part(
+                    Bucket=self.bucket_name, Key=put_filename, PartNumber=part_number, UploadId=upload_id, Body=contents)
+                parts.append({'PartNumber': part_number, 'ETag': response['ETag']})
+
+            self.boto3_client.complete_multipart_upload(
+                Bucket=self.bucket_name, Key=put_filename, UploadId=upload_id, MultipartUpload={'Parts': parts})
+            upload_id = None
+
+            command.assert_command(f'iget {self.bucket_irods_path}/{put_filename} {get_filename}')
+            with open(get_filename, 'rb') as f:
+                self.assertEqual(f.read(), part_1 + part_2)
+
+        finally:
+            if upload_id is not None:
+                self.boto3_client.abort_multipart_upload(Bucket=self.bucket_name, Key=put_filename, UploadId=upload_id)
+            if os.path.exists(get_filename):
+                os.remove(get_filename)
+            command.assert_command(f'irm -f {self.bucket_irods_path}/{put_filename}')
+
+    def test_complete_multipart_upload_rejects_parts_with_wrong_etag(self):
+        put_filename = inspect.currentframe().f_code.co_name
+        upload_id = None
+
+        try:
+            upload_id = self.boto3_client.create_multipart_upload(Bucket=self.bucket_name, Key=put_filename)['UploadId']
+            self.boto3_client.upload_part(
+                Bucket=self.bucket_name, Key=put_filename, PartNumber=1, UploadId=upload_id, Body=b'1' * 1024)
+
+            # The ETag of the object must be derived from the parts received, not from the ETags
+            # sent by the client.
+            with self.assertRaises(botocore.exceptions.ClientError) as context:
+                self.boto3_client.complete_multipart_upload(
+                    Bucket=self.bucket_name,
+                    Key=put_filename,
+                    UploadId=upload_id,
+                    MultipartUpload={'Parts': [{'PartNumber': 1, 'ETag': '"' + '0' * 32 + '"'}]})
+            self.assertEqual(context.exception.response['Error']['Code'], 'InvalidPart')
+
+            # Part 2 was never uploaded.
+            with self.assertRaises(botocore.exceptions.ClientError) as context:
+                self.boto3_client.complete_multipart_upload(
+                    Bucket=self.bucket_name,
+                    Key=put_filename,
+                    UploadId=upload_id,
+                    MultipartUpload={'Parts': [{'PartNumber': 1, 'ETag': '"' + '0' * 32 + '"'},
+                                               {'PartNumber': 2, 'ETag': '"' + '0' * 32 + '"'}]})
+            self.assertEqual(context.exception.response['Error']['Code'], 'InvalidPart')
+
+        finally:
+            if upload_id is not None:
+                self.boto3_client.abort_multipart_upload(Bucket=self.bucket_name, Key=put_filename, UploadId=upload_id)
+            command.assert_command(f'irm -f {self.bucket_irods_path}/{put_filename}')
+
+    def test_upload_part_rejects_part_numbers_out_of_range(self):
+        put_filename = inspect.currentframe().f_code.co_name
+        upload_id = None
+
+        try:
+            upload_id = self.boto3_client.create_multipart_upload(Bucket=self.bucket_name, Key=put_filename)['UploadId']
+
+            # S3 allows part numbers from 1 to 10000.
+            for part_number in [0, 10001, 2**31]:
+                with self.assertRaises(botocore.exceptions.ClientError) as context:
+                    self.boto3_client.upload_part(
+                        Bucket=self.bucket_name,
+                        Key=put_filename,
+                        PartNumber=part_number,
+                        UploadId=upload_id,
+                        Body=b'1' * 1024)
+                self.assertEqual(context.exception.response['Error']['Code'], 'InvalidArgument')
+
+            # The upload is not affected by the rejected parts.
+            response = self.boto3_client.upload_part(
+                Bucket=self.bucket_name, Key=put_filename, PartNumber=10000, UploadId=upload_id, Body=b'1' * 1024)
+            self.assertEqual(response['ResponseMetadata']['HTTPStatusCode'], 200)
+
+        finally:
+            if upload_id is not None:
+                self.boto3_client.abort_multipart_upload(Bucket=self.bucket_name, Key=put_filename, UploadId=upload_id)
+            command.assert_command(f'irm -f {self.bucket_irods_path}/{put_filename}')
@@ -0,0 +1,184 @@
+#include <catch2/catch.hpp>
+
+#include "irods/private/s3_api/aws_chunked_decoder.hpp"
+#include "irods/private/s3_api/hmac.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace
+{
+	using irods::s3::aws_chunked_decoder;
+
+	// The example from the "Signature Calculations for the Authorization Header: Transferring
+	// Payload in Multiple Chunks" section of the AWS Signature Version 4 documentation.
+	constexpr std::string_view seed_signature = "4f232c4386841ef735655705268965c44a0e4690baa4adea153f7db9fa80a0a9";
+
+	auto make_signing_context() -> irods::s3::chunk_signing_context
+	{
+		using irods::s3::authentication::hmac_sha_256;
+
+		const auto date_key = hmac_sha_256("AWS4wJalrXUtnFEMI/K7MDENG/bPxRfiCYEXAMPLEKEY", "20130524");
+		const auto date_region_key = hmac_sha_256(date_key, "us-east-1");
+		const auto date_region_service_key = hmac_sha_256(date_region_key, "s3");
+
+		return {
+			hmac_sha_256(date_region_service_key, "aws4_request"),
+			"20130524T000000Z",
+			"20130524/us-east-1/s3/aws4_request",
+			std::string{seed_signature}};
+	} // make_signing_context
+
+	auto make_example_body(std::string_view _first_signature = "ad80c730a21e5b8d04586a2213dd63b9a0e99e0e2307b0ade35a65485a288648")
+		-> std::string
+	{
+		std::string body;
+		body.append("10000;chunk-signature=").append(_first_signature).append("\r\n");
+		body.append(65536, 'a').append("\r\n");
+		body.append("400;chunk-signature=0055627c9e194cb4542bae2aa5492e3c1575bbb81b612b7d234b86a503ef5497\r\n");
+		body.append(1024, 'a').append("\r\n");
+		body.append("0;chunk-signature=b6c6ea8a5354eaf15b3cb7646744f4275b71ea724fed81ceb9323e279d449df9\r\n\r\n");
+		return body;
+	} // make_example_body
+
+	// Feeds the body to the decoder in pieces of the given size and returns the payload.
+	auto decode_in_pieces(aws_chunked_decoder& _decoder, std::string_view _body, std::size_t _piece_size) -> std::string
+	{
+		std::string payload;
+
+		while (!_body.empty() && !_decoder.done() && !_decoder.failed()) {
+			const auto piece = _body.substr(0, _piece_size);
+			const auto consumed = _decoder.decode(piece, [&payload](std::string_view _sv) { payload.append(_sv); });
+			_body.remove_prefix(consumed);
+		}
+
+		return payload;
+	} // decode_in_pieces
+} // anonymous namespace
+
+TEST_CASE("aws_chunked_decoder verifies the chain of chunk signatures")
+{
+	const auto body = make_example_body();
+
+	// Splitting the body at every possible boundary must not change the result.
+	for (const std::size_t piece_size : {std::size_t{1}, std::size_t{7}, std::size_t{4096}, body.size()}) {
+		CAPTURE(piece_size);
+
+		aws_chunked_decoder decoder{make_signing_context()};
+		const auto payload = decode_in_pieces(decoder, body, piece_size);
+
+		CHECK(decoder.done());
+		CHECK(decoder.error() == aws_chunked_decoder::error_code::none);
+		CHECK(decoder.payload_size() == 66560);
+		CHECK(payload == std::string(66560, 'a'));
+	}
+}
+
+TEST_CASE("aws_chunked_decoder rejects an incorrect chunk signature")
+{
+	const auto body = make_example_body("0000000000000000000000000000000000000000000000000000000000000000");
+
+	aws_chunked_decoder decoder{make_signing_context()};
+	decode_in_pieces(decoder, body, body.size());
+
+	CHECK(decoder.failed());
+	CHECK(decoder.error() == aws_chunked_decoder::error_code::signature_mismatch);
+
+	// Without a signing context, the signatures are ignored.
+	aws_chunked_decoder unverified_decoder;
+	CHECK(decode_in_pieces(unverified_decoder, body, body.size()) == std::string(66560, 'a'));
+	CHECK(unverified_decoder.done());
+}
+
+TEST_CASE("aws_chunked_decoder rejects malformed bodies")
+{
+	using error_code = aws_chunked_decoder::error_code;
+
+	const auto check = [](std::string_view _body, error_code _expected) {
+		CAPTURE(_body);
+		aws_chunked_decoder decoder;
+		decode_in_pieces(decoder, _body, _body.size());
+		CHECK(decoder.failed());
+		CHECK(decoder.error() == _expected);
+	};
+
+	check("xyz\r\n", error_code::malformed_chunk_header);
+	check(";chunk-signature=abc\r\n", error_code::malformed_chunk_header);
+	check("3\n", error_code::malformed_chunk_header);
+	check("3\r\nabcX", error_code::malformed_chunk_terminator);
+	check("0\r\nX\r\n\r\n", error_code::malformed_trailer);
+	check("0\r\n\rX", error_code::malformed_trailer);
+	check("11111111111111111\r\n", error_code::chunk_size_too_large);
+	check("1;" + std::string(aws_chunked_decoder::max_chunk_header_size, 'x'), error_code::chunk_header_too_long);
+
+	// A chunk signature is required when signatures are verified.
+	aws_chunked_decoder decoder{make_signing_context()};
+	decode_in_pieces(decoder, "3\r\nabc\r\n", 64);
+	CHECK(decoder.error() == error_code::missing_chunk_signature);
+}
+
+TEST_CASE("aws_chunked_decoder collects trailing headers")
+{
+	// The form used for STREAMING-UNSIGNED-PAYLOAD-TRAILER.
+	const std::string_view body = "3\r\nabc\r\n0\r\nX-Amz-Checksum-CRC32: NSRBwg==\r\n\r\n";
+
+	for (const std::size_t piece_size : {std::size_t{1}, body.size()}) {
+		aws_chunked_decoder decoder;
+		CHECK(decode_in_pieces(decoder, body, piece_size) == "abc");
+		CHECK(decoder.done());
+		CHECK(decoder.trailer("x-amz-checksum-crc32") == "NSRBwg==");
+		CHECK_FALSE(decoder.trailer("x-amz-checksum-crc32c").has_value());
+	}
+
+	// Signed trailing headers require a signature when signatures are verified.
+	aws_chunked_decoder decoder{make_signing_context()};
+	auto signed_body = make_example_body();
+	signed_body.resize(signed_body.size() - 2);
+	signed_body.append("x-amz-checksum-crc32:NSRBwg==\r\n\r\n");
+	decode_in_pieces(decoder, signed_body, signed_body.size());
+	CHECK(decoder.error() == aws_chunked_decoder::error_code::missing_trailer_signature);
+}
+
+TEST_CASE("aws_chunked_decoder stops at the end of the body")
+{
+	aws_chunked_decoder decoder;
+	std::string payload;
+
+	const std::string_view body = "3;ext=1\r\nabc\r\n0\r\n\r\ntrailing";
+	const auto consumed = decoder.decode(body, [&payload](std::string_view _sv) { payload.append(_sv); });
+
+	CHECK(decoder.done());
+	CHECK(payload == "abc");
+	CHECK(body.substr(consumed) == "trailing");
+}
+
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+// Run with: irods_s3_api-unit_tests "[!benchmark]"
+TEST_CASE("aws_chunked_decoder benchmark", "[!benchmark]")
+{
+	// 8 MiB of payload in 64 KiB chunks, read from the socket in 1 MiB pieces.
+	constexpr std::size_t chunk_size = 64 * 1024;
+	constexpr std::size_t chunk_count = 128;
+
+	std::string body;
+	for (std::size_t i = 0; i < chunk_count; ++i) {
+		body.append("10000;chunk-signature=0000000000000000000000000000000000000000000000000000000000000000\r\n");
+		body.append(chunk_size, 'x').append("\r\n");
+	}
+	body.append("0;chunk-signature=0000000000000000000000000000000000000000000000000000000000000000\r\n\r\n");
+
+	BENCHMARK("decode 8 MiB without verification")
+	{
+		aws_chunked_decoder decoder;
+		std::size_t payload_size = 0;
+		std::string_view input = body;
+		while (!input.empty() && !decoder.done()) {
+			const auto consumed = decoder.decode(
+				input.substr(0, 1024 * 1024), [&payload_size](std::string_view _sv) { payload_size += _sv.size(); });
+			input.remove_prefix(consumed);
+		}
+		return payload_size;
+	};
+}
+#endif // CATCH_CONFIG_ENABLE_BENCHMARKING
@@ -0,0 +1,116 @@
+#include <catch2/catch.hpp>
+
+#include "irods/private/s3_api/buffer_pool.hpp"
+
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using irods::http::buffer_pool;
+
+TEST_CASE("buffer_pool reuses released buffers of the same size class")
+{
+	buffer_pool pool{{.max_idle_bytes = 1024 * 1024}};
+
+	const char* first_data = nullptr;
+	{
+		auto buffer = pool.acquire(5000);
+		CHECK(buffer.size() == 5000);
+		first_data = buffer.data();
+	}
+
+	// 5000 and 8192 bytes are both served from the 8 KiB size class.
+	auto buffer = pool.acquire(8192);
+	CHECK(buffer.data() == first_data);
+
+	const auto metrics = pool.to_json();
+	CHECK(metrics.at("hits") == 1);
+	CHECK(metrics.at("misses") == 1);
+	CHECK(metrics.at("in_use_buffers") == 1);
+	CHECK(metrics.at("in_use_bytes") == 8192);
+	CHECK(metrics.at("idle_bytes") == 0);
+}
+
+TEST_CASE("buffer_pool reuses buffers released by other threads")
+{
+	buffer_pool pool{{.max_idle_bytes = 1024 * 1024}};
+
+	const char* released_data = nullptr;
+	std::thread{[&pool, &released_data] {
+		auto buffer = pool.acquire(4096);
+		released_data = buffer.data();
+	}}.join();
+
+	// The buffer may be in the shard of another thread.
+	auto buffer = pool.acquire(4096);
+	CHECK(buffer.data() == released_data);
+
+	const auto metrics = pool.to_json();
+	CHECK(metrics.at("hits") == 1);
+	CHECK(metrics.at("misses") == 1);
+	CHECK(metrics.at("idle_bytes") == 0);
+}
+
+TEST_CASE("buffer_pool frees buffers once the pool is full")
+{
+	buffer_pool pool{{.max_idle_bytes = 64 * 1024}};
+
+	{
+		auto a = pool.acquire(64 * 1024);
+		auto b = pool.acquire(64 * 1024);
+	}
+
+	auto metrics = pool.to_json();
+	CHECK(metrics.at("idle_bytes") == 64 * 1024);
+	CHECK(metrics.at("discarded_buffers") == 1);
+	CHECK(metrics.at("idle_buffers_by_size").at("65536") == 1);
+
+	// Requests larger than the largest size class are never pooled.
+	{
+		auto big = pool.acquire(buffer_pool::max_buffer_size + 1);
+		CHECK(big.size() == buffer_pool::max_buffer_size + 1);
+	}
+
+	metrics = pool.to_json();
+	CHECK(metrics.at("unpooled_allocations") == 1);
+	CHECK(metrics.at("in_use_buffers") == 0);
+	CHECK(metrics.at("in_use_bytes") == 0);
+}
+
+TEST_CASE("buffer_pool buffers return to the pool after being moved")
+{
+	buffer_pool pool{{.max_idle_bytes = 1024 * 1024}};
+
+	auto a = pool.acquire(4096);
+	auto b = std::move(a);
+	CHECK(a.data() == nullptr);
+	CHECK(b.size() == 4096);
+
+	b = pool.acquire(4096);
+	CHECK(pool.to_json().at("in_use_buffers") == 1);
+	CHECK(pool.to_json().at("idle_bytes") == 4096);
+}
+
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+// Run with: irods_s3_api-unit_tests "[!benchmark]"
+TEST_CASE("buffer_pool benchmark", "[!benchmark]")
+{
+	constexpr std::size_t buffer_size = 1024 * 1024;
+
+	buffer_pool pool{{.max_idle_bytes = 16 * buffer_size}};
+
+	BENCHMARK("acquire and release 1 MiB from the pool")
+	{
+		auto buffer = pool.acquire(buffer_size);
+		buffer.data()[0] = 'x';
+		return buffer.data()[0];
+	};
+
+	BENCHMARK("allocate 1 MiB std::vector")
+	{
+		std::vector<char> buffer(buffer_size);
+		return buffer[0];
+	};
+}
+#endif // CATCH_CONFIG_ENABLE_BENCHMARKING
@@ -0,0 +1,102 @@
+#include <catch2/catch.hpp>
+
+#include "irods/private/s3_api/checksum.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+TEST_CASE("crc32 and crc32c match the standard check values")
+{
+	constexpr std::string_view check_input = "123456789";
+
+	CHECK(irods::s3::crc32(0, check_input) == 0xcbf43926);
+	CHECK(irods::s3::crc32c(0, check_input) == 0xe3069283);
+
+	CHECK(irods::s3::crc32(0, "") == 0);
+	CHECK(irods::s3::crc32c(0, "") == 0);
+
+	// Computing the CRC in pieces of any size must not change the result.
+	const std::string large(100'003, 'z');
+	const auto expected_crc32 = irods::s3::crc32(0, large);
+	const auto expected_crc32c = irods::s3::crc32c(0, large);
+
+	for (const std::size_t piece_size : {std::size_t{1}, std::size_t{7}, std::size_t{4096}}) {
+		std::uint32_t crc32 = 0;
+		std::uint32_t crc32c = 0;
+		for (std::size_t offset = 0; offset < large.size(); offset += piece_size) {
+			crc32 = irods::s3::crc32(crc32, std::string_view{large}.substr(offset, piece_size));
+			crc32c = irods::s3::crc32c(crc32c, std::string_view{large}.substr(offset, piece_size));
+		}
+		CHECK(crc32 == expected_crc32);
+		CHECK(crc32c == expected_crc32c);
+	}
+}
+
+TEST_CASE("checksum_calculator produces base64 encoded checksums")
+{
+	using irods::s3::checksum_algorithm;
+
+	const auto checksum = [](checksum_algorithm _algorithm, std::string_view _data) {
+		irods::s3::checksum_calculator calculator{_algorithm};
+		calculator.update(_data);
+		return calculator.finalize();
+	};
+
+	CHECK(checksum(checksum_algorithm::crc32, "abc") == "NSRBwg==");
+	CHECK(checksum(checksum_algorithm::crc32c, "abc") == "Nks/tw==");
+	CHECK(checksum(checksum_algorithm::sha256, "abc") == "ungWv48Bz+pBQUDeXa4iI7ADYaOWF3qctBD/YfIAFa0=");
+	CHECK(checksum(checksum_algorithm::crc32, "") == "AAAAAA==");
+}
+
+TEST_CASE("checksum_algorithm_from_header_name")
+{
+	using irods::s3::checksum_algorithm;
+	using irods::s3::checksum_algorithm_from_header_name;
+
+	CHECK(checksum_algorithm_from_header_name("x-amz-checksum-crc32") == checksum_algorithm::crc32);
+	CHECK(checksum_algorithm_from_header_name("X-Amz-Checksum-CRC32C") == checksum_algorithm::crc32c);
+	CHECK(checksum_algorithm_from_header_name("x-amz-checksum-sha256") == checksum_algorithm::sha256);
+	CHECK_FALSE(checksum_algorithm_from_header_name("x-amz-checksum-sha1").has_value());
+	CHECK_FALSE(checksum_algorithm_from_header_name("x-amz-checksum-crc").has_value());
+}
+
+TEST_CASE("ETags are derived from MD5 digests")
+{
+	const auto md5 = [](std::string_view _data) {
+		irods::s3::md5_calculator calculator;
+		calculator.update(_data);
+		return calculator.finalize();
+	};
+
+	CHECK(irods::s3::make_etag(md5("")) == "\"d41d8cd98f00b204e9800998ecf8427e\"");
+	CHECK(irods::s3::make_etag(md5("abc")) == "\"900150983cd24fb0d6963f7d28e17f72\"");
+
+	// The ETag of a multipart upload is the MD5 digest of the concatenated part digests.
+	const auto expected = "\"" + irods::s3::authentication::hex_encode(md5(md5("abc") + md5(""))) + "-2\"";
+	CHECK(
+		irods::s3::make_multipart_etag({"\"900150983cd24fb0d6963f7d28e17f72\"", "d41d8cd98f00b204e9800998ecf8427e"}) ==
+		expected);
+
+	CHECK_FALSE(irods::s3::make_multipart_etag({"\"not-an-md5\""}).has_value());
+	CHECK_FALSE(irods::s3::make_multipart_etag({"900150983cd24fb0d6963f7d28e17f7z"}).has_value());
+}
+
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+// Run with: irods_s3_api-unit_tests "[!benchmark]"
+// Each benchmark processes 8 MiB, so the throughput in MB/s is 8 divided by the mean time in seconds.
+TEST_CASE("checksum throughput benchmark", "[!benchmark]")
+{
+	const std::string payload(8 * 1024 * 1024, 'x');
+
+	BENCHMARK("crc32 8 MiB")
+	{
+		return irods::s3::crc32(0, payload);
+	};
+
+	BENCHMARK("crc32c 8 MiB")
+	{
+		return irods::s3::crc32c(0, payload);
+	};
+}
+#endif // CATCH_CONFIG_ENABLE_BENCHMARKING
@@ -0,0 +1,58 @@
+#include <catch2/catch.hpp>
+
+#include "irods/private/s3_api/collection_cache.hpp"
+
+#include <chrono>
+
+using irods::s3::collection_cache;
+
+TEST_CASE("collection cache remembers collections until they expire")
+{
+	collection_cache cache{64, std::chrono::seconds{60}};
+	REQUIRE(cache.enabled());
+
+	const auto now = collection_cache::clock_type::now();
+
+	CHECK_FALSE(cache.contains("tempZone", "/tempZone/home/alice/bucket/a", now));
+
+	cache.insert("tempZone", "/tempZone/home/alice/bucket/a/", now);
+	CHECK(cache.contains("tempZone", "/tempZone/home/alice/bucket/a", now));
+	CHECK_FALSE(cache.contains("otherZone", "/tempZone/home/alice/bucket/a", now));
+	CHECK_FALSE(cache.contains("tempZone", "/tempZone/home/alice/bucket", now));
+
+	CHECK_FALSE(cache.contains("tempZone", "/tempZone/home/alice/bucket/a", now + std::chrono::seconds{60}));
+
+	// The expired entry was removed by the previous lookup.
+	CHECK_FALSE(cache.contains("tempZone", "/tempZone/home/alice/bucket/a", now));
+
+	const auto metrics = cache.to_json();
+	CHECK(metrics.at("hits").get<int>() == 1);
+	CHECK(metrics.at("misses").get<int>() == 5);
+}
+
+TEST_CASE("collection cache forgets a deleted collection and everything below it")
+{
+	collection_cache cache{64, std::chrono::seconds{60}};
+	const auto now = collection_cache::clock_type::now();
+
+	cache.insert("tempZone", "/tempZone/home/alice/a", now);
+	cache.insert("tempZone", "/tempZone/home/alice/a/b", now);
+	cache.insert("tempZone", "/tempZone/home/alice/a/b/c", now);
+	cache.insert("tempZone", "/tempZone/home/alice/ab", now);
+
+	cache.erase("tempZone", "/tempZone/home/alice/a/");
+
+	CHECK_FALSE(cache.contains("tempZone", "/tempZone/home/alice/a", now));
+	CHECK_FALSE(cache.contains("tempZone", "/tempZone/home/alice/a/b", now));
+	CHECK_FALSE(cache.contains("tempZone", "/tempZone/home/alice/a/b/c", now));
+	CHECK(cache.contains("tempZone", "/tempZone/home/alice/ab", now));
+}
+
+TEST_CASE("collection cache with a capacity of zero is disabled")
+{
+	collection_cache cache{0, std::chrono::seconds{60}};
+	CHECK_FALSE(cache.enabled());
+
+	cache.insert("tempZone", "/tempZone/home/alice", collection_cache::clock_type::now());
+	CHECK_FALSE(cache.contains("tempZone", "/tempZone/home/alice"));
+}
@@ -0,0 +1,87 @@
+#include <catch2/catch.hpp>
+
+#include "irods/private/s3_api/hmac.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace
+{
+	using irods::s3::authentication::digest_backend;
+
+	constexpr digest_backend all_backends[] = {digest_backend::portable, digest_backend::openssl};
+} // anonymous namespace
+
+TEST_CASE("hex_encode")
+{
+	using irods::s3::authentication::hex_encode;
+
+	CHECK(hex_encode("").empty());
+	CHECK(hex_encode(std::string_view{"\x00\x0f\x10\x7f\x80\xff", 6}) == "000f107f80ff");
+}
+
+TEST_CASE("hash_sha_256 produces the same result for every backend")
+{
+	using irods::s3::authentication::hash_sha_256;
+	using irods::s3::authentication::hex_encode;
+	using irods::s3::authentication::sha_256_hasher;
+
+	const std::string large(1'000'000, 'a');
+	constexpr std::string_view large_hash = "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0";
+
+	for (const auto backend : all_backends) {
+		CAPTURE(irods::s3::authentication::to_string(backend));
+
+		CHECK(
+			hex_encode(hash_sha_256("", backend)) ==
+			"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+		CHECK(
+			hex_encode(hash_sha_256("abc", backend)) ==
+			"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+		CHECK(hex_encode(hash_sha_256(large, backend)) == large_hash);
+
+		// Feeding the data in pieces must not change the result.
+		sha_256_hasher hasher{backend};
+		for (std::size_t offset = 0; offset < large.size(); offset += 4099) {
+			hasher.update(std::string_view{large}.substr(offset, 4099));
+		}
+		CHECK(hex_encode(hasher.finalize()) == large_hash);
+	}
+}
+
+// Test case 2 from RFC 4231.
+TEST_CASE("hmac_sha_256 produces the same result for every backend")
+{
+	using irods::s3::authentication::hex_encode;
+	using irods::s3::authentication::hmac_sha_256;
+
+	for (const auto backend : all_backends) {
+		CAPTURE(irods::s3::authentication::to_string(backend));
+
+		CHECK(
+			hex_encode(hmac_sha_256("Jefe", "what do ya want for nothing?", backend)) ==
+			"5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+	}
+}
+
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+// Run with: irods_s3_api-unit_tests "[!benchmark]"
+// Each benchmark hashes 8 MiB, so the throughput in MB/s is 8 divided by the mean time in seconds.
+TEST_CASE("sha_256 throughput benchmark", "[!benchmark]")
+{
+	using irods::s3::authentication::hash_sha_256;
+
+	const std::string payload(8 * 1024 * 1024, 'x');
+
+	BENCHMARK("portable sha256 8 MiB")
+	{
+		return hash_sha_256(payload, digest_backend::portable);
+	};
+
+	BENCHMARK("openssl sha256 8 MiB")
+	{
+		return hash_sha_256(payload, digest_backend::openssl);
+	};
+}
+#endif // CATCH_CONFIG_ENABLE_BENCHMARKING
@@ -0,0 +1,180 @@
+#include <catch2/catch.hpp>
+
+#include "irods/private/s3_api/multipart_journal.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using irods::s3::multipart_journal;
+using irods::s3::multipart_journal_options;
+
+namespace
+{
+	// Returns a path for a journal which does not exist yet.
+	auto make_journal_path(const std::string& _name) -> std::string
+	{
+		auto path = std::filesystem::temp_directory_path() / ("irods_s3_api_test_" + _name + ".journal");
+		std::filesystem::remove(path);
+		return path.string();
+	} // make_journal_path
+} // anonymous namespace
+
+TEST_CASE("multipart_journal restores uploads after a restart")
+{
+	const auto path = make_journal_path("restore");
+
+	{
+		multipart_journal journal{{.path = path, .compaction_threshold_in_bytes = 1024 * 1024}};
+		CHECK(journal.take_restored_uploads().empty());
+
+		journal.record_part_size("upload-a", 100);
+		journal.record_part("upload-a", 1, 100);
+		journal.record_part("upload-a", 3, 40);
+		journal.record_part("upload-a", 2, 100);
+		journal.record_staged_part("upload-a", 2);
+
+		journal.record_part("upload-b", 1, 7);
+		journal.record_upload_ended("upload-b");
+	}
+
+	multipart_journal journal{{.path = path, .compaction_threshold_in_bytes = 1024 * 1024}};
+	auto uploads = journal.take_restored_uploads();
+
+	// Uploads which were completed or aborted are forgotten.
+	REQUIRE(uploads.size() == 1);
+
+	const auto& upload = uploads.at("upload-a");
+	CHECK(upload.part_size == 100);
+
+	// Part 2 was only held in memory, so it did not survive.
+	CHECK(upload.part_sizes == std::map<unsigned int, std::uint64_t>{{1, 100}, {3, 40}});
+
+	// The uploads are only handed out once.
+	CHECK(journal.take_restored_uploads().empty());
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("multipart_journal restores the uploads and parts listed by ListMultipartUploads and ListParts")
+{
+	const auto path = make_journal_path("listing");
+	const auto initiated = std::chrono::system_clock::time_point{std::chrono::milliseconds{1700000000123}};
+
+	{
+		multipart_journal journal{{.path = path, .compaction_threshold_in_bytes = 1024 * 1024}};
+
+		journal.record_upload_created(
+			{.bucket = "bucket", .key = "dir/key", .upload_id = "upload", .owner = "rods", .initiated = initiated});
+
+		journal.record_part("upload", 1, 5);
+		journal.record_part_uploaded("upload", 1, {.size = 5, .etag = "\"etag-1\"", .last_modified = initiated});
+
+		// Part 2 was received, but only held in memory.
+		journal.record_part("upload", 2, 6);
+		journal.record_staged_part("upload", 2);
+		journal.record_part_uploaded("upload", 2, {.size = 6, .etag = "\"etag-2\"", .last_modified = initiated});
+
+		// Part 3 was being uploaded when the server stopped.
+		journal.record_part("upload", 3, 7);
+	}
+
+	multipart_journal journal{{.path = path, .compaction_threshold_in_bytes = 1024 * 1024}};
+	const auto uploads = journal.take_restored_uploads();
+	const auto& upload = uploads.at("upload");
+
+	REQUIRE(upload.entry.has_value());
+	CHECK(upload.entry->bucket == "bucket");
+	CHECK(upload.entry->key == "dir/key");
+	CHECK(upload.entry->upload_id == "upload");
+	CHECK(upload.entry->owner == "rods");
+	CHECK(upload.entry->initiated == initiated);
+
+	REQUIRE(upload.uploaded_parts.size() == 1);
+	CHECK(upload.uploaded_parts.at(1).size == 5);
+	CHECK(upload.uploaded_parts.at(1).etag == "\"etag-1\"");
+	CHECK(upload.uploaded_parts.at(1).last_modified == initiated);
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("multipart_journal ignores a record cut short by a crash")
+{
+	const auto path = make_journal_path("torn");
+
+	std::uintmax_t size_after_first_record = 0;
+
+	{
+		multipart_journal journal{{.path = path, .compaction_threshold_in_bytes = 1024 * 1024}};
+		journal.record_part("upload", 1, 5);
+		size_after_first_record = journal.to_json().at("size_in_bytes").get<std::uintmax_t>();
+		journal.record_part("upload", 2, 6);
+	}
+
+	// Corrupt the payload of the second record.
+	{
+		std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+		file.seekp(static_cast<std::streamoff>(size_after_first_record + 10));
+		file.put('\xff');
+	}
+
+	{
+		multipart_journal journal{{.path = path, .compaction_threshold_in_bytes = 1024 * 1024}};
+		auto uploads = journal.take_restored_uploads();
+		CHECK(uploads.at("upload").part_sizes == std::map<unsigned int, std::uint64_t>{{1, 5}});
+
+		// Records appended after the corrupt one are replayed on the next restart.
+		journal.record_part("upload", 3, 7);
+	}
+
+	multipart_journal journal{{.path = path, .compaction_threshold_in_bytes = 1024 * 1024}};
+	CHECK(journal.take_restored_uploads().at("upload").part_sizes ==
+	      std::map<unsigned int, std::uint64_t>{{1, 5}, {3, 7}});
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("multipart_journal compacts the records of finished uploads")
+{
+	const auto path = make_journal_path("compact");
+
+	{
+		multipart_journal journal{{.path = path, .compaction_threshold_in_bytes = 4096}};
+
+		journal.record_upload_created(
+			{.bucket = "bucket", .key = "key", .upload_id = "live", .owner = "rods", .initiated = {}});
+		journal.record_part("live", 1, 11);
+		journal.record_part_uploaded("live", 1, {.size = 11, .etag = "\"etag\"", .last_modified = {}});
+
+		for (int i = 0; i < 1000; ++i) {
+			const auto upload_id = "finished-" + std::to_string(i);
+			journal.record_part(upload_id, 1, 1);
+			journal.record_upload_ended(upload_id);
+		}
+
+		const auto stats = journal.to_json();
+		CHECK(stats.at("compactions").get<int>() > 0);
+		CHECK(stats.at("size_in_bytes").get<std::size_t>() < 4096);
+		CHECK(stats.at("uploads").get<int>() == 1);
+	}
+
+	multipart_journal journal{{.path = path, .compaction_threshold_in_bytes = 4096}};
+	auto uploads = journal.take_restored_uploads();
+	REQUIRE(uploads.size() == 1);
+	CHECK(uploads.at("live").part_sizes == std::map<unsigned int, std::uint64_t>{{1, 11}});
+	CHECK(uploads.at("live").entry->key == "key");
+	CHECK(uploads.at("live").uploaded_parts.at(1).etag == "\"etag\"");
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE("multipart_journal does nothing when it has no path")
+{
+	multipart_journal journal{{}};
+	CHECK_FALSE(journal.enabled());
+
+	journal.record_part("upload", 1, 1);
+	CHECK(journal.to_json().at("uploads").get<int>() == 0);
+}
@@ -0,0 +1,103 @@
+#include <catch2/catch.hpp>
+
+#include "irods/private/s3_api/multipart_upload_index.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using irods::s3::multipart_upload_entry;
+using irods::s3::multipart_upload_index;
+using irods::s3::multipart_upload_listing;
+
+namespace
+{
+	auto make_upload(std::string _bucket, std::string _key, std::string _upload_id, int _initiated)
+		-> multipart_upload_entry
+	{
+		return {
+			.bucket = std::move(_bucket),
+			.key = std::move(_key),
+			.upload_id = std::move(_upload_id),
+			.owner = "rods",
+			.initiated = std::chrono::system_clock::time_point{std::chrono::seconds{_initiated}}};
+	} // make_upload
+
+	auto upload_ids_of(const multipart_upload_listing& _listing) -> std::vector<std::string>
+	{
+		std::vector<std::string> upload_ids;
+		for (const auto& upload : _listing.uploads) {
+			upload_ids.push_back(upload.upload_id);
+		}
+		return upload_ids;
+	} // upload_ids_of
+} // anonymous namespace
+
+TEST_CASE("multipart_upload_index lists uploads by key and initiation time, one page at a time")
+{
+	multipart_upload_index index;
+
+	index.insert(make_upload("bucket", "b", "u3", 30));
+	index.insert(make_upload("bucket", "a", "u2", 20));
+	index.insert(make_upload("bucket", "b", "u1", 10));
+	index.insert(make_upload("bucket", "c", "u4", 40));
+	index.insert(make_upload("other", "a", "u5", 50));
+
+	// Inserting an upload a second time does nothing.
+	index.insert(make_upload("bucket", "z", "u1", 60));
+
+	auto page = index.list({.bucket = "bucket", .max_uploads = 2});
+	CHECK(upload_ids_of(page) == std::vector<std::string>{"u2", "u1"});
+	CHECK(page.is_truncated);
+	CHECK(page.next_key_marker == "b");
+	CHECK(page.next_upload_id_marker == "u1");
+
+	page = index.list(
+		{.bucket = "bucket",
+	     .key_marker = page.next_key_marker,
+	     .upload_id_marker = page.next_upload_id_marker,
+	     .max_uploads = 2});
+	CHECK(upload_ids_of(page) == std::vector<std::string>{"u3", "u4"});
+	CHECK_FALSE(page.is_truncated);
+
+	// Without an upload ID marker, the listing begins after every upload of the key marker.
+	page = index.list({.bucket = "bucket", .key_marker = "b"});
+	CHECK(upload_ids_of(page) == std::vector<std::string>{"u4"});
+
+	page = index.list({.bucket = "bucket", .prefix = "b"});
+	CHECK(upload_ids_of(page) == std::vector<std::string>{"u1", "u3"});
+
+	REQUIRE(index.find("u3").has_value());
+	CHECK(index.find("u3")->key == "b");
+
+	index.erase("u3");
+	CHECK_FALSE(index.find("u3").has_value());
+	CHECK(upload_ids_of(index.list({.bucket = "bucket", .prefix = "b"})) == std::vector<std::string>{"u1"});
+}
+
+TEST_CASE("multipart_upload_index rolls keys up into common prefixes")
+{
+	multipart_upload_index index;
+
+	index.insert(make_upload("bucket", "dir/a", "u1", 1));
+	index.insert(make_upload("bucket", "dir/sub/b", "u2", 2));
+	index.insert(make_upload("bucket", "dir/sub/c", "u3", 3));
+	index.insert(make_upload("bucket", "dir/sub2/d", "u4", 4));
+	index.insert(make_upload("bucket", "top", "u5", 5));
+
+	auto page = index.list({.bucket = "bucket", .delimiter = "/"});
+	CHECK(page.common_prefixes == std::vector<std::string>{"dir/"});
+	CHECK(upload_ids_of(page) == std::vector<std::string>{"u5"});
+
+	page = index.list({.bucket = "bucket", .prefix = "dir/", .delimiter = "/", .max_uploads = 2});
+	CHECK(upload_ids_of(page) == std::vector<std::string>{"u1"});
+	CHECK(page.common_prefixes == std::vector<std::string>{"dir/sub/"});
+	CHECK(page.is_truncated);
+	CHECK(page.next_key_marker == "dir/sub/");
+
+	// A page ending with a common prefix resumes after the keys rolled up into it.
+	page = index.list({.bucket = "bucket", .prefix = "dir/", .delimiter = "/", .key_marker = page.next_key_marker});
+	CHECK(page.uploads.empty());
+	CHECK(page.common_prefixes == std::vector<std::string>{"dir/sub2/"});
+	CHECK_FALSE(page.is_truncated);
+}
@@ -0,0 +1,87 @@
+#include <catch2/catch.hpp>
+
+#include "irods/private/s3_api/part_size_index.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using irods::s3::part_size_index;
+
+TEST_CASE("part_size_index computes offsets once the preceding parts are known")
+{
+	part_size_index index;
+
+	CHECK(index.empty());
+	CHECK(index.offset_of(1) == 0);
+	CHECK_FALSE(index.offset_of(0).has_value());
+
+	index.set(3, 30);
+	CHECK_FALSE(index.offset_of(3).has_value());
+	CHECK(index.get(3) == 30);
+	CHECK_FALSE(index.get(2).has_value());
+
+	index.set(1, 10);
+	CHECK(index.offset_of(2) == 10);
+	CHECK_FALSE(index.offset_of(3).has_value());
+
+	index.set(2, 20);
+	CHECK(index.offset_of(3) == 30);
+	CHECK(index.offset_of(4) == 60);
+	CHECK(index.size() == 3);
+
+	// Replacing a size moves the parts following it.
+	index.set(2, 5);
+	CHECK(index.offset_of(4) == 45);
+	CHECK(index.size() == 3);
+}
+
+TEST_CASE("part_size_index accepts the part numbers allowed by S3")
+{
+	CHECK(irods::s3::parse_part_number("1") == 1U);
+	CHECK(irods::s3::parse_part_number("10000") == irods::s3::max_part_number);
+
+	CHECK_FALSE(irods::s3::parse_part_number("0").has_value());
+	CHECK_FALSE(irods::s3::parse_part_number("10001").has_value());
+	CHECK_FALSE(irods::s3::parse_part_number("4294967296").has_value());
+	CHECK_FALSE(irods::s3::parse_part_number("-1").has_value());
+	CHECK_FALSE(irods::s3::parse_part_number("1a").has_value());
+	CHECK_FALSE(irods::s3::parse_part_number("").has_value());
+
+	// Part numbers S3 does not allow are not recorded.
+	part_size_index index;
+	index.set(irods::s3::max_part_number + 1, 10);
+	index.set(4294967295U, 10);
+	CHECK(index.empty());
+	CHECK_FALSE(index.get(irods::s3::max_part_number + 1).has_value());
+}
+
+TEST_CASE("part_size_index keeps its sums when it grows")
+{
+	part_size_index index;
+	std::vector<std::uint64_t> sizes(10001);
+
+	std::mt19937 gen{42};
+	std::uniform_int_distribution<std::uint64_t> dist{1, 1 << 20};
+
+	// Record the parts out of order, so that the index grows while it holds parts.
+	std::vector<unsigned int> order(sizes.size() - 1);
+	for (unsigned int i = 0; i < order.size(); ++i) {
+		order[i] = i + 1;
+	}
+	std::shuffle(order.begin(), order.end(), gen);
+
+	for (const auto part_number : order) {
+		sizes[part_number] = dist(gen);
+		index.set(part_number, sizes[part_number]);
+	}
+
+	std::uint64_t offset = 0;
+	for (unsigned int part_number = 1; part_number < sizes.size(); ++part_number) {
+		REQUIRE(index.offset_of(part_number) == offset);
+		offset += sizes[part_number];
+	}
+
+	CHECK(index.size() == 10000);
+}
@@ -0,0 +1,104 @@
+#include <catch2/catch.hpp>
+
+#include "irods/private/s3_api/part_staging_area.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using irods::s3::part_staging_area;
+
+TEST_CASE("part staging area bounds the memory held by staged parts")
+{
+	part_staging_area area{1024};
+	REQUIRE(area.enabled());
+
+	auto first = area.allocate(768);
+	REQUIRE(first);
+	CHECK(first->size() == 768);
+	std::memset(first->data(), 'a', first->size());
+
+	// There is no room for a second part of this size until the first one is released.
+	CHECK_FALSE(area.allocate(512));
+
+	auto second = area.allocate(256);
+	REQUIRE(second);
+
+	first.reset();
+	CHECK(area.allocate(512));
+
+	const auto metrics = area.to_json();
+	CHECK(metrics.at("rejected_parts").get<int>() == 1);
+	CHECK(metrics.at("used_bytes").get<int>() == 256);
+
+	CHECK_FALSE(part_staging_area{0}.allocate(1));
+}
+
+TEST_CASE("part staging area hands out each staged part once")
+{
+	const std::string upload_id = "01234567-89ab-cdef-0123-456789abcdef";
+	part_staging_area area{1024};
+
+	for (const unsigned int part_number : {3U, 2U}) {
+		auto part = area.allocate(4);
+		std::memcpy(part->data(), "part", 4);
+		area.insert(upload_id, part_number, std::move(part));
+	}
+
+	CHECK(area.part_numbers(upload_id) == std::vector<unsigned int>{2, 3});
+
+	auto part = area.take(upload_id, 2);
+	REQUIRE(part);
+	CHECK(std::string(part->data(), part->size()) == "part");
+	CHECK_FALSE(area.take(upload_id, 2));
+	CHECK(area.part_numbers(upload_id) == std::vector<unsigned int>{3});
+
+	// A part which could not be written is staged again.
+	area.restore(upload_id, 2, std::move(part));
+	CHECK(area.part_numbers(upload_id) == std::vector<unsigned int>{2, 3});
+
+	// The parts cannot be taken all at once while one of them is in flight.
+	part = area.take(upload_id, 3);
+	CHECK_FALSE(area.try_take_all(upload_id).has_value());
+	area.release(upload_id);
+
+	const auto parts = area.try_take_all(upload_id);
+	REQUIRE(parts.has_value());
+	REQUIRE(parts->size() == 1);
+	CHECK(parts->begin()->first == 2);
+	CHECK(area.part_numbers(upload_id).empty());
+	CHECK(area.to_json().at("uploads").get<int>() == 0);
+}
+
+TEST_CASE("part staging area signals when the parts of an upload are no longer in flight")
+{
+	const std::string upload_id = "01234567-89ab-cdef-0123-456789abcdef";
+	part_staging_area area{1024};
+
+	for (const unsigned int part_number : {1U, 2U}) {
+		area.insert(upload_id, part_number, area.allocate(4));
+	}
+
+	auto first = area.take(upload_id, 1);
+	auto second = area.take(upload_id, 2);
+
+	int signals = 0;
+	CHECK_FALSE(area.try_take_all(upload_id, [&signals] { ++signals; }).has_value());
+
+	// The callback waits for the last part in flight.
+	area.release(upload_id);
+	CHECK(signals == 0);
+	area.restore(upload_id, 2, std::move(second));
+	CHECK(signals == 1);
+
+	const auto parts = area.try_take_all(upload_id, [&signals] { ++signals; });
+	REQUIRE(parts.has_value());
+	CHECK(parts->size() == 1);
+
+	// Erasing an upload wakes up its waiters.
+	area.insert(upload_id, 3, area.allocate(4));
+	auto third = area.take(upload_id, 3);
+	CHECK_FALSE(area.try_take_all(upload_id, [&signals] { ++signals; }).has_value());
+	area.erase(upload_id);
+	CHECK(signals == 2);
+}
@@ -0,0 +1,86 @@
+#include <catch2/catch.hpp>
+
+#include "irods/private/s3_api/permit_pool.hpp"
+
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/use_awaitable.hpp>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+using irods::http::permit_pool;
+
+TEST_CASE("permit_pool hands out at most its number of permits")
+{
+	boost::asio::io_context ioc;
+	permit_pool pool{2};
+
+	std::vector<permit_pool::permit> permits;
+	int acquired = 0;
+
+	for (int i = 0; i < 3; ++i) {
+		boost::asio::co_spawn(
+			ioc,
+			[&]() -> boost::asio::awaitable<void> {
+				permits.push_back(co_await pool.async_acquire());
+				++acquired;
+			},
+			boost::asio::detached);
+	}
+
+	// A waiting coroutine keeps the io_context busy, so only the ready handlers are run.
+	ioc.poll();
+	ioc.restart();
+
+	// The third coroutine waits for a permit to be returned.
+	CHECK(acquired == 2);
+	CHECK(pool.to_json().at("waiting") == 1);
+
+	permits.erase(std::begin(permits));
+	ioc.poll();
+	ioc.restart();
+
+	CHECK(acquired == 3);
+
+	auto metrics = pool.to_json();
+	CHECK(metrics.at("available") == 0);
+	CHECK(metrics.at("waiting") == 0);
+	CHECK(metrics.at("acquired_total") == 3);
+	CHECK(metrics.at("waits_total") == 1);
+
+	permits.clear();
+	CHECK(pool.to_json().at("available") == 2);
+}
+
+TEST_CASE("permit_pool passes on the permit of a waiter which is destroyed")
+{
+	permit_pool pool{1};
+
+	{
+		boost::asio::io_context ioc;
+
+		auto held = std::make_unique<permit_pool::permit>();
+		boost::asio::co_spawn(
+			ioc,
+			[&]() -> boost::asio::awaitable<void> { *held = co_await pool.async_acquire(); },
+			boost::asio::detached);
+		boost::asio::co_spawn(
+			ioc,
+			[&]() -> boost::asio::awaitable<void> { auto p = co_await pool.async_acquire(); },
+			boost::asio::detached);
+
+		ioc.poll();
+		ioc.restart();
+		CHECK(pool.to_json().at("waiting") == 1);
+
+		// The waiter is granted the permit, but its coroutine is destroyed before it resumes.
+		held.reset();
+	}
+
+	auto metrics = pool.to_json();
+	CHECK(metrics.at("available") == 1);
+	CHECK(metrics.at("waiting") == 0);
+}
@@ -14,6 +14,7 @@
 
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <fstream>
 #include <string>
@@ -106,6 +107,7 @@ TEST_CASE("test local file user mapping plugin")
 	CHECK(lib.has("user_mapping_init"));
 	CHECK(lib.has("user_mapping_irods_username"));
 	CHECK(lib.has("user_mapping_s3_secret_key"));
+	CHECK(lib.has("user_mapping_generation"));
 	CHECK(lib.has("user_mapping_close"));
 	CHECK(lib.has("user_mapping_free"));
 
@@ -146,6 +148,10 @@ TEST_CASE("test local file user mapping plugin")
 	CHECK(um_s3_secret_key(alice_access_key_id.c_str(), &value) == 0);
 	CHECK(alice_secret_key == value);
 
+	const auto um_generation = lib.get<decltype(user_mapping_generation)>("user_mapping_generation");
+	std::uint64_t initial_generation{};
+	CHECK(um_generation(&initial_generation) == 0);
+
 	// Add a new user mapping to the configuration for bob and show that the plugin updates
 	// its state accordingly.
 
@@ -172,6 +178,11 @@ TEST_CASE("test local file user mapping plugin")
 	CHECK(um_s3_secret_key(bob_access_key_id.c_str(), &value) == 0);
 	CHECK(bob_secret_key == value);
 
+	// The generation changes whenever the mappings are reloaded.
+	std::uint64_t generation{};
+	CHECK(um_generation(&generation) == 0);
+	CHECK(generation != initial_generation);
+
 	// Remove alice from the user mapping and show that the plugin updates its state
 	// accordingly.
 
@@ -0,0 +1,75 @@
+#include <catch2/catch.hpp>
+
+#include "irods/private/s3_api/router.hpp"
+
+#include <string_view>
+
+namespace
+{
+	namespace http = boost::beast::http;
+
+	using irods::http::operation;
+
+	auto route_of(http::verb _method, std::string_view _target, bool _with_copy_source = false) -> operation
+	{
+		irods::http::request_type request{_method, _target, 11};
+		request.set(http::field::host, "localhost:9000");
+
+		if (_with_copy_source) {
+			request.set("x-amz-copy-source", "/bucket/source");
+		}
+
+		return irods::http::resolve_route(request).op;
+	} // route_of
+} // anonymous namespace
+
+TEST_CASE("router identifies GET operations")
+{
+	CHECK(route_of(http::verb::get, "/bucket?uploads") == operation::list_multipart_uploads);
+	CHECK(route_of(http::verb::get, "/bucket/key?uploadId=abc&max-parts=10") == operation::list_parts);
+	CHECK(route_of(http::verb::get, "/bucket/key?uploadId=abc") == operation::list_parts);
+	CHECK(route_of(http::verb::get, "/bucket/key?upload%49d=abc") == operation::list_parts);
+	CHECK(route_of(http::verb::get, "/bucket?list-type=2&prefix=a%2Fb") == operation::list_objects_v2);
+	CHECK(route_of(http::verb::get, "/bucket?encoding-type=url") == operation::list_objects_v2);
+	CHECK(route_of(http::verb::get, "/2020-05-31/distribution") == operation::list_distributions);
+	CHECK(route_of(http::verb::get, "/bucket?location") == operation::get_bucket_location);
+	CHECK(route_of(http::verb::get, "/bucket?object-lock") == operation::get_object_lock_configuration);
+	CHECK(route_of(http::verb::get, "/bucket/key?tagging") == operation::get_object_tagging);
+	CHECK(route_of(http::verb::get, "/bucket?versioning") == operation::get_bucket_versioning);
+	CHECK(route_of(http::verb::get, "/bucket/dir/key") == operation::get_object);
+	CHECK(route_of(http::verb::get, "/bucket/dir/key?X-Amz-Signature=abc") == operation::get_object);
+}
+
+TEST_CASE("router identifies PUT, DELETE, HEAD and POST operations")
+{
+	CHECK(route_of(http::verb::put, "/bucket/key", true) == operation::copy_object);
+	CHECK(route_of(http::verb::put, "/bucket/key") == operation::put_object);
+	CHECK(route_of(http::verb::put, "/bucket/key?partNumber=2&uploadId=abc") == operation::put_object);
+
+	CHECK(route_of(http::verb::delete_, "/") == operation::delete_bucket);
+	CHECK(route_of(http::verb::delete_, "/bucket/key?uploadId=abc") == operation::abort_multipart_upload);
+	CHECK(route_of(http::verb::delete_, "/bucket/key?upload%49d=abc") == operation::abort_multipart_upload);
+	CHECK(route_of(http::verb::delete_, "/bucket/key?tagging") == operation::delete_object_tagging);
+	CHECK(route_of(http::verb::delete_, "/bucket/key") == operation::delete_object);
+
+	CHECK(route_of(http::verb::head, "/bucket") == operation::head_bucket);
+	CHECK(route_of(http::verb::head, "/bucket/key") == operation::head_object);
+
+	CHECK(route_of(http::verb::post, "/bucket?delete") == operation::delete_objects);
+	CHECK(route_of(http::verb::post, "/bucket/key?uploadId=abc") == operation::complete_multipart_upload);
+	CHECK(route_of(http::verb::post, "/bucket/key?uploads") == operation::create_multipart_upload);
+
+	CHECK(route_of(http::verb::patch, "/bucket/key") == operation::unsupported);
+}
+
+TEST_CASE("router decodes the path exactly once")
+{
+	irods::http::request_type request{http::verb::get, "/bucket/dir%20a/b%2Bc?prefix=x", 11};
+	request.set(http::field::host, "localhost:9000");
+
+	const auto route = irods::http::resolve_route(request);
+	CHECK(route.op == operation::list_objects_v2);
+	CHECK(route.url.host() == "localhost");
+	CHECK(route.url.path() == "/bucket/dir a/b+c");
+	CHECK(route.url.segments().size() == 3);
+}
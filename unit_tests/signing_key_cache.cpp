@@ -0,0 +1,97 @@
+#include <catch2/catch.hpp>
+
+#include "irods/private/s3_api/signing_key_cache.hpp"
+
+#include <date/date.h>
+
+#include <chrono>
+#include <string>
+
+namespace
+{
+	using irods::s3::authentication::signing_key_cache;
+
+	// 2024-03-15 12:00:00 UTC
+	const auto noon = date::sys_days{date::year{2024} / 3 / 15} + std::chrono::hours{12};
+} // anonymous namespace
+
+TEST_CASE("signing key expiration is midnight UTC following the date")
+{
+	using irods::s3::authentication::signing_key_expiration;
+
+	CHECK(signing_key_expiration("20240315") == date::sys_days{date::year{2024} / 3 / 16});
+	CHECK(signing_key_expiration("20241231") == date::sys_days{date::year{2025} / 1 / 1});
+
+	CHECK_FALSE(signing_key_expiration("2024031").has_value());
+	CHECK_FALSE(signing_key_expiration("20240230").has_value());
+	CHECK_FALSE(signing_key_expiration("2024-3-1").has_value());
+	CHECK_FALSE(signing_key_expiration("abcdefgh").has_value());
+}
+
+TEST_CASE("signing key cache returns entries for the same credential scope and generation")
+{
+	signing_key_cache cache{64};
+	REQUIRE(cache.enabled());
+
+	CHECK_FALSE(cache.find("alice", "20240315", "us-east-1", 1, noon).has_value());
+
+	cache.insert("alice", "20240315", "us-east-1", 1, {"rods_alice", "key"}, noon);
+
+	const auto entry = cache.find("alice", "20240315", "us-east-1", 1, noon);
+	REQUIRE(entry.has_value());
+	CHECK(entry->irods_username == "rods_alice");
+	CHECK(entry->signing_key == "key");
+
+	CHECK_FALSE(cache.find("alice", "20240315", "us-west-2", 1, noon).has_value());
+	CHECK_FALSE(cache.find("bob", "20240315", "us-east-1", 1, noon).has_value());
+
+	const auto metrics = cache.to_json();
+	CHECK(metrics.at("hits").get<int>() == 1);
+	CHECK(metrics.at("misses").get<int>() == 3);
+}
+
+TEST_CASE("signing key cache drops entries when the generation changes or the date passes")
+{
+	signing_key_cache cache{64};
+
+	cache.insert("alice", "20240315", "us-east-1", 1, {"rods_alice", "key"}, noon);
+	CHECK_FALSE(cache.find("alice", "20240315", "us-east-1", 2, noon).has_value());
+
+	// The entry was removed by the previous lookup.
+	CHECK_FALSE(cache.find("alice", "20240315", "us-east-1", 1, noon).has_value());
+
+	cache.insert("alice", "20240315", "us-east-1", 1, {"rods_alice", "key"}, noon);
+	CHECK_FALSE(cache.find("alice", "20240315", "us-east-1", 1, noon + std::chrono::hours{12}).has_value());
+
+	// Keys for dates which have already passed are never cached.
+	cache.insert("alice", "20240314", "us-east-1", 1, {"rods_alice", "key"}, noon);
+	CHECK_FALSE(cache.find("alice", "20240314", "us-east-1", 1, noon).has_value());
+}
+
+TEST_CASE("signing key cache is bounded")
+{
+	signing_key_cache cache{16};
+
+	for (int i = 0; i < 1000; ++i) {
+		cache.insert(std::to_string(i), "20240315", "us-east-1", 1, {"user", "key"}, noon);
+	}
+
+	int found = 0;
+	for (int i = 0; i < 1000; ++i) {
+		if (cache.find(std::to_string(i), "20240315", "us-east-1", 1, noon)) {
+			++found;
+		}
+	}
+
+	CHECK(found > 0);
+	CHECK(found <= 16);
+}
+
+TEST_CASE("signing key cache with a capacity of zero is disabled")
+{
+	signing_key_cache cache{0};
+	CHECK_FALSE(cache.enabled());
+
+	cache.insert("alice", "20240315", "us-east-1", 1, {"rods_alice", "key"}, noon);
+	CHECK_FALSE(cache.find("alice", "20240315", "us-east-1", 1, noon).has_value());
+}
@@ -0,0 +1,42 @@
+#include <catch2/catch.hpp>
+
+#include "irods/private/s3_api/uniform_part_layout.hpp"
+
+using irods::s3::uniform_part_layout;
+
+TEST_CASE("uniform_part_layout predicts offsets of out-of-order parts")
+{
+	constexpr std::uint64_t part_size = 8 * 1024 * 1024;
+	uniform_part_layout layout{part_size};
+
+	CHECK(layout.record_part_size(3, part_size));
+	CHECK(layout.predict_offset(3) == 2 * part_size);
+	CHECK(layout.last_predicted_part() == 3);
+
+	// The last part may be shorter.
+	CHECK(layout.record_part_size(4, 1024));
+	CHECK(layout.predict_offset(4) == 3 * part_size);
+
+	CHECK(layout.record_part_size(1, part_size));
+	CHECK(layout.predict_offset(1) == 0);
+	CHECK(layout.last_predicted_part() == 4);
+
+	CHECK_FALSE(layout.predict_offset(0).has_value());
+}
+
+TEST_CASE("uniform_part_layout detects parts which contradict a prediction")
+{
+	uniform_part_layout layout{100};
+
+	CHECK(layout.predict_offset(5) == 400);
+
+	// Part 2 was assumed to be 100 bytes when part 5 was placed.
+	CHECK_FALSE(layout.record_part_size(2, 99));
+
+	// Part 7 follows every placed part, so it may differ, but the parts after it can no longer
+	// be placed.
+	CHECK(layout.record_part_size(7, 50));
+	CHECK(layout.predict_offset(7) == 600);
+	CHECK_FALSE(layout.predict_offset(8).has_value());
+	CHECK(layout.last_predicted_part() == 7);
+}